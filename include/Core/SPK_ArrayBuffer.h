@@ -67,11 +67,15 @@ namespace SPK
 		size_t particleSize;
 		size_t dataSize;
 
+		std::vector<T> gatheredData; // (since 1.06.00)
+
 		ArrayBuffer<T>(size_t nbParticles,size_t particleSize);
 		ArrayBuffer<T>(const ArrayBuffer<T>& buffer);
 		virtual ~ArrayBuffer<T>();
 
 		virtual void swap(size_t index0,size_t index1);
+		virtual void applyPermutation(const unsigned int* permutation,size_t begin,size_t end);
+		virtual void compact(const unsigned long long* aliveMask,size_t nbParticles);
 	};
 
 	/**
@@ -155,6 +159,40 @@ namespace SPK
 			std::swap(address0[i],address1[i]);
 	}
 
+	template<class T>
+	void ArrayBuffer<T>::applyPermutation(const unsigned int* permutation,size_t begin,size_t end)
+	{
+		if (begin >= end)
+			return;
+
+		gatheredData.resize((end - begin) * particleSize);
+		T* gatheredIt = &gatheredData[0];
+		for (size_t i = begin; i < end; ++i)
+		{
+			const T* address = data + permutation[i] * particleSize;
+			gatheredIt = std::copy(address,address + particleSize,gatheredIt);
+		}
+
+		std::copy(gatheredData.begin(),gatheredData.end(),data + begin * particleSize);
+	}
+
+	template<class T>
+	void ArrayBuffer<T>::compact(const unsigned long long* aliveMask,size_t nbParticles)
+	{
+		// The particles of the first words that are all alive are not moved
+		size_t src = 0;
+		while ((src + 64 <= nbParticles)&&(aliveMask[src >> 6] == ~0ULL))
+			src += 64;
+
+		for (size_t dst = src; src < nbParticles; ++src)
+			if (((aliveMask[src >> 6] >> (src & 63)) & 1) != 0)
+			{
+				if (src != dst)
+					std::copy(data + src * particleSize,data + (src + 1) * particleSize,data + dst * particleSize);
+				++dst;
+			}
+	}
+
 	template<class T>
 	ArrayBufferCreator<T>::ArrayBufferCreator(size_t particleSize) :
 		BufferCreator(),
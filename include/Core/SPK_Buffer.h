@@ -23,6 +23,8 @@
 #ifndef H_SPK_BUFFER
 #define H_SPK_BUFFER
 
+#include "Core/SPK_DEF.h"
+
 namespace SPK
 {
 	class Particle;
@@ -36,6 +38,8 @@ namespace SPK
 	* <br>
 	* Their use can be extended to anything to store data within a group.<br>
 	* Buffers can also be swapped as particles are swap within a group. This allows to have the ordering of data consistent with the ordering of particles.<br>
+	* Since 1.06.00, when the group reorders many particles at once (sorting, compaction of the dead particles),
+	* the data are reordered by a single call to applyPermutation(const unsigned int*,size_t,size_t) or compact(const unsigned long long*,size_t).<br>
 	* However, if the buffers are only used for temporary storage on a single frame (most of the renderers), it is not necessary to swap the data.<br>
 	* <br>
 	* A buffer also contains a flag which is an unsigned integer that can be used to check the validity of the buffer from frame to frame.<br>
@@ -45,7 +49,7 @@ namespace SPK
 	*
 	* @since 1.03.02
 	*/
-	class Buffer
+	class SPK_PREFIX Buffer
 	{
 	friend class BufferCreator;
 	friend class Group;
@@ -84,6 +88,49 @@ namespace SPK
 		* @param index1 : the index of the second particle to swap
 		*/
 		virtual void swap(size_t index0,size_t index1) = 0;
+
+		/**
+		* @brief Resets the data of a particle in this buffer
+		*
+		* This method is called by the Group when a Particle is born at the given index, if the data of this buffer is swapped with particles.<br>
+		* By default it does nothing.
+		*
+		* @param index : the index of the Particle which is born
+		* @since 1.06.00
+		*/
+		virtual void reset(size_t index);
+
+		/**
+		* @brief Reorders the data of a range of particles in this buffer
+		*
+		* The data at each index i of the range [begin,end) is replaced by the data at the index permutation[i], which is in the range as well.<br>
+		* This method is called by the Group when it reorders its particles at once, if the data of this buffer is swapped with particles.<br>
+		* <br>
+		* By default the cycles of the permutation are followed with swap(size_t,size_t).
+		* Children should override it to move their data with a single gather.
+		*
+		* @param permutation : the array giving the index of the data to move at each index
+		* @param begin : the index of the first particle of the range
+		* @param end : the index following the last particle of the range
+		* @since 1.06.00
+		*/
+		virtual void applyPermutation(const unsigned int* permutation,size_t begin,size_t end);
+
+		/**
+		* @brief Removes the data of the dead particles from this buffer
+		*
+		* The data of the particles alive among the nbParticles first ones are moved to the beginning of the buffer, keeping their order.
+		* The particle at the index i is alive if the bit i % 64 of the word i / 64 of the mask is set.<br>
+		* This method is called by the Group when it compacts its particles at once, if the data of this buffer is swapped with particles.<br>
+		* <br>
+		* By default the data are moved with swap(size_t,size_t).
+		* Children should override it to move their data in a single pass.
+		*
+		* @param aliveMask : the mask of the particles alive
+		* @param nbParticles : the number of particles described by the mask
+		* @since 1.06.00
+		*/
+		virtual void compact(const unsigned long long* aliveMask,size_t nbParticles);
 	};
 
 	/**
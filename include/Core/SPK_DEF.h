@@ -63,6 +63,9 @@
 #define SPK_TRACE(text)
 #endif
 
+// Disables the SIMD kernels (since 1.06.00)
+//#define SPK_NO_SIMD
+
 /**
 * @mainpage SPARK Particle Engine
 *
@@ -105,6 +108,9 @@ namespace SPK
 	* @brief Returns a random number in the range [min,max[
 	*
 	* Note that the sequence of pseudo random number generated depends on the initial seed which can be set by setting randomSeed.<br>
+	* <br>
+	* Since 1.06.00, the particles are generated with the stream of random numbers of their Group (see RandomGenerator).
+	* This function is kept for compatibility. It is not thread safe.
 	*
 	* @param min : the minimum value
 	* @param max : the maximum value
@@ -130,6 +136,36 @@ namespace SPK
         return static_cast<T>(min + ((randomSeed - 1) / 2147483646.0) * (max - min));
     }
 
+	/**
+	* @brief The alignment in bytes of the arrays holding the particles data
+	*
+	* It matches the size of a cache line so that the arrays are also suitably aligned for any SIMD instruction set.
+	*
+	* @since 1.06.00
+	*/
+	const size_t DATA_ALIGNMENT = 64;
+
+	/**
+	* @brief Allocates a block of memory aligned on DATA_ALIGNMENT bytes
+	*
+	* The block must be released with releaseAligned(void*).
+	*
+	* @param size : the size of the block in bytes
+	* @return a pointer to the allocated block
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void* allocateAligned(size_t size);
+
+	/**
+	* @brief Releases a block of memory allocated with allocateAligned(size_t)
+	*
+	* Passing NULL does nothing.
+	*
+	* @param block : the block to release
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void releaseAligned(void* block);
+
 	/////////////////////////
 	// global enumerations //
 	/////////////////////////
@@ -235,6 +235,35 @@ namespace SPK
 		*/
 		void generateVelocity(Particle& particle) const;
 
+		/**
+		* @brief Emits a range of particles of a Group from this Emitter
+		*
+		* This gives the same distributions as calling emit(Particle&) for each Particle of the range
+		* but the random numbers are drawn for the whole range at once from the RandomGenerator of the Group.<br>
+		* The positions are generated with Zone::generatePositions(Group&,size_t,size_t,bool) and the velocities with generateVelocities(Group&,size_t,size_t).<br>
+		* <br>
+		* The parameters of the particles must be initialized before as the velocities depend on their mass.
+		* Note that this will not decrease the number of particles in the Emitter's tank.
+		*
+		* @param group : the Group whose particles are emitted
+		* @param begin : the index of the first Particle of the range
+		* @param end : the index following the last Particle of the range
+		* @since 1.06.00
+		*/
+		void emitBatch(Group& group,size_t begin,size_t end) const;
+
+		/**
+		* @brief Generates the velocities of a range of particles of a Group
+		*
+		* This is the batch version of generateVelocity(Particle&).
+		*
+		* @param group : the Group whose particles velocities are generated
+		* @param begin : the index of the first Particle of the range
+		* @param end : the index following the last Particle of the range
+		* @since 1.06.00
+		*/
+		void generateVelocities(Group& group,size_t begin,size_t end) const;
+
 		virtual Registerable* findByName(const std::string& name);
 
 	protected :
@@ -280,6 +309,21 @@ namespace SPK
 		* @param speed : the speed that the velocity must have
 		*/
 		virtual void generateVelocity(Particle& particle,float speed) const = 0;
+
+		/**
+		* @brief Generates the velocities of a range of particles of a Group in function of their speeds
+		*
+		* The velocity of each Particle must have a norm equal to its speed. The ranges hold Zone::BATCH_SIZE particles at most.<br>
+		* The default implementation calls generateVelocity(Particle&,float) for each Particle of the range.
+		* Children can override it to draw the random numbers of the whole range at once from the RandomGenerator of the Group.
+		*
+		* @param group : the Group whose particles velocities are generated
+		* @param begin : the index of the first Particle of the range
+		* @param end : the index following the last Particle of the range
+		* @param speeds : the array of the end - begin speeds of the particles
+		* @since 1.06.00
+		*/
+		virtual void generateVelocities(Group& group,size_t begin,size_t end,const float* speeds) const;
 	};
 
 
@@ -352,7 +396,13 @@ namespace SPK
 
 	inline void Emitter::generateVelocity(Particle& particle) const
 	{
-		generateVelocity(particle,random(forceMin,forceMax) / particle.getParamCurrentValue(PARAM_MASS));
+		generateVelocity(particle,particle.getRandomGenerator().random(forceMin,forceMax) / particle.getParamCurrentValue(PARAM_MASS));
+	}
+
+	inline void Emitter::emitBatch(Group& group,size_t begin,size_t end) const
+	{
+		zone->generatePositions(group,begin,end,full);
+		generateVelocities(group,begin,end);
 	}
 
 	inline void Emitter::propagateUpdateTransform()
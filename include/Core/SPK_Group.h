@@ -30,10 +30,14 @@
 #include "Core/SPK_Pool.h"
 #include "Core/SPK_Particle.h"
 
+#include <atomic>
+
 
 namespace SPK
 {
 	class Renderer;
+	class RenderOutputSink;
+	class GroupSnapshot;
 	class Emitter;
 	class Modifier;
 	class Zone;
@@ -41,6 +45,85 @@ namespace SPK
 	class Buffer;
 	class BufferCreator;
 
+	/**
+	* @enum SortingMode
+	* @brief Constants defining how the particles of a Group are sorted
+	* @since 1.06.00
+	*/
+	enum SortingMode
+	{
+		SORTING_SWAP,		/**< The particles are sorted by swapping their data (quicksort) */
+		SORTING_INDICES,	/**< The indices of the particles are sorted (radix sort) and the data of the particles is not moved */
+		SORTING_GATHER,		/**< The indices of the particles are sorted (radix sort) and the data of the particles is then reordered in one pass */
+		SORTING_INCREMENTAL,	/**< The order of the previous sort is refined (insertion sort) and the data of the particles is then reordered in one pass */
+	};
+
+	/**
+	* @enum SortingPath
+	* @brief Constants telling how the particles of a Group were sorted at the last sort
+	* @since 1.06.00
+	*/
+	enum SortingPath
+	{
+		SORTING_PATH_NONE,			/**< The particles were not sorted */
+		SORTING_PATH_FULL,			/**< The particles were sorted from scratch */
+		SORTING_PATH_INCREMENTAL,	/**< The order of the previous sort was refined */
+	};
+
+	/**
+	* @struct SortingStats
+	* @brief Statistics about the last sort of the particles of a Group
+	* @since 1.06.00
+	*/
+	struct SortingStats
+	{
+		SortingPath path;		/**< The way the particles were sorted */
+		size_t nbNewBorns;		/**< The number of newborn particles merged into the previous order (SORTING_INCREMENTAL only) */
+		size_t nbMoves;			/**< The number of moves of the insertion sort (SORTING_INCREMENTAL only) */
+	};
+
+	/**
+	* @struct ParamAccessor
+	* @brief A direct read access to the current values of a parameter of the particles of a Group
+	*
+	* An accessor is resolved once with Group::getParamAccessor(ModelParam) and then reads the value of any Particle without testing the Model.<br>
+	* If the parameter is enabled, the accessor points to the array of the parameter with a stride of 1.
+	* Otherwise it points to the default value of the parameter with a stride of 0, so that every Particle reads the default value.<br>
+	* <br>
+	* An accessor is valid until the Model or the capacity of the Group changes.
+	* Modifiers resolve their accessors at the beginning of each update of a Group.
+	*
+	* @since 1.06.00
+	*/
+	struct ParamAccessor
+	{
+		const float* values;	/**< The array of values or the default value */
+		size_t stride;			/**< 1 if the parameter is enabled, 0 otherwise */
+
+		/** @brief Default constructor of accessor. The accessor must be resolved before being read */
+		ParamAccessor() : values(NULL),stride(0) {}
+
+		/**
+		* @brief Constructs an accessor
+		* @param values : the array of values or the default value
+		* @param stride : 1 if the parameter is enabled, 0 otherwise
+		*/
+		ParamAccessor(const float* values,size_t stride) : values(values),stride(stride) {}
+
+		/**
+		* @brief Gets the value of the parameter of a Particle
+		* @param index : the index of the Particle in its Group
+		* @return the value of the parameter
+		*/
+		float operator[](size_t index) const { return values[index * stride]; }
+
+		/**
+		* @brief Tells whether the parameter is enabled
+		* @return true if the parameter is enabled, false if the default value is read
+		*/
+		bool isEnabled() const { return stride != 0; }
+	};
+
 	/**
 	* @class Group
 	* @brief A group of many particles
@@ -127,6 +210,25 @@ namespace SPK
 		*/
 		void setRenderer(Renderer* renderer);
 
+		/**
+		* @brief Sets the sink receiving the output of this Group
+		*
+		* When the Group is rendered with render(), it writes its output in the next free region of the sink
+		* (see RenderOutputSink::write(const Group&)) before calling its Renderer if any.
+		* The data to render can then be consumed on another thread without reading the Group.<br>
+		* <br>
+		* The sink is not owned by the Group and is not given to the copies of the Group. By default, there is no sink.<br>
+		* <br>
+		* A sink only receives the output of a single Group (see RenderOutputSink::getProducer()).
+		* If the sink is already set to another Group, nothing happens and false is returned.
+		* The previous sink of this Group, if any, is released and can be set to another Group.
+		*
+		* @param sink : the sink receiving the output of this Group or NULL
+		* @return true if the sink is set, false otherwise
+		* @since 1.06.00
+		*/
+		bool setOutputSink(RenderOutputSink* sink);
+
 		/**
 		* @brief Sets the friction of this Group
 		*
@@ -213,6 +315,29 @@ namespace SPK
 		*/
 		void enableSorting(bool sort);
 
+		/**
+		* @brief Sets the way the particles are sorted
+		*
+		* The sorting modes are :
+		* <ul>
+		* <li>SORTING_SWAP : the particles are sorted with a quicksort that swaps the data of the particles. This is the default mode.</li>
+		* <li>SORTING_INDICES : the square distances of the particles are radix sorted into an array of indices that can be gotten with getSortedIndices().
+		* The particles themselves are not moved, so a Renderer must parse the particles in the order given by the indices.</li>
+		* <li>SORTING_GATHER : the indices are radix sorted as with SORTING_INDICES, then the data of the particles is reordered in a single pass.
+		* The particles are sorted as with SORTING_SWAP.</li>
+		* <li>SORTING_INCREMENTAL : as the depth order changes little from one frame to the next, the order left by the previous sort is refined
+		* with an insertion sort, while the newborn particles are sorted apart and merged in. The data is then reordered as with SORTING_GATHER.
+		* When the particles are too much out of order, the insertion sort is given up and a radix sort is performed instead.
+		* The way the particles were sorted can be checked with getSortingStats().</li>
+		* </ul>
+		* The radix sort runs in linear time and does not swap the data of the particles, it is therefore much faster on large groups.
+		* Note that particles at the same distance from the camera may be ordered differently from one mode to another.
+		*
+		* @param mode : the sorting mode
+		* @since 1.06.00
+		*/
+		void setSortingMode(SortingMode mode);
+
 		/**
 		* @brief Enables or disables the computation of the distance of a Particle from the camera
 		*
@@ -242,6 +367,83 @@ namespace SPK
 		*/
 		void enableAABBComputing(bool AABB);
 
+		/**
+		* @brief Enables or disables the parallel update of the particles
+		*
+		* When the parallel update is enabled, the particles are updated by chunks on the worker threads of the ThreadPool.<br>
+		* The particles that die are collected per chunk and handled once all the chunks are updated,
+		* so that emitters, births and deaths are still processed on the calling thread.<br>
+		* <br>
+		* The update falls back to a serial update when a Modifier of the Group is not thread safe (see Modifier::isThreadSafe()).
+		* Note that the custom update function (see setCustomUpdate(bool (*)(Particle&,float))) is called from the worker threads and must be thread safe.<br>
+		* <br>
+		* The result of the update is the same whether the parallel update is enabled or not. By default it is disabled.
+		*
+		* @param parallel : true to enable the parallel update, false to disable it
+		* @since 1.06.00
+		*/
+		void enableParallelUpdate(bool parallel);
+
+		/**
+		* @brief Enables or disables the culling of the modifiers whose Zone is out of reach of the particles
+		*
+		* When the culling is enabled, the AABB of the Group computed by the previous update is grown by the distance
+		* the fastest Particle can travel during the time step. The modifiers whose Zone does not overlap this box (see Zone::getAABB(vec3&,vec3&))
+		* do not test their Zone for each Particle :
+		* <ul>
+		* <li>a Modifier that no Particle can trigger is skipped for the update</li>
+		* <li>a Modifier with the trigger OUTSIDE_ZONE is applied to all the particles</li>
+		* </ul>
+		* The culling stops at the first Modifier which may move particles away from their paths (see Modifier::movesParticlesAway()).<br>
+		* <br>
+		* The culling needs the computation of the AABB (see enableAABBComputing(bool)) and is only performed from the update following the one enabling it.
+		* It assumes that the particles are not moved nor accelerated by the user between two updates.<br>
+		* By default it is disabled.
+		*
+		* @param culling : true to enable the culling of the modifiers, false to disable it
+		* @since 1.06.00
+		*/
+		void enableModifierCulling(bool culling);
+
+		/**
+		* @brief Enables or disables the compaction of the particles that die
+		*
+		* By default, a Particle that dies is replaced in place by a Particle being born if any,
+		* otherwise it is swapped with the last active Particle. Killing many particles in a single update
+		* therefore results in many scattered swaps which reorder the particles unpredictably.<br>
+		* <br>
+		* When the compaction is enabled, the deaths are recorded in a bit mask during the update of the particles.
+		* The particles alive are then moved at once to the beginning of the Group, keeping their order,
+		* and the particles born during the update are all added after them.
+		* The death function (see setCustomDeath(void (*)(Particle&))) and the swappable buffers are handled in the same pass.<br>
+		* <br>
+		* The compaction moves all the particles following the first one that dies : it pays off when a large part of the particles die at each update
+		* while the default handling is cheaper when the deaths are rare.
+		* By default it is disabled.
+		*
+		* @param compaction : true to enable the compaction of the particles that die, false to disable it
+		* @since 1.06.00
+		*/
+		void enableDeathCompaction(bool compaction);
+
+		/**
+		* @brief Enables or disables the snapshots of this Group
+		*
+		* When the snapshots are enabled, the data read by the Renderer of the Group are copied in a GroupSnapshot at the end of each update
+		* and the snapshot is published at once (see acquireSnapshot()).
+		* The rendering can therefore read the snapshot of an update while the next update runs on another thread.<br>
+		* <br>
+		* The Group holds 2 snapshots : the published one and the one written by the next update.
+		* If a reader still holds the latter, the update is not published rather than waiting for the reader,
+		* so a snapshot must be released as soon as it has been read.<br>
+		* <br>
+		* The snapshots must not be enabled or disabled while a reader holds one. By default they are disabled.
+		*
+		* @param snapshot : true to enable the snapshots, false to disable them
+		* @since 1.06.00
+		*/
+		void enableSnapshot(bool snapshot);
+
 		/**
 		* @brief Enables or not Renderer buffers management in a statix way
 		*
@@ -340,12 +542,40 @@ namespace SPK
 		*/
 		Model* getModel() const;
 
+		/**
+		* @brief Gets the RandomGenerator of this Group
+		*
+		* The particles of this Group are generated with random numbers drawn from this RandomGenerator only.
+		* As a consequence, the results of the update of this Group do not depend on the updates of the other Groups
+		* and several Groups can be updated in parallel (see System::enableParallelUpdate(bool)).<br>
+		* <br>
+		* When the Group is created or copied, its RandomGenerator is seeded with a number drawn from the global random(T,T) function.
+		* Setting randomSeed before creating the Groups therefore still gives reproducible results.
+		* The seed of a Group can also be set directly with getRandomGenerator().setSeed(unsigned int).<br>
+		* <br>
+		* The random numbers drawn by the modifiers from the RandomGenerator of the calling thread (see getThreadRandomGenerator())
+		* also derive from this RandomGenerator : at each update, a key is drawn from it and the stream of the thread is reseeded
+		* with this key and the index of each chunk of particles before the chunk is modified.
+		* The results therefore do not depend on the thread that updates each chunk.
+		*
+		* @return the RandomGenerator of this Group
+		* @since 1.06.00
+		*/
+		RandomGenerator& getRandomGenerator();
+
 		/**
 		* @brief Gets the Renderer of this Group
 		* @return the Renderer of this Group
 		*/
 		Renderer* getRenderer() const;
 
+		/**
+		* @brief Gets the sink receiving the output of this Group
+		* @return the sink receiving the output of this Group or NULL
+		* @since 1.06.00
+		*/
+		RenderOutputSink* getOutputSink() const;
+
 		/**
 		* @brief Gets the friction coefficient of this Group
 		*
@@ -373,6 +603,40 @@ namespace SPK
 		*/
 		bool isSortingEnabled() const;
 
+		/**
+		* @brief Gets the sorting mode of this Group
+		*
+		* For a description of the sorting modes, see setSortingMode(SortingMode).
+		*
+		* @return the sorting mode of this Group
+		* @since 1.06.00
+		*/
+		SortingMode getSortingMode() const;
+
+		/**
+		* @brief Gets the indices of the particles sorted from the furthest to the closest to the camera
+		*
+		* The indices are only available when the sorting is enabled and the sorting mode is SORTING_INDICES.
+		* Otherwise NULL is returned.<br>
+		* The array holds getNbParticles() indices. It is computed by update(float) and sortParticles() and
+		* is no longer valid once particles are added or removed from the Group :
+		* NULL is then returned as long as the number of particles differs from the number of indices.
+		*
+		* @return the sorted indices of the particles or NULL if they are not available
+		* @since 1.06.00
+		*/
+		const unsigned int* getSortedIndices() const;
+
+		/**
+		* @brief Gets statistics about the last sort of the particles of this Group
+		*
+		* This is mainly useful to check how the SORTING_INCREMENTAL mode behaves (see setSortingMode(SortingMode)).
+		*
+		* @return the statistics about the last sort
+		* @since 1.06.00
+		*/
+		const SortingStats& getSortingStats() const;
+
 		/**
 		* @brief Tells whether the distance computation between particles and camera is enabled
 		* @return true is the distance computation is enabled, false if not
@@ -389,6 +653,46 @@ namespace SPK
 		*/
 		bool isAABBComputingEnabled() const;
 
+		/**
+		* @brief Tells whether the parallel update is enabled
+		*
+		* For a description of the parallel update, see enableParallelUpdate(bool).
+		*
+		* @return true if the parallel update is enabled, false if it is disabled
+		* @since 1.06.00
+		*/
+		bool isParallelUpdateEnabled() const;
+
+		/**
+		* @brief Tells whether the culling of the modifiers is enabled
+		*
+		* For a description of the culling of the modifiers, see enableModifierCulling(bool).
+		*
+		* @return true if the culling of the modifiers is enabled, false if it is disabled
+		* @since 1.06.00
+		*/
+		bool isModifierCullingEnabled() const;
+
+		/**
+		* @brief Tells whether the compaction of the particles that die is enabled
+		*
+		* For a description of the compaction, see enableDeathCompaction(bool).
+		*
+		* @return true if the compaction of the particles that die is enabled, false if it is disabled
+		* @since 1.06.00
+		*/
+		bool isDeathCompactionEnabled() const;
+
+		/**
+		* @brief Tells whether the snapshots of this Group are enabled
+		*
+		* For a description of the snapshots, see enableSnapshot(bool).
+		*
+		* @return true if the snapshots are enabled, false if they are disabled
+		* @since 1.06.00
+		*/
+		bool isSnapshotEnabled() const;
+
 		/**
 		* @brief Gets a vec3 holding the minimum coordinates of the AABB of the Group.
 		*
@@ -413,7 +717,9 @@ namespace SPK
 		* This method is used by a Renderer to define the start position of an array to pass to the GPU.<br>
 		* You will not generally need it unless you re designing your own Renderer.<br>
 		* <br>
-		* Note that if the parameter is not enabled, the return value will point to an enabled parameter starting address.
+		* Note that if the parameter is not enabled, the return value will point to an enabled parameter starting address.<br>
+		* <br>
+		* Since 1.06.00, each parameter is stored in its own array aligned on DATA_ALIGNMENT bytes.
 		*
 		* @param param : the parameter whose start address is gotten
 		* @since 1.03.00
@@ -434,7 +740,9 @@ namespace SPK
 		* @brief Gets the stride for parameters
 		*
 		* This method is used by a Renderer to know the stride of an array to pass to the GPU.<br>
-		* You will not generally need it unless you re designing your own Renderer.
+		* You will not generally need it unless you re designing your own Renderer.<br>
+		* <br>
+		* Since 1.06.00, parameters are tightly packed in their own array and the stride is the size of a float.
 		*
 		* @since 1.03.00
 		*/
@@ -444,12 +752,153 @@ namespace SPK
 		* @brief Gets the stride for positions
 		*
 		* This method is used by a Renderer to know the stride of an array to pass to the GPU.<br>
-		* You will not generally need it unless you re designing your own Renderer.
+		* You will not generally need it unless you re designing your own Renderer.<br>
+		* <br>
+		* Since 1.06.00, positions are tightly packed in their own array and the stride is the size of a vec3.
 		*
 		* @since 1.03.00
 		*/
 		size_t getPositionStride() const;
 
+		/**
+		* @brief Gets the array of the positions of the particles
+		*
+		* The array is indexed as the particles of the Group and is aligned on DATA_ALIGNMENT bytes.<br>
+		* It allows to process a range of particles at once (see Modifier::modifyBatch(Group&,size_t,size_t,float)).
+		*
+		* @return the array of positions
+		* @since 1.06.00
+		*/
+		vec3* getPositionArray();
+
+		/**
+		* @brief Gets the array of the positions of the particles
+		*
+		* This is the constant version of getPositionArray().
+		*
+		* @return the array of positions
+		* @since 1.06.00
+		*/
+		const vec3* getPositionArray() const;
+
+		/**
+		* @brief Gets the array of the positions of the particles at the previous update
+		*
+		* The array is indexed as the particles of the Group and is aligned on DATA_ALIGNMENT bytes.<br>
+		* It allows to process a range of particles at once (see Modifier::modifyBatch(Group&,size_t,size_t,float)).
+		*
+		* @return the array of old positions
+		* @since 1.06.00
+		*/
+		vec3* getOldPositionArray();
+
+		/**
+		* @brief Gets the array of the positions of the particles at the previous update
+		*
+		* This is the constant version of getOldPositionArray().
+		*
+		* @return the array of old positions
+		* @since 1.06.00
+		*/
+		const vec3* getOldPositionArray() const;
+
+		/**
+		* @brief Gets the array of the velocities of the particles
+		*
+		* The array is indexed as the particles of the Group and is aligned on DATA_ALIGNMENT bytes.<br>
+		* It allows to process a range of particles at once (see Modifier::modifyBatch(Group&,size_t,size_t,float)).
+		*
+		* @return the array of velocities
+		* @since 1.06.00
+		*/
+		vec3* getVelocityArray();
+
+		/**
+		* @brief Gets the array of the velocities of the particles
+		*
+		* This is the constant version of getVelocityArray().
+		*
+		* @return the array of velocities
+		* @since 1.06.00
+		*/
+		const vec3* getVelocityArray() const;
+
+		/**
+		* @brief Gets the array of the ages of the particles
+		*
+		* The array is indexed as the particles of the Group and is aligned on DATA_ALIGNMENT bytes.<br>
+		* It allows to process a range of particles at once (see Modifier::modifyBatch(Group&,size_t,size_t,float)).
+		*
+		* @return the array of ages
+		* @since 1.06.00
+		*/
+		float* getAgeArray();
+
+		/**
+		* @brief Gets the array of the ages of the particles
+		*
+		* This is the constant version of getAgeArray().
+		*
+		* @return the array of ages
+		* @since 1.06.00
+		*/
+		const float* getAgeArray() const;
+
+		/**
+		* @brief Gets the array of the life left of the particles
+		*
+		* The array is indexed as the particles of the Group and is aligned on DATA_ALIGNMENT bytes.<br>
+		* It allows to process a range of particles at once (see Modifier::modifyBatch(Group&,size_t,size_t,float)).
+		*
+		* @return the array of lives
+		* @since 1.06.00
+		*/
+		float* getLifeArray();
+
+		/**
+		* @brief Gets the array of the life left of the particles
+		*
+		* This is the constant version of getLifeArray().
+		*
+		* @return the array of lives
+		* @since 1.06.00
+		*/
+		const float* getLifeArray() const;
+
+		/**
+		* @brief Gets the array of current values of the given parameter
+		*
+		* The array is indexed as the particles of the Group and is aligned on DATA_ALIGNMENT bytes.<br>
+		* If the parameter is not enabled in the Model of the Group, NULL is returned and the default value of the parameter applies to every Particle.
+		*
+		* @param param : the parameter whose array is gotten
+		* @return the array of current values of the parameter or NULL if it is not enabled
+		* @since 1.06.00
+		*/
+		float* getParamArray(ModelParam param);
+
+		/**
+		* @brief Gets the array of current values of the given parameter
+		*
+		* This is the constant version of getParamArray(ModelParam).
+		*
+		* @param param : the parameter whose array is gotten
+		* @return the array of current values of the parameter or NULL if it is not enabled
+		* @since 1.06.00
+		*/
+		const float* getParamArray(ModelParam param) const;
+
+		/**
+		* @brief Gets an accessor to the current values of the given parameter
+		*
+		* Unlike getParamArray(ModelParam), the accessor can be read whether the parameter is enabled or not (see ParamAccessor).
+		*
+		* @param param : the parameter whose accessor is gotten
+		* @return the accessor to the current values of the parameter
+		* @since 1.06.00
+		*/
+		ParamAccessor getParamAccessor(ModelParam param) const;
+
 		/**
 		* @brief Tells whether renderers buffer management is enabled or not
 		*
@@ -661,10 +1110,29 @@ namespace SPK
 		/**
 		* @brief Renders this Group
 		*
-		* Note that if no Renderer is attached to the Group, nothing will happen.
+		* If an output sink is set (see setOutputSink(RenderOutputSink*)), the output of the Group is written in it first.<br>
+		* Note that if no Renderer is attached to the Group, nothing else will happen.
 		*/
 		void render();
 
+		/**
+		* @brief Acquires the last snapshot published by this Group
+		*
+		* The snapshot is not written by the updates until it is released with releaseSnapshot(const GroupSnapshot*).
+		* It can be acquired from any thread while the Group is updated.
+		*
+		* @return the last snapshot published or NULL if the snapshots are disabled or none was published yet
+		* @since 1.06.00
+		*/
+		const GroupSnapshot* acquireSnapshot() const;
+
+		/**
+		* @brief Releases a snapshot acquired with acquireSnapshot()
+		* @param snapshot : the snapshot to release
+		* @since 1.06.00
+		*/
+		void releaseSnapshot(const GroupSnapshot* snapshot) const;
+
 		/**
 		* @brief Empties this Group
 		*
@@ -820,13 +1288,37 @@ namespace SPK
 			unsigned int nbParticles;
 		};
 
+		// Results of the update of a chunk of particles
+		struct ChunkData
+		{
+			std::vector<size_t> deadParticles; // Indices of the particles that died during the update
+			size_t nbDeaths; // Number of particles that died when the deaths are recorded in the mask (since 1.06.00)
+			std::vector<float> interpolationXs; // Buffer of the x used to interpolate the parameters
+			vec3 AABBMin;
+			vec3 AABBMax;
+			float maxSqrVelocity; // Highest square norm of the velocities of the particles alive
+		};
+
+		struct UpdateTaskData
+		{
+			Group* group;
+			size_t chunkSize;
+			float deltaTime;
+			unsigned int randomKey;
+		};
+
 		// statics
 		static bool bufferManagement;
+		static const size_t UPDATE_CHUNK_SIZE = 1024; // Number of particles processed by a modifier at once
+		static const size_t INCREMENTAL_SORT_MAX_MOVES = 8; // Average number of moves per particle above which the incremental sort is given up
+		static const size_t COMPACTION_MIN_RUN_SIZE = 32; // Average number of consecutive particles alive from which they are moved by runs
+		static void updateChunkTask(void* data,size_t index);
 		static Model& getDefaultModel();
 
 		// registerables
 		Model* model;
 		Renderer* renderer;
+		RenderOutputSink* outputSink; // (since 1.06.00)
 		std::vector<Emitter*> emitters;
 		std::vector<Modifier*> modifiers;
 
@@ -839,13 +1331,23 @@ namespace SPK
 
 		// particles data
 		Pool<Particle> pool;
-		Particle::ParticleData* particleData;
-		float* particleCurrentParams; // Stores the current parameters values of the particles
-		float* particleExtendedParams; // Stores the extended parameters values of the particles (final values and interpolated data)
+		Particle::ParticleData particleData; // Stores the particles data as a structure of arrays (since 1.06.00)
+		RandomGenerator randomGenerator; // Stream of random numbers used to generate the particles (since 1.06.00)
+
+		std::vector<ChunkData> chunks; // Results of the update of each chunk of particles (since 1.06.00)
+		bool parallelUpdateEnabled;
 
 		// sorting
 		bool sortingEnabled;
 		bool distanceComputationEnabled;
+		SortingMode sortingMode;
+		std::vector<unsigned int> sortedIndices; // Indices of the particles from the furthest to the closest (since 1.06.00)
+		std::vector<unsigned int> sortKeys;
+		std::vector<unsigned int> radixKeys; // Buffers used by the radix sort
+		std::vector<unsigned int> radixIndices;
+		std::vector<float> gatherBuffer; // Buffer used to reorder the data of the particles
+		std::vector<unsigned long long> sortEntries; // Keys and indices used by the incremental sort
+		SortingStats sortingStats;
 
 		// creation data
 		std::deque<CreationData> creationBuffer;
@@ -861,20 +1363,51 @@ namespace SPK
 		vec3 AABBMin;
 		vec3 AABBMax;
 
+		// modifier culling
+		bool modifierCullingEnabled; // (since 1.06.00)
+		bool reachComputed; // true if the bounding box and the velocities of the previous update can be used to cull the modifiers (since 1.06.00)
+		float maxSqrVelocity; // (since 1.06.00)
+
+		// compaction of the dead particles
+		bool deathCompactionEnabled; // (since 1.06.00)
+		std::vector<unsigned long long> aliveMask; // One bit per particle cleared when it dies during the update (since 1.06.00)
+		std::vector<unsigned int> aliveIndices; // Indices of the particles alive moved by the compaction (since 1.06.00)
+		std::vector<unsigned int> aliveRuns; // First index and length of the runs of consecutive particles alive (since 1.06.00)
+
+		// snapshots
+		GroupSnapshot* snapshots; // The 2 snapshots or NULL if they are disabled (since 1.06.00)
+		std::atomic<GroupSnapshot*> publishedSnapshot; // (since 1.06.00)
+
 		// additional buffers
 		mutable std::map<std::string,Buffer*> additionalBuffers;
-		mutable std::set<Buffer*> swappableBuffers;
+		mutable std::vector<Buffer*> swappableBuffers; // stored in a vector to be parsed fast (since 1.06.00)
 
 		void pushParticle(std::vector<EmitterData>::iterator& emitterIt,unsigned int& nbManualBorn);
 		void launchParticle(Particle& p,std::vector<EmitterData>::iterator& emitterIt,unsigned int& nbManualBorn);
+		void pushParticles(unsigned int nb,std::vector<EmitterData>::iterator& emitterIt);
+		void launchParticles(size_t begin,size_t end,const Emitter& emitter);
 
 		void addParticles(unsigned int nb,const vec3& position,const vec3& velocity,const Zone* zone,Emitter* emitter,bool full = false);
 
 		void popNextManualAdding(unsigned int& nbManualBorn);
 
-		void updateAABB(const Particle& particle);
+		static void updateAABB(const vec3& position,vec3& AABBMin,vec3& AABBMax);
 
+		void updateChunk(size_t chunkIndex,size_t chunkSize,float deltaTime,unsigned int randomKey);
+		void compactParticles(size_t nbDeaths);
+		void interpolateParameters(size_t begin,size_t end,std::vector<float>& xs);
+
+		void sortActiveParticles();
 		void sortParticles(int start,int end);
+		void radixSortParticles();
+		bool incrementalSortParticles(size_t& begin,size_t& end);
+		void gatherParticles(size_t begin,size_t end);
+
+		void allocateParticleData(size_t capacity);
+		void releaseParticleData();
+		void copyParticleData(const Particle::ParticleData& src,size_t nb);
+
+		void publishSnapshot();
 	};
 
 
@@ -916,6 +1449,11 @@ namespace SPK
 		distanceComputationEnabled = sort;
 	}
 
+	inline void Group::setSortingMode(SortingMode mode)
+	{
+		sortingMode = mode;
+	}
+
 	inline void Group::enableDistanceComputation(bool distanceComputation)
 	{
 		distanceComputationEnabled = distanceComputation;
@@ -927,6 +1465,21 @@ namespace SPK
 		boundingBoxEnabled = AABB;
 	}
 
+	inline void Group::enableParallelUpdate(bool parallel)
+	{
+		parallelUpdateEnabled = parallel;
+	}
+
+	inline void Group::enableModifierCulling(bool culling)
+	{
+		modifierCullingEnabled = culling;
+	}
+
+	inline void Group::enableDeathCompaction(bool compaction)
+	{
+		deathCompactionEnabled = compaction;
+	}
+
 	inline const Pool<Particle>& Group::getParticles() const
 	{
 		return pool;
@@ -982,11 +1535,21 @@ namespace SPK
 		return model;
 	}
 
+	inline RandomGenerator& Group::getRandomGenerator()
+	{
+		return randomGenerator;
+	}
+
 	inline Renderer* Group::getRenderer() const
 	{
 		return renderer;
 	}
 
+	inline RenderOutputSink* Group::getOutputSink() const
+	{
+		return outputSink;
+	}
+
 	inline float Group::getFriction() const
 	{
 		return friction;
@@ -1002,6 +1565,24 @@ namespace SPK
 		return sortingEnabled;
 	}
 
+	inline SortingMode Group::getSortingMode() const
+	{
+		return sortingMode;
+	}
+
+	inline const unsigned int* Group::getSortedIndices() const
+	{
+		if ((!sortingEnabled)||(sortingMode != SORTING_INDICES)||(sortedIndices.empty())||(sortedIndices.size() != getNbParticles()))
+			return NULL;
+
+		return &sortedIndices[0];
+	}
+
+	inline const SortingStats& Group::getSortingStats() const
+	{
+		return sortingStats;
+	}
+
 	inline bool Group::isDistanceComputationEnabled() const
 	{
 		return distanceComputationEnabled;
@@ -1012,6 +1593,26 @@ namespace SPK
 		return boundingBoxEnabled;
 	}
 
+	inline bool Group::isParallelUpdateEnabled() const
+	{
+		return parallelUpdateEnabled;
+	}
+
+	inline bool Group::isModifierCullingEnabled() const
+	{
+		return modifierCullingEnabled;
+	}
+
+	inline bool Group::isDeathCompactionEnabled() const
+	{
+		return deathCompactionEnabled;
+	}
+
+	inline bool Group::isSnapshotEnabled() const
+	{
+		return snapshots != NULL;
+	}
+
 	inline const vec3& Group::getAABBMin() const
 	{
 		return AABBMin;
@@ -1049,12 +1650,80 @@ namespace SPK
 
 	inline const void* Group::getPositionAddress() const
 	{
-		return &(particleData[0].position);
+		return particleData.positions;
 	}
 
 	inline size_t Group::getPositionStride() const
 	{
-		return sizeof(Particle::ParticleData);
+		return sizeof(vec3);
+	}
+
+	inline vec3* Group::getPositionArray()
+	{
+		return particleData.positions;
+	}
+
+	inline const vec3* Group::getPositionArray() const
+	{
+		return particleData.positions;
+	}
+
+	inline vec3* Group::getOldPositionArray()
+	{
+		return particleData.oldPositions;
+	}
+
+	inline const vec3* Group::getOldPositionArray() const
+	{
+		return particleData.oldPositions;
+	}
+
+	inline vec3* Group::getVelocityArray()
+	{
+		return particleData.velocities;
+	}
+
+	inline const vec3* Group::getVelocityArray() const
+	{
+		return particleData.velocities;
+	}
+
+	inline float* Group::getAgeArray()
+	{
+		return particleData.ages;
+	}
+
+	inline const float* Group::getAgeArray() const
+	{
+		return particleData.ages;
+	}
+
+	inline float* Group::getLifeArray()
+	{
+		return particleData.lives;
+	}
+
+	inline const float* Group::getLifeArray() const
+	{
+		return particleData.lives;
+	}
+
+	inline float* Group::getParamArray(ModelParam param)
+	{
+		return model->isEnabled(param) ? particleData.currentParams + model->getParameterOffset(param) * particleData.pitch : NULL;
+	}
+
+	inline const float* Group::getParamArray(ModelParam param) const
+	{
+		return model->isEnabled(param) ? particleData.currentParams + model->getParameterOffset(param) * particleData.pitch : NULL;
+	}
+
+	inline ParamAccessor Group::getParamAccessor(ModelParam param) const
+	{
+		if (model->isEnabled(param))
+			return ParamAccessor(particleData.currentParams + model->getParameterOffset(param) * particleData.pitch,1);
+		else
+			return ParamAccessor(&Model::DEFAULT_VALUES[param],0);
 	}
 }
 
@@ -0,0 +1,235 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef H_SPK_GROUPSNAPSHOT
+#define H_SPK_GROUPSNAPSHOT
+
+#include "Core/SPK_DEF.h"
+#include "Core/SPK_Vector3D.h"
+#include "Core/SPK_Model.h"
+#include "Core/SPK_Group.h"
+
+#include <atomic>
+
+
+namespace SPK
+{
+	/**
+	* @enum SnapshotChannel
+	* @brief Constants defining the data of a Group copied in its snapshots
+	*
+	* The parameters of the particles are selected apart with the ModelParamFlag constants.
+	*
+	* @since 1.06.00
+	*/
+	enum SnapshotChannel
+	{
+		SNAPSHOT_POSITIONS = 1 << 0,		/**< The positions of the particles */
+		SNAPSHOT_VELOCITIES = 1 << 1,		/**< The velocities of the particles */
+		SNAPSHOT_SORTED_INDICES = 1 << 2,	/**< The indices of the sorted particles (only copied with SORTING_INDICES) */
+		SNAPSHOT_AABB = 1 << 3,				/**< The bounding box of the Group (only copied if its computation is enabled) */
+	};
+
+	/**
+	* @class GroupSnapshot
+	* @brief A read-only copy of the data of a Group used to render it while it is updated
+	*
+	* When the snapshots of a Group are enabled (see Group::enableSnapshot(bool)), the data to render are copied in a snapshot
+	* at the end of each update and the snapshot is published at once.
+	* The rendering can then read the snapshot of frame N with Group::acquireSnapshot() while frame N+1 is updated on another thread.<br>
+	* <br>
+	* Only the data read by the Renderer of the Group are copied (see Renderer::getSnapshotChannels() and Renderer::getSnapshotParams()).
+	* The data which were not copied are not available in the snapshot : their arrays are NULL.<br>
+	* <br>
+	* The particles of a snapshot are in the order of the Group at the end of the update. With the SORTING_INDICES mode,
+	* they must be parsed in the order given by getSortedIndices().
+	*
+	* @since 1.06.00
+	*/
+	class SPK_PREFIX GroupSnapshot
+	{
+	friend class Group;
+
+	public :
+
+		/** @brief Constructor of GroupSnapshot */
+		GroupSnapshot();
+
+		/**
+		* @brief Gets the number of the update this snapshot was published by
+		*
+		* The number is incremented by each published snapshot of the Group, starting from 0.
+		* It tells the rendering whether the snapshot changed since the last one it read.
+		*
+		* @return the number of this snapshot
+		*/
+		size_t getNumber() const;
+
+		/**
+		* @brief Gets the number of particles in this snapshot
+		* @return the number of particles in this snapshot
+		*/
+		size_t getNbParticles() const;
+
+		/**
+		* @brief Gets the channels copied in this snapshot
+		* @return the flag of the SnapshotChannel constants copied
+		*/
+		int getChannels() const;
+
+		/**
+		* @brief Gets the parameters copied in this snapshot
+		* @return the flag of the ModelParamFlag constants copied
+		*/
+		int getParams() const;
+
+		/**
+		* @brief Gets the positions of the particles
+		* @return the array of positions or NULL if they were not copied
+		*/
+		const vec3* getPositionArray() const;
+
+		/**
+		* @brief Gets the velocities of the particles
+		* @return the array of velocities or NULL if they were not copied
+		*/
+		const vec3* getVelocityArray() const;
+
+		/**
+		* @brief Gets the values of a parameter of the particles
+		* @param param : the parameter
+		* @return the array of values or NULL if they were not copied
+		*/
+		const float* getParamArray(ModelParam param) const;
+
+		/**
+		* @brief Gets an accessor to the values of a parameter of the particles
+		*
+		* Like Group::getParamAccessor(ModelParam), the default value of the parameter is read if it was not copied.
+		*
+		* @param param : the parameter
+		* @return the accessor to the values of the parameter
+		*/
+		ParamAccessor getParamAccessor(ModelParam param) const;
+
+		/**
+		* @brief Gets the indices of the particles sorted from the furthest to the closest to the camera
+		* @return the sorted indices or NULL if they were not copied
+		*/
+		const unsigned int* getSortedIndices() const;
+
+		/**
+		* @brief Gets the lower bound of the bounding box of the Group
+		* @return the lower bound or a null vector if the bounding box was not copied
+		*/
+		const vec3& getAABBMin() const;
+
+		/**
+		* @brief Gets the upper bound of the bounding box of the Group
+		* @return the upper bound or a null vector if the bounding box was not copied
+		*/
+		const vec3& getAABBMax() const;
+
+	private :
+
+		size_t number;
+		size_t nbParticles;
+		int channels;
+		int params;
+
+		// The vectors keep their capacity so that the copies do not allocate once the Group reached its size
+		std::vector<vec3> positions;
+		std::vector<vec3> velocities;
+		std::vector<float> paramValues[Model::NB_PARAMS];
+		std::vector<unsigned int> sortedIndices;
+		vec3 AABBMin;
+		vec3 AABBMax;
+
+		// Number of readers which acquired this snapshot, the Group only writes it again once it is 0
+		mutable std::atomic<size_t> nbReaders;
+
+		// private copy
+		GroupSnapshot(const GroupSnapshot&);
+		GroupSnapshot& operator=(const GroupSnapshot&);
+	};
+
+
+	inline size_t GroupSnapshot::getNumber() const
+	{
+		return number;
+	}
+
+	inline size_t GroupSnapshot::getNbParticles() const
+	{
+		return nbParticles;
+	}
+
+	inline int GroupSnapshot::getChannels() const
+	{
+		return channels;
+	}
+
+	inline int GroupSnapshot::getParams() const
+	{
+		return params;
+	}
+
+	inline const vec3* GroupSnapshot::getPositionArray() const
+	{
+		return ((channels & SNAPSHOT_POSITIONS) != 0)&&(!positions.empty()) ? &positions[0] : NULL;
+	}
+
+	inline const vec3* GroupSnapshot::getVelocityArray() const
+	{
+		return ((channels & SNAPSHOT_VELOCITIES) != 0)&&(!velocities.empty()) ? &velocities[0] : NULL;
+	}
+
+	inline const float* GroupSnapshot::getParamArray(ModelParam param) const
+	{
+		return ((params & (1 << param)) != 0)&&(!paramValues[param].empty()) ? &paramValues[param][0] : NULL;
+	}
+
+	inline ParamAccessor GroupSnapshot::getParamAccessor(ModelParam param) const
+	{
+		if ((params & (1 << param)) != 0)
+			return ParamAccessor(getParamArray(param),1);
+		else
+			return ParamAccessor(&Model::DEFAULT_VALUES[param],0);
+	}
+
+	inline const unsigned int* GroupSnapshot::getSortedIndices() const
+	{
+		return ((channels & SNAPSHOT_SORTED_INDICES) != 0)&&(!sortedIndices.empty()) ? &sortedIndices[0] : NULL;
+	}
+
+	inline const vec3& GroupSnapshot::getAABBMin() const
+	{
+		return AABBMin;
+	}
+
+	inline const vec3& GroupSnapshot::getAABBMax() const
+	{
+		return AABBMax;
+	}
+}
+
+#endif
@@ -25,6 +25,8 @@
 
 #include "Core/SPK_DEF.h"
 
+#include <atomic>
+
 namespace SPK
 {
 	class Particle;
@@ -112,6 +114,9 @@ namespace SPK
 	* <li>If the graph does not loop, the current x value is clamped between the minimum x and the maximum x of the graph.</li>
 	* <li>If the graph loops, the current x is recomputed to fit in the range between the minimum x and the maximum x of the graph.</li>
 	* </ul>
+	* The graph is only the editing representation. Since 1.06.00, the entries are copied into a contiguous array to be searched,
+	* and the graph can also be baked into a table of regularly spaced samples so that a value is found without any search (see enableBaking(bool,unsigned int)).<br>
+	* <br>
 	* Finally, it is possible to set a variation in the offset and the scale of the current x computed :<br>
 	* Each particle is given an offset and a scale to compute its current x depending on the variations set. The formula to compute the final current x is the following :<br>
 	* <i>final current x = (current x + offset) * scale</i><br>
@@ -131,6 +136,7 @@ namespace SPK
 	{
 	friend class Particle;
 	friend class Model;
+	friend class Group;
 
 	public :
 
@@ -179,6 +185,24 @@ namespace SPK
 		*/
 		void setOffsetXVariation(float offsetXVariation);
 
+		/**
+		* @brief Enables or disables the baking of the graph
+		*
+		* When the baking is enabled, the graph is resampled into a table of regularly spaced samples between its minimum x and its maximum x.
+		* The value at a given x is then directly read from the table and linearly interpolated between the 2 samples around it.<br>
+		* This is faster than searching the graph but the result is an approximation of the graph :
+		* the more samples, the closer it gets, the graphs with entries regularly spaced being exactly reproduced
+		* when the number of intervals between the samples is a multiple of the number of intervals between the entries.<br>
+		* <br>
+		* The looping of the graph is handled in the same way with or without baking.<br>
+		* By default the baking is disabled.
+		*
+		* @param baking : true to enable the baking, false to disable it
+		* @param resolution : the number of samples of the table (at least 2)
+		* @since 1.06.00
+		*/
+		void enableBaking(bool baking,unsigned int resolution = 256);
+
 		/////////////
 		// Getters //
 		/////////////
@@ -216,8 +240,28 @@ namespace SPK
 		*/
 		float getOffsetXVariation() const;
 
+		/**
+		* @brief Tells whether the baking of the graph is enabled or not
+		* @return true if the baking is enabled, false if not
+		* @since 1.06.00
+		*/
+		bool isBakingEnabled() const;
+
+		/**
+		* @brief Gets the number of samples of the table when the baking is enabled
+		* @return the number of samples of the baked table
+		* @since 1.06.00
+		*/
+		unsigned int getBakingResolution() const;
+
 		/**
 		* @brief Gets the graph of the interpolator
+		*
+		* As the graph may be modified through the returned reference, the data used to interpolate is built again at the next interpolation.<br>
+		* Note that the data is only marked as outdated when this method is called :
+		* the reference must not be kept to modify the graph later, getGraph() must be called again for each modification
+		* or the interpolation goes on with the previous graph. The addEntry and clearGraph methods can be used instead.
+		*
 		* @return the graph of the interpolator
 		*/
 		std::set<InterpolatorEntry>& getGraph();
@@ -284,8 +328,24 @@ namespace SPK
 		float scaleXVariation;
 		float offsetXVariation;
 
+		bool bakingEnabled;
+		unsigned int bakingResolution;
+
+		// Data used to interpolate, built from the graph (since 1.06.00)
+		std::vector<InterpolatorEntry> entries; // The entries of the graph in a contiguous array
+		std::vector<InterpolatorEntry> bakedEntries; // The samples of the baked graph
+		float bakedScaleX; // Number of samples per unit along x
+		std::atomic<bool> dataOutdated; // The data is rebuilt before the next interpolation
+
 		float interpolate(const Particle& particle,ModelParam interpolatedParam,float ratioY,float offsetX,float scaleX);
-		float interpolateY(const InterpolatorEntry& entry,float ratio);
+		void interpolate(float* values,const float* xs,const float* ratiosY,const float* offsetsX,const float* scalesX,size_t nb,ModelParam interpolatedParam); // since 1.06.00
+		float loopX(float x) const;
+		float interpolateY(const InterpolatorEntry& entry,float ratio) const;
+		float interpolateEntries(float x,float ratioY) const;
+		float interpolateBakedEntries(float x,float ratioY) const;
+
+		void updateData();
+		void setDataOutdated();
 
 		// methods to compute X
 		typedef float (Interpolator::*computeXFn)(const Particle&) const;
@@ -296,8 +356,9 @@ namespace SPK
 		float computeXParam(const Particle& particle) const;
 		float computeXVelocity(const Particle& particle) const;
 
-		// Only a model can create and destroy an interpolator
+		// Only a model can create, copy and destroy an interpolator
 		Interpolator();
+		Interpolator(const Interpolator& interpolator);
 		~Interpolator() {};
 	};
 
@@ -323,6 +384,13 @@ namespace SPK
 		this->offsetXVariation = offsetXVariation;
 	}
 
+	inline void Interpolator::enableBaking(bool baking,unsigned int resolution)
+	{
+		bakingEnabled = baking;
+		bakingResolution = std::max(2u,resolution);
+		setDataOutdated();
+	}
+
 	inline InterpolationType Interpolator::getType() const
 	{
 		return type;
@@ -348,8 +416,19 @@ namespace SPK
 		return offsetXVariation;
 	}
 
+	inline bool Interpolator::isBakingEnabled() const
+	{
+		return bakingEnabled;
+	}
+
+	inline unsigned int Interpolator::getBakingResolution() const
+	{
+		return bakingResolution;
+	}
+
 	inline std::set<InterpolatorEntry>& Interpolator::getGraph()
 	{
+		setDataOutdated();
 		return graph;
 	}
 
@@ -360,6 +439,7 @@ namespace SPK
 
 	inline bool Interpolator::addEntry(const InterpolatorEntry& entry)
 	{
+		setDataOutdated();
 		return graph.insert(entry).second;
 	}
 
@@ -375,14 +455,20 @@ namespace SPK
 
 	inline void Interpolator::clearGraph()
 	{
+		setDataOutdated();
 		graph.clear();
 	}
 
-	inline float Interpolator::interpolateY(const InterpolatorEntry& entry,float ratio)
+	inline float Interpolator::interpolateY(const InterpolatorEntry& entry,float ratio) const
 	{
 		return entry.y0 + (entry.y1 - entry.y0) * ratio;
 	}
 
+	inline void Interpolator::setDataOutdated()
+	{
+		dataOutdated.store(true,std::memory_order_relaxed);
+	}
+
     /////////////////////////////////////////////////////////////
 	// Functions to sort the entries on the interpolator graph //
 	/////////////////////////////////////////////////////////////
@@ -0,0 +1,379 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef H_SPK_KERNEL
+#define H_SPK_KERNEL
+
+#include "Core/SPK_DEF.h"
+#include "Core/SPK_Vector3D.h"
+#include "Core/SPK_Interpolator.h"
+
+
+namespace SPK
+{
+	class RandomGenerator;
+
+	/**
+	* @enum InstructionSet
+	* @brief Constants for the instruction sets the kernels can run with
+	*
+	* The SIMD instruction sets are only available on x86 processors.
+	* They can be disabled at compile time by defining SPK_NO_SIMD.<br>
+	* <br>
+	* Whatever the instruction set, the kernels give exactly the same results :
+	* they perform the same operations in the same order and their multiplications and additions are never fused in FMA instructions,
+	* even when the library is compiled for a processor having them (-march=native for instance).<br>
+	* Some kernels are said to give the same results as a function of the library which is not a kernel.
+	* This only holds if that function is not compiled with FMA contraction either (-ffp-contract=off with GCC),
+	* otherwise their results only match within rounding.
+	*
+	* @since 1.06.00
+	*/
+	enum InstructionSet
+	{
+		INSTRUCTION_SET_SCALAR = 0,		/**< Plain C++ code without SIMD instructions */
+		INSTRUCTION_SET_SSE2 = 1,		/**< SSE2 instructions (4 floats per register) */
+		INSTRUCTION_SET_AVX2 = 2,		/**< AVX2 instructions (8 floats per register) */
+		INSTRUCTION_SET_AVX512 = 3,		/**< AVX-512 foundation instructions (16 floats per register) */
+	};
+
+	/**
+	* @brief Gets the widest instruction set supported by both the processor and the library
+	*
+	* The processor is queried once when the library is loaded.
+	*
+	* @return the widest supported instruction set
+	* @since 1.06.00
+	*/
+	SPK_PREFIX InstructionSet getSupportedInstructionSet();
+
+	/**
+	* @brief Gets the instruction set used by the kernels
+	*
+	* By default, the kernels use the widest supported instruction set (see getSupportedInstructionSet()).
+	*
+	* @return the instruction set used by the kernels
+	* @since 1.06.00
+	*/
+	SPK_PREFIX InstructionSet getInstructionSet();
+
+	/**
+	* @brief Sets the instruction set used by the kernels
+	*
+	* This is mainly useful to compare the kernels or to force the scalar code.<br>
+	* If the instruction set is not supported, nothing happens and false is returned.<br>
+	* <br>
+	* Note that this method must not be called while a kernel is running.
+	*
+	* @param instructionSet : the instruction set to use
+	* @return true if the instruction set is set, false if it is not supported
+	* @since 1.06.00
+	*/
+	SPK_PREFIX bool setInstructionSet(InstructionSet instructionSet);
+
+	/**
+	* @brief Integrates the motion of an array of particles
+	*
+	* For each Particle, this function performs these operations :<br><i>
+	* oldPosition = position<br>
+	* position += velocity * deltaTime<br>
+	* velocity += gravity * deltaTime</i>
+	*
+	* @param oldPositions : the array of old positions to write
+	* @param positions : the array of positions
+	* @param velocities : the array of velocities
+	* @param nb : the number of particles
+	* @param gravity : the gravity applied to the particles
+	* @param deltaTime : the time step
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void integrateParticles(vec3* oldPositions,vec3* positions,vec3* velocities,size_t nb,const vec3& gravity,float deltaTime);
+
+	/**
+	* @brief Applies a friction to an array of particles
+	*
+	* For each Particle, this function performs this operation :<br>
+	* <i>velocity *= 1 - min(1,friction * deltaTime / mass)</i><br>
+	* <br>
+	* If the array of masses is NULL, the default mass is used for all particles.
+	*
+	* @param velocities : the array of velocities
+	* @param masses : the array of masses or NULL
+	* @param nb : the number of particles
+	* @param friction : the friction coefficient
+	* @param deltaTime : the time step
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void applyFriction(vec3* velocities,const float* masses,size_t nb,float friction,float deltaTime);
+
+	/**
+	* @brief Generates an array of random floats
+	*
+	* The ith float is computed as follows :<br><i>
+	* h = RandomGenerator::hash(key + (counter + i) * RandomGenerator::COUNTER_STEP)<br>
+	* value = min + (h >> 8) / 2^24 * (max - min)</i><br>
+	* <br>
+	* This function is used by RandomGenerator::generate(float*,size_t,float,float).
+	*
+	* @param values : the array to fill
+	* @param nb : the number of floats to generate
+	* @param key : the key of the stream
+	* @param counter : the counter of the first float
+	* @param min : the minimum value
+	* @param max : the maximum value
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void generateRandomValues(float* values,size_t nb,unsigned int key,unsigned int counter,float min,float max);
+
+	/**
+	* @brief Interpolates an array of values on the graph of an Interpolator
+	*
+	* For each value, this function performs these operations :<br><i>
+	* x = (x + offsetX) * scaleX<br>
+	* x is brought back within the range of the graph if looping is enabled<br>
+	* value = the graph at x, with y = y0 + (y1 - y0) * ratioY for each entry</i><br>
+	* <br>
+	* The SIMD kernels parse all the entries of the graph for each block of values, they are therefore only used on graphs of at most 32 entries.
+	* The kernels give the same results as Interpolator.<br>
+	* <br>
+	* The graph must hold at least 2 entries sorted by x. The array of values can be the array of x.
+	*
+	* @param values : the array of values to write
+	* @param xs : the array of x
+	* @param offsetsX : the array of offsets applied to x
+	* @param scalesX : the array of scales applied to x
+	* @param ratiosY : the array of ratios between y0 and y1
+	* @param nb : the number of values
+	* @param entries : the entries of the graph
+	* @param nbEntries : the number of entries
+	* @param looping : true if the graph loops
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void interpolateValues(float* values,const float* xs,const float* offsetsX,const float* scalesX,const float* ratiosY,size_t nb,const InterpolatorEntry* entries,size_t nbEntries,bool looping);
+
+	/**
+	* @brief Tests whether the points of an array are within a sphere
+	*
+	* The ith result is set to 1 if <i>getSqrDist(center,points[i]) <= radius * radius</i>, 0 otherwise.<br>
+	* This function is used by Sphere.
+	*
+	* @param points : the array of points
+	* @param nb : the number of points
+	* @param center : the center of the sphere
+	* @param radius : the radius of the sphere
+	* @param results : the array of results to write
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void testSphereContainment(const vec3* points,size_t nb,const vec3& center,float radius,unsigned char* results);
+
+	/**
+	* @brief Tests whether the points of an array are within a half space
+	*
+	* The ith result is set to 1 if <i>dotProduct(normal,points[i] - position) <= 0</i>, 0 otherwise.<br>
+	* This function is used by Plane and Ring.
+	*
+	* @param points : the array of points
+	* @param nb : the number of points
+	* @param position : a point of the plane bounding the half space
+	* @param normal : the normal of the plane, pointing outside the half space
+	* @param results : the array of results to write
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void testHalfSpaceContainment(const vec3* points,size_t nb,const vec3& position,const vec3& normal,unsigned char* results);
+
+	/**
+	* @brief Tests whether the points of an array are within an axis aligned box
+	*
+	* The ith result is set to 1 if each component of points[i] is between the ones of min and max (included), 0 otherwise.<br>
+	* This function is used by AABox.
+	*
+	* @param points : the array of points
+	* @param nb : the number of points
+	* @param min : the minimum corner of the box
+	* @param max : the maximum corner of the box
+	* @param results : the array of results to write
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void testBoxContainment(const vec3* points,size_t nb,const vec3& min,const vec3& max,unsigned char* results);
+
+	/**
+	* @brief Tests whether the points of an array are within a cylinder
+	*
+	* The kernels give the same results as Cylinder::contains(const vec3&).
+	*
+	* @param points : the array of points
+	* @param nb : the number of points
+	* @param position : the center of the cylinder
+	* @param direction : the normalized direction of the axis of the cylinder
+	* @param length : the length of the cylinder
+	* @param radius : the radius of the cylinder
+	* @param results : the array of results to write
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void testCylinderContainment(const vec3* points,size_t nb,const vec3& position,const vec3& direction,float length,float radius,unsigned char* results);
+
+	/**
+	* @brief Tests whether the segments defined by 2 arrays of points intersect the border of an axis aligned box
+	*
+	* The ith result is set to 1 if the segment [starts[i],ends[i]] crosses the border of the box, 0 otherwise.<br>
+	* The kernels give the same results as AABox::intersects(const vec3&,const vec3&,vec3*,vec3*).
+	*
+	* @param starts : the array of the starts of the segments
+	* @param ends : the array of the ends of the segments
+	* @param nb : the number of segments
+	* @param min : the minimum corner of the box
+	* @param max : the maximum corner of the box
+	* @param results : the array of results to write
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void testBoxIntersection(const vec3* starts,const vec3* ends,size_t nb,const vec3& min,const vec3& max,unsigned char* results);
+
+	/**
+	* @brief Expands an array of particles into quads
+	*
+	* For each Particle, 4 vertices of 10 floats (x,y,z,red,green,blue,alpha,u,v,w) are written in this order :<br><i>
+	* position + side + up with (u1,v0)<br>
+	* position - side + up with (u0,v0)<br>
+	* position - side - up with (u0,v1)<br>
+	* position + side - up with (u1,v1)</i><br>
+	* <br>
+	* This function is used by GeometryBuilder.
+	*
+	* @param vertices : the array of 4 * nb vertices to write
+	* @param positions : the array of positions
+	* @param sides : the array of the half side vectors of the quads
+	* @param ups : the array of the half up vectors of the quads
+	* @param colors : the 4 arrays of red, green, blue and alpha
+	* @param textureCoords : the 5 arrays of u0, u1, v0, v1 and w
+	* @param nb : the number of particles
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void expandQuads(float* vertices,const vec3* positions,const vec3* sides,const vec3* ups,const float* const* colors,const float* const* textureCoords,size_t nb);
+
+	/**
+	* @brief Expands an array of particles into lines
+	*
+	* For each Particle, 2 vertices of 7 floats (x,y,z,red,green,blue,alpha) are written :
+	* the first one at the position and the second one at <i>position + velocity * length</i>.<br>
+	* This function is used by GeometryBuilder.
+	*
+	* @param vertices : the array of 2 * nb vertices to write
+	* @param positions : the array of positions
+	* @param velocities : the array of velocities
+	* @param colors : the 4 arrays of red, green, blue and alpha
+	* @param length : the length multiplier of the velocities
+	* @param nb : the number of particles
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void expandLines(float* vertices,const vec3* positions,const vec3* velocities,const float* const* colors,float length,size_t nb);
+
+	/**
+	* @brief Packs an array of particles into points
+	*
+	* For each Particle, a vertex of 8 floats (x,y,z,red,green,blue,alpha,size) is written.<br>
+	* This function is used by GeometryBuilder.
+	*
+	* @param vertices : the array of nb vertices to write
+	* @param positions : the array of positions
+	* @param colors : the 4 arrays of red, green, blue and alpha
+	* @param sizes : the array of sizes
+	* @param nb : the number of particles
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void packPoints(float* vertices,const vec3* positions,const float* const* colors,const float* sizes,size_t nb);
+
+	/**
+	* @brief Converts an array of floats to half floats
+	*
+	* The floats are rounded to the nearest half float (ties to even).
+	* The floats too large for a half float give an infinity and NaN gives a NaN.<br>
+	* This function is used by InstanceExporter.
+	*
+	* @param halves : the array of the bits of the half floats to write
+	* @param values : the array of floats
+	* @param nb : the number of floats
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void convertToHalfFloats(unsigned short* halves,const float* values,size_t nb);
+
+	/**
+	* @brief Quantizes an array of colors on 8 bits per component
+	*
+	* For each color, 4 bytes are written in the order red, green, blue and alpha.
+	* Each byte is computed as follows :<br>
+	* <i>byte = (int)(clamp(component,0,1) * 255 + 0.5)</i><br>
+	* <br>
+	* This function is used by InstanceExporter.
+	*
+	* @param colors : the array of 4 * nb bytes to write
+	* @param components : the 4 arrays of red, green, blue and alpha
+	* @param nb : the number of colors
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void quantizeColors(unsigned char* colors,const float* const* components,size_t nb);
+
+	/**
+	* @brief Quantizes an array of angles on 16 bits
+	*
+	* A turn is divided in 65536 steps : each angle in radians is rounded to the nearest step and wrapped within [0,65536[.<br>
+	* The angles are expected within about 103000 radians from 0 (2^30 steps) : the ones beyond are clamped before being wrapped.<br>
+	* Note that the angle is scaled to steps in a float, whose 24 bits of mantissa cannot hold every step beyond 2^24 steps :
+	* past about 1600 radians from 0, the quantized angles are coarser than one step.<br>
+	* <br>
+	* This function is used by InstanceExporter.
+	*
+	* @param angles : the array of quantized angles to write
+	* @param values : the array of angles in radians
+	* @param nb : the number of angles
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void quantizeAngles(unsigned short* angles,const float* values,size_t nb);
+
+	/**
+	* @brief Quantizes an array of indices on 8 bits
+	*
+	* Each index is clamped within [0,255] and truncated, the same way as a texture index is truncated to select a tile of an atlas.<br>
+	* This function is used by InstanceExporter.
+	*
+	* @param indices : the array of quantized indices to write
+	* @param values : the array of indices
+	* @param nb : the number of indices
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void quantizeIndices(unsigned char* indices,const float* values,size_t nb);
+
+	/**
+	* @brief Generates an array of random directions
+	*
+	* The directions are unit vectors uniformly distributed on the sphere.
+	* They are computed without rejection from a random z coordinate and a random angle around the z axis,
+	* both drawn in blocks with RandomGenerator::generate(float*,size_t,float,float).
+	*
+	* @param directions : the array of directions to fill
+	* @param nb : the number of directions
+	* @param randomGenerator : the RandomGenerator to draw the numbers from
+	* @since 1.06.00
+	*/
+	SPK_PREFIX void generateDirections(vec3* directions,size_t nb,RandomGenerator& randomGenerator);
+}
+
+#endif
@@ -30,6 +30,9 @@
 
 namespace SPK
 {
+	class Particle;
+	class Group;
+
 	/**
 	* @enum ModelParamFlag
 	* @brief Constants used to set bits in Model flags
@@ -76,6 +79,9 @@ namespace SPK
 	* </ul>
 	* The life time of a particle and immortality is also defined by the Model.<br>
 	* <br>
+	* Since 1.06.00, the most common combinations of flags initialize and update the parameters with code specialized at compile time,
+	* without testing the flags of each parameter. The other combinations use the generic code.<br>
+	* <br>
 	* The default values for the parameters are the following :
 	* <ul>
 	* <li>PARAM_RED : 1.0</li>
@@ -95,6 +101,8 @@ namespace SPK
 	class SPK_PREFIX Model : public Registerable
 	{
 	friend class Particle;
+	friend class Group;
+	friend class GroupSnapshot;
 
 		SPK_IMPLEMENT_REGISTERABLE(Model)	
 	
@@ -219,6 +227,26 @@ namespace SPK
 		*/
 		bool setParam(ModelParam type,float value);
 
+		/**
+		* @brief Bakes a pool of templates from which the parameters of the particles are initialized
+		*
+		* Initializing the parameters of a Particle draws random numbers for each random parameter and 3 for each interpolated one.
+		* When templates are baked, the parameters of nbTemplates particles are generated once
+		* and a new Particle only copies the parameters of one of them.<br>
+		* The life time is still drawn for each Particle so that the particles initialized from the same template do not die together.<br>
+		* This flattens the cost of the bursts, such as explosions or impacts, which launch the whole tank of an Emitter in a single update.<br>
+		* <br>
+		* The parameters only take nbTemplates different values so the pool must be large enough not to make the repetitions visible.
+		* The templates are baked again when a parameter is set but not when an Interpolator of the Model is modified :
+		* in that case this method must be called again.<br>
+		* <br>
+		* Passing 0 disables the templates, which is the default.
+		*
+		* @param nbTemplates : the number of templates to bake
+		* @since 1.06.00
+		*/
+		void bakeInitTemplates(size_t nbTemplates);
+
 		/////////////
 		// Getters //
 		/////////////
@@ -365,6 +393,16 @@ namespace SPK
 		*/
 		size_t getNbInterpolated() const;
 
+		/**
+		* @brief Gets the number of templates from which the parameters of the particles are initialized
+		*
+		* For more information see bakeInitTemplates(size_t).
+		*
+		* @return the number of templates, 0 if they are disabled
+		* @since 1.06.00
+		*/
+		size_t getNbInitTemplates() const;
+
 		/**
 		* @brief Gets the number of float values in the particle current array
 		*
@@ -464,6 +502,14 @@ namespace SPK
 		float lifeTimeMax;
 		bool immortal;
 
+		// Kernels initializing and updating the parameters, specialized for the flags when possible (since 1.06.00)
+		void (*initKernel)(const Model&,Particle&);
+		void (*updateKernel)(Group&,size_t,size_t,float);
+
+		// Templates of the parameters of the particles stored as the parameters of nbInitTemplates particles (since 1.06.00)
+		float* initTemplates;
+		size_t nbInitTemplates;
+
 		void initParamArrays(const Model& model);
 	};
 
@@ -546,6 +592,11 @@ namespace SPK
 		return nbInterpolatedParams;
 	}
 
+	inline size_t Model::getNbInitTemplates() const
+	{
+		return nbInitTemplates;
+	}
+
 	inline size_t Model::getSizeOfParticleCurrentArray() const
 	{
 		return nbEnableParams;
@@ -33,6 +33,7 @@
 
 namespace SPK
 {
+	class Group;
 	class ModifierGroup;
 
 	/**
@@ -49,6 +50,20 @@ namespace SPK
 		EXIT_ZONE = 1 << 5,			/**< Trigger defining a Particle exiting the Zone */
 	};
 
+	/**
+	* @brief The Zone against which a Modifier processes a Particle
+	*
+	* A ModifierGroup used as a global group passes its own Zone to its children in this structure
+	* instead of setting it to them, so that no shared state is changed while a Particle is processed.
+	*
+	* @since 1.06.00
+	*/
+	struct ModifierContext
+	{
+		Zone* zone;	/**< @brief the Zone to use in place of the Zone of the Modifier */
+		bool full;	/**< @brief true if this Zone is considered as a full object (see Modifier::isFullZone()) */
+	};
+
 	/**
 	* @class Modifier
 	* @brief A abstract class that defines a physical object acting on particles
@@ -138,6 +153,42 @@ namespace SPK
 		*/
 		void setLocalToSystem(bool local);
 
+		/**
+		* @brief Enables or disables the containment cache of this Modifier
+		*
+		* With the triggers ENTER_ZONE and EXIT_ZONE, the Zone is tested twice per Particle and per frame :
+		* once to know on which side of the Zone the old position lies and once to check the intersection.<br>
+		* When the cache is enabled, the side of each Particle is remembered in a Buffer of the Group, with a single bit per Particle.
+		* A Particle which does not cross the Zone is then tested only once per frame.<br>
+		* <br>
+		* The side is known only for particles which neither crossed the Zone nor were on its wrong side on the previous frame.
+		* The others are tested as usual.<br>
+		* The cache assumes that a line whose ends are on both sides of the Zone intersects it (this is the case of the spheres, planes and boxes)
+		* and that particles are not moved after this Modifier has processed them (by a following Modifier or by the user between two updates).<br>
+		* <br>
+		* The sides are kept from a frame to the next one, so they are only valid as long as the Zone does not change.
+		* They are invalidated when the Zone is set (see setZone(Zone*,bool)) or when its position or its world transform changes.
+		* Any other change of the Zone, its dimensions or its orientation for instance, is not detected :
+		* invalidateContainmentCache() must then be called.<br>
+		* <br>
+		* The cache is only used when this Modifier is updated directly by a Group and its buffers are ready (see BufferHandler).<br>
+		* By default, the cache is disabled.
+		*
+		* @param cache : true to enable the containment cache, false to disable it
+		* @since 1.06.00
+		*/
+		void enableContainmentCache(bool cache);
+
+		/**
+		* @brief Invalidates the sides of the particles kept by the containment cache
+		*
+		* The particles are tested again against the Zone on the next update.
+		* This must be called when the Zone is changed in a way the cache does not detect (see enableContainmentCache(bool)).
+		*
+		* @since 1.06.00
+		*/
+		void invalidateContainmentCache();
+
 		/////////////
 		// Getters //
 		/////////////
@@ -183,19 +234,63 @@ namespace SPK
 		*/
 		bool isLocalToSystem() const;
 
+		/**
+		* @brief Tells whether the containment cache of this Modifier is enabled or not
+		* @return true if the containment cache is enabled, false if not
+		* @since 1.06.00
+		*/
+		bool isContainmentCacheEnabled() const;
+
+		/**
+		* @brief Tells whether this Modifier can process several ranges of particles of a Group at the same time
+		*
+		* A thread safe Modifier only reads and writes the particles of the range it processes and does not change its own state during the processing.<br>
+		* When a Group holds a Modifier which is not thread safe, its update is not parallelized (see Group::enableParallelUpdate(bool)).<br>
+		* <br>
+		* By default a Modifier is not thread safe, so that the modifiers written before the parallel update are never run concurrently.
+		* Children that meet the requirements can override this method to return true.
+		*
+		* @return true if this Modifier is thread safe, false if not
+		* @since 1.06.00
+		*/
+		virtual bool isThreadSafe() const;
+
+		/**
+		* @brief Tells whether this Modifier must process all the particles of a Group in a single range
+		*
+		* When an active Modifier of a Group needs the whole range, the Group passes all its particles at once
+		* to modifyBatch(Group&,size_t,size_t,float) instead of splitting them in chunks.<br>
+		* <br>
+		* By default false is returned.
+		*
+		* @return true if this Modifier needs the whole range of particles, false if not
+		* @since 1.06.00
+		*/
+		virtual bool needsWholeRange() const;
+
+		/**
+		* @brief Gets the modifiers which process particles when this Modifier processes particles
+		*
+		* This Modifier and the modifiers it holds, if any, are added to the vector.
+		* A System uses them to know whether its Groups share modifiers (see System::enableParallelUpdate(bool)).<br>
+		* <br>
+		* By default only this Modifier is added. Children holding other modifiers must override this method.
+		*
+		* @param modifiers : the vector to which the modifiers are added
+		* @since 1.06.00
+		*/
+		virtual void getProcessingModifiers(std::vector<const Modifier*>& modifiers) const;
+
 		///////////////
 		// Interface //
 		///////////////
 
 		virtual Registerable* findByName(const std::string& name);
 
-	protected :
-
-		/** @brief the vec3 that holds the intersection coordinates */
-		static vec3 intersection;
+		virtual void createBuffers(const Group& group);
+		virtual void destroyBuffers(const Group& group);
 
-		/** @brief the vec3 that holds the intersection coordinates */
-		static vec3 normal;
+	protected :
 
 		/** @brief true if the Modifier needs the intersection computation, false if not */
 		bool needsIntersection;
@@ -215,20 +310,117 @@ namespace SPK
 
 		virtual void propagateUpdateTransform();
 
+		virtual bool checkBuffers(const Group& group);
+
+		/**
+		* @brief Modifies a range of particles of a Group
+		*
+		* This method is called by the Group during its update, once per active Modifier for each range of particles.<br>
+		* The default implementation tests the trigger for each Particle of the range and calls modify(Particle&,float) when triggered.
+		* Children can override it to process the whole range at once, typically by parsing the arrays of the Group
+		* (see Group::getPositionArray() for instance).<br>
+		* <br>
+		* An implementation must give the same result as processing the particles of the range one after the other.
+		*
+		* @param group : the Group whose particles are modified
+		* @param begin : the index of the first Particle of the range
+		* @param end : the index following the last Particle of the range
+		* @param deltaTime : the time step
+		* @since 1.06.00
+		*/
+		virtual void modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const;
+
+		/**
+		* @brief Prepares the processing of the particles of a Group
+		*
+		* This method is called once per update of a Group, before its particles are modified, if this Modifier is active.<br>
+		* By default it does nothing. Children can override it to set up the data they need for the frame.
+		*
+		* @param group : the Group whose particles are about to be modified
+		* @since 1.06.00
+		*/
+		virtual void prepareProcess(Group& group) {}
+
+		/**
+		* @brief Tests whether a Particle triggers this Modifier
+		*
+		* If the Particle is on the wrong side of the Zone, modifyWrongSide(Particle&,bool) is called and false is returned.<br>
+		* When the trigger needs it, the intersection and the normal are computed in the given structure.
+		*
+		* @param particle : the Particle to test
+		* @param intersection : the structure in which to write the intersection and the normal
+		* @return true if the Particle has to be modified, false otherwise
+		* @since 1.06.00
+		*/
+		bool checkTrigger(Particle& particle,ZoneIntersection& intersection) const;
+
+		/**
+		* @brief Tests whether the particles of a range trigger this Modifier
+		*
+		* This gives the same results as checkTrigger(Particle&,ZoneIntersection&) for each Particle of the range
+		* but the Zone is tested for all the particles at once (see Zone::containsBatch(const vec3*,size_t,unsigned char*)).<br>
+		* modifyWrongSide(Particle&,bool) is called for the particles on the wrong side of the Zone.<br>
+		* <br>
+		* The intersections and the normals are not computed. Children which need them must use checkTrigger(Particle&,ZoneIntersection&).
+		*
+		* @param group : the Group whose particles are tested
+		* @param begin : the index of the first Particle of the range
+		* @param end : the index following the last Particle of the range
+		* @param triggers : the array of end - begin results to write, 1 for particles triggering this Modifier and 0 for the others
+		* @since 1.06.00
+		*/
+		void checkTriggers(Group& group,size_t begin,size_t end,unsigned char* triggers) const;
+
+		/**
+		* @brief Tells whether any Particle triggers this Modifier without testing its Zone
+		*
+		* This is the case when the trigger is ALWAYS or when the trigger is INSIDE_ZONE with no Zone.
+		*
+		* @return true if all particles trigger this Modifier, false otherwise
+		* @since 1.06.00
+		*/
+		bool isAlwaysTriggered() const;
+
+		/**
+		* @brief Tells whether this Modifier may move particles away from their paths
+		*
+		* The path of a Particle is the line between its old position and its position.
+		* A Group stops culling its modifiers after the first one which may move particles away from their paths (see Group::enableModifierCulling(bool)).<br>
+		* <br>
+		* By default true is returned if the particles on the wrong side of a full Zone are handled (see isFullZone()),
+		* as they are moved at the border of the Zone. Children which move particles in another way must override this method.
+		*
+		* @return true if this Modifier may move particles away from their paths, false otherwise
+		* @since 1.06.00
+		*/
+		virtual bool movesParticlesAway() const;
+
 	private :
 
+		class ContainmentBuffer;
+		class ContainmentBufferCreator;
+
 		Zone* zone;
 		bool full;
 
 		bool active;
 		mutable bool savedActive;
+		ModifierTrigger savedTrigger; // (since 1.06.00)
 
 		bool local;
 
+		bool containmentCacheEnabled; // (since 1.06.00)
+		ContainmentBuffer* containmentBuffer; // the containment buffer of the Group being updated (since 1.06.00)
+		unsigned int containmentCacheVersion; // incremented to invalidate the containment buffers of all the groups (since 1.06.00)
+
 		void beginProcess(Group& group);
 		void endProcess(Group& group);
+		bool cullProcess(const vec3& reachMin,const vec3& reachMax);
 		void process(Particle& particle,float deltaTime) const;
 
+		std::string getContainmentBufferID() const;
+		bool checkCachedTrigger(Particle& particle,ZoneIntersection& intersection) const;
+
 		//////////////////////////
 		// Pure virtual methods //
 		//////////////////////////
@@ -244,6 +436,35 @@ namespace SPK
 		*/
 		virtual void modify(Particle& particle,float deltaTime) const = 0;
 
+		/**
+		* @brief Modifies a Particle which triggered this Modifier
+		*
+		* This method is called when the trigger of this Modifier has been tested on the Particle,
+		* with the intersection and the normal computed by the test if this Modifier needs them.<br>
+		* By default it calls modify(Particle&,float). Children which use the intersection or the normal override it.
+		*
+		* @param particle : the Particle that has to be modified
+		* @param deltaTime : the time step
+		* @param intersection : the intersection and the normal computed by the test of the trigger
+		* @since 1.06.00
+		*/
+		virtual void modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection) const;
+
+		/**
+		* @brief Modifies a Particle against another Zone than the Zone of this Modifier
+		*
+		* This method is called by a ModifierGroup used as a global group once its own trigger has been tested on the Particle.<br>
+		* By default it calls modify(Particle&,float,const ZoneIntersection&). Children which use their Zone to modify a Particle override it
+		* to use the Zone of the context instead.
+		*
+		* @param particle : the Particle that has to be modified
+		* @param deltaTime : the time step
+		* @param intersection : the intersection and the normal computed by the test of the trigger
+		* @param context : the Zone to use
+		* @since 1.06.00
+		*/
+		virtual void modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection,const ModifierContext& context) const;
+
 		/**
 		* @brief A pure virtual method that handles particles on the wrong side of this Modifier Zone.
 		*
@@ -257,6 +478,19 @@ namespace SPK
 		* @param inside : true if the wrong side is inside, false if it is oustside
 		*/
 		virtual void modifyWrongSide(Particle& particle,bool inside) const {}
+
+		/**
+		* @brief Handles particles on the wrong side of another Zone than the Zone of this Modifier
+		*
+		* This is the equivalent of modify(Particle&,float,const ZoneIntersection&,const ModifierContext&) for the wrong side.<br>
+		* By default it calls modifyWrongSide(Particle&,bool).
+		*
+		* @param particle : the Particle which is on the wrong side
+		* @param inside : true if the wrong side is inside, false if it is oustside
+		* @param context : the Zone to use
+		* @since 1.06.00
+		*/
+		virtual void modifyWrongSide(Particle& particle,bool inside,const ModifierContext& context) const;
 	};
 
 
@@ -270,6 +504,16 @@ namespace SPK
 		this->local = local;
 	}
 
+	inline void Modifier::enableContainmentCache(bool cache)
+	{
+		containmentCacheEnabled = cache;
+	}
+
+	inline void Modifier::invalidateContainmentCache()
+	{
+		++containmentCacheVersion;
+	}
+
 	inline bool Modifier::isActive() const
 	{
 		return active;
@@ -300,6 +544,26 @@ namespace SPK
 		return local;
 	}
 
+	inline bool Modifier::isContainmentCacheEnabled() const
+	{
+		return containmentCacheEnabled;
+	}
+
+	inline bool Modifier::isThreadSafe() const
+	{
+		return false;
+	}
+
+	inline bool Modifier::needsWholeRange() const
+	{
+		return false;
+	}
+
+	inline void Modifier::getProcessingModifiers(std::vector<const Modifier*>& modifiers) const
+	{
+		modifiers.push_back(this);
+	}
+
 	inline void Modifier::propagateUpdateTransform()
 	{
 		if (zone != NULL)
@@ -309,66 +573,103 @@ namespace SPK
 	inline void Modifier::endProcess(Group& group)
 	{
 		active = savedActive; // Restores the active state of the modifier
+		trigger = savedTrigger;
+		containmentBuffer = NULL;
 	}
 
-	inline void Modifier::process(Particle& particle,float deltaTime) const
+	inline bool Modifier::isAlwaysTriggered() const
+	{
+		return (trigger == ALWAYS)||((trigger == INSIDE_ZONE)&&(zone == NULL));
+	}
+
+	inline bool Modifier::movesParticlesAway() const
+	{
+		return (full)&&(zone != NULL)&&(trigger != ALWAYS)&&(trigger != INTERSECT_ZONE);
+	}
+
+	inline bool Modifier::checkTrigger(Particle& particle,ZoneIntersection& intersection) const
 	{
 		switch(trigger)
 		{
 		case ALWAYS :
-			modify(particle,deltaTime);
-			break;
+			return true;
 
 		case INSIDE_ZONE :
 			if ((zone == NULL)||(zone->contains(particle.position())))
-				modify(particle,deltaTime);
-			else
-				modifyWrongSide(particle,true);
-			break;
+				return true;
+			modifyWrongSide(particle,true);
+			return false;
 
 		case OUTSIDE_ZONE :
 			if (zone == NULL)
-				return;
+				return false;
 			if (!zone->contains(particle.position()))
-				modify(particle,deltaTime);
-			else
-				modifyWrongSide(particle,false);
-			break;
+				return true;
+			modifyWrongSide(particle,false);
+			return false;
 
 		case INTERSECT_ZONE :
 			if (zone == NULL)
-				return;
-			if (zone->intersects(particle.oldPosition(),
+				return false;
+			return zone->intersects(particle.oldPosition(),
 				particle.position(),
-				needsIntersection ? &intersection : NULL,
-				needsNormal ? &normal : NULL))
-				modify(particle,deltaTime);
-			break;
+				needsIntersection ? &intersection.position : NULL,
+				needsNormal ? &intersection.normal : NULL);
 
 		case ENTER_ZONE :
 			if (zone == NULL)
-				return;
+				return false;
+			if (containmentBuffer != NULL)
+				return checkCachedTrigger(particle,intersection);
 			if (zone->contains(particle.oldPosition()))
+			{
 				modifyWrongSide(particle,true);
-			else if (zone->intersects(particle.oldPosition(),
+				return false;
+			}
+			return zone->intersects(particle.oldPosition(),
 				particle.position(),
-				needsIntersection ? &intersection : NULL,
-				needsNormal ? &normal : NULL))
-				modify(particle,deltaTime);
-			break;
+				needsIntersection ? &intersection.position : NULL,
+				needsNormal ? &intersection.normal : NULL);
 
 		case EXIT_ZONE :
 			if (zone == NULL)
-				return;
+				return false;
+			if (containmentBuffer != NULL)
+				return checkCachedTrigger(particle,intersection);
 			if (!zone->contains(particle.oldPosition()))
+			{
 				modifyWrongSide(particle,false);
-			else if (zone->intersects(particle.oldPosition(),
+				return false;
+			}
+			return zone->intersects(particle.oldPosition(),
 				particle.position(),
-				needsIntersection ? &intersection : NULL,
-				needsNormal ? &normal : NULL))
-				modify(particle,deltaTime);
-			break;
+				needsIntersection ? &intersection.position : NULL,
+				needsNormal ? &intersection.normal : NULL);
 		}
+
+		return false;
+	}
+
+	inline void Modifier::process(Particle& particle,float deltaTime) const
+	{
+		ZoneIntersection intersection;
+		if (checkTrigger(particle,intersection))
+			modify(particle,deltaTime,intersection);
+	}
+
+	inline void Modifier::modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection) const
+	{
+		modify(particle,deltaTime);
+	}
+
+	inline void Modifier::modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection,const ModifierContext& context) const
+	{
+		modify(particle,deltaTime,intersection);
+	}
+
+	inline void Modifier::modifyWrongSide(Particle& particle,bool inside,const ModifierContext& context) const
+	{
+		modifyWrongSide(particle,inside);
 	}
 }
 
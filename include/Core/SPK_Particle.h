@@ -27,6 +27,7 @@
 #include "Core/SPK_Vector3D.h"
 #include "Core/SPK_Pool.h"
 #include "Core/SPK_Model.h"
+#include "Core/SPK_RandomGenerator.h"
 
 
 namespace SPK
@@ -43,12 +44,16 @@ namespace SPK
 	* <br>
 	* Note that the Particle class is only a class that presents an interface to the user (since 1.02.00), particles data are stored in the groups.
 	* This is why copying a Particle will not copy its data.<br>
+	* <br>
+	* Since 1.06.00, the groups store the data of their particles as a structure of arrays (one array per attribute)
+	* and a Particle is only a view made of a pointer to those arrays and an index.<br>
 	*/
 	class SPK_PREFIX Particle
 	{
 	friend bool isFurtherToCamera(const Particle&,const Particle&);
 	friend void swapParticles(Particle& a,Particle& b);
 	friend class Group;
+	friend class Model;
 	friend class Pool<Particle>;
 
 
@@ -211,6 +216,17 @@ namespace SPK
 		*/
 		size_t getIndex() const;
 
+		/**
+		* @brief Gets the RandomGenerator of the Group of this Particle
+		*
+		* The random numbers used to generate this Particle (by its Model, the Zone and the Emitter that generate it) must be drawn from this RandomGenerator.
+		* This way, each Group has its own stream of random numbers (see Group::getRandomGenerator()).
+		*
+		* @return the RandomGenerator of the Group of this Particle
+		* @since 1.06.00
+		*/
+		RandomGenerator& getRandomGenerator() const;
+
 		/**
 		* @brief Gets the amount of life left of the Particle
 		*
@@ -280,7 +296,8 @@ namespace SPK
 		/**
 		* @brief Initializes the Particle
 		*
-		* When a Particle is initialized, all its parameters are reinitialized as well as its life.
+		* When a Particle is initialized, all its parameters are reinitialized as well as its life.<br>
+		* Since 1.06.00, the parameters are copied from a template of the Model when it has some (see Model::bakeInitTemplates(size_t)).
 		*/
 		void init();
 
@@ -294,41 +311,67 @@ namespace SPK
 		void kill();
 
 		// As we know the color component are always enabled, we optimizes it a bit for access
-		float getR() const { return currentParams[PARAM_RED]; }
-		float getG() const { return currentParams[PARAM_GREEN]; }
-		float getB() const { return currentParams[PARAM_BLUE]; }
+		float getR() const { return data->currentParams[PARAM_RED * data->pitch + index]; }
+		float getG() const { return data->currentParams[PARAM_GREEN * data->pitch + index]; }
+		float getB() const { return data->currentParams[PARAM_BLUE * data->pitch + index]; }
 
 	private :
 
+		// Particles data of a Group stored as a structure of arrays (since 1.06.00)
+		// Each array is aligned on DATA_ALIGNMENT and holds pitch elements
 		struct ParticleData
 		{
-			vec3 oldPosition;
-			vec3 position;
-			vec3 velocity;
-			float age;
-			float life;
-			float sqrDist;
+			Group* group;
+			RandomGenerator* randomGenerator;
+			size_t pitch;
+
+			vec3* oldPositions;
+			vec3* positions;
+			vec3* velocities;
+			float* ages;
+			float* lives;
+			float* sqrDists;
+
+			float* currentParams; // one array per enabled parameter
+			float* extendedParams; // one array per mutable parameter followed by 3 arrays per interpolated parameter
 		};
 
-		Group* group;
-		size_t index;
-
 		ParticleData* data;
-		float* currentParams;
-		float* extendedParams;
+		size_t index;
 
-		Particle(Group* group,size_t index);
+		Particle(Group* group,size_t index); // the data of the particle are not initialized (since 1.06.00)
+		Particle(ParticleData* data,size_t index); // (since 1.06.00)
 
-		bool update(float timeDelta);
+		void update(float timeDelta);
 		void computeSqrDist();
 
+		void initParameters(const Model& model);
+		void copyTemplate(const Model& model,size_t templateIndex);
 		void interpolateParameters();
+
+		// Kernels initializing and updating the parameters (since 1.06.00)
+		// The layout kernels are instantiated for the most common flags of models, the generic ones handle all the others
+		template<int ENABLE,int MUTABLE,int RANDOM,int INTERPOLATED> static void initLayout(const Model& model,Particle& particle);
+		template<int ENABLE,int MUTABLE,int RANDOM,int INTERPOLATED> static void updateLayout(Group& group,size_t begin,size_t end,float deltaTime);
+		static void initGeneric(const Model& model,Particle& particle);
+		static void updateGeneric(Group& group,size_t begin,size_t end,float deltaTime);
+		static void selectKernels(Model& model);
+
+		// Initializes a range of particles of a group, from the templates of its model when it has some (since 1.06.00)
+		static void initParticles(Group& group,size_t begin,size_t end);
+		// Generates the parameters of the templates of a model (since 1.06.00)
+		static void bakeTemplates(Model& model,RandomGenerator& randomGenerator);
+
+		float& currentParam(size_t enableIndex);
+		float& extendedParam(size_t extendedIndex);
+		const float& currentParam(size_t enableIndex) const;
+		const float& extendedParam(size_t extendedIndex) const;
 	};
 
 
 	inline Group* Particle::getGroup() const
 	{
-		return group;
+		return data->group;
 	}
 
 	inline size_t Particle::getIndex() const
@@ -336,74 +379,99 @@ namespace SPK
 		return index;
 	}
 
+	inline RandomGenerator& Particle::getRandomGenerator() const
+	{
+		return *data->randomGenerator;
+	}
+
 	inline void Particle::setLifeLeft(float life)
 	{
-		data->life = life;
+		data->lives[index] = life;
 	}
 
 	inline vec3& Particle::position()
 	{
-		return data->position;
+		return data->positions[index];
 	}
 
 	inline vec3& Particle::velocity()
 	{
-		return data->velocity;
+		return data->velocities[index];
 	}
 
 	inline vec3& Particle::oldPosition()
 	{
-		return data->oldPosition;
+		return data->oldPositions[index];
 	}
 
 	inline const vec3& Particle::position() const
 	{
-		return data->position;
+		return data->positions[index];
 	}
 
 	inline const vec3& Particle::velocity() const
 	{
-		return data->velocity;
+		return data->velocities[index];
 	}
 
 	inline const vec3& Particle::oldPosition() const
 	{
-		return data->oldPosition;
+		return data->oldPositions[index];
 	}
 
 	inline float Particle::getLifeLeft() const
 	{
-		return data->life;
+		return data->lives[index];
 	}
 
 	inline float Particle::getAge() const
 	{
-		return data->age;
+		return data->ages[index];
 	}
 
 	inline float Particle::getDistanceFromCamera() const
 	{
-		return std::sqrt(data->sqrDist);
+		return std::sqrt(data->sqrDists[index]);
 	}
 
 	inline float Particle::getSqrDistanceFromCamera() const
 	{
-		return data->sqrDist;
+		return data->sqrDists[index];
 	}
 
 	inline bool Particle::isNewBorn() const
 	{
-		return data->age == 0.0f;
+		return data->ages[index] == 0.0f;
 	}
 
 	inline bool Particle::isAlive() const
 	{
-		return data->life > 0.0f;
+		return data->lives[index] > 0.0f;
 	}
 
 	inline void Particle::kill()
 	{
-		data->life = 0.0f;
+		data->lives[index] = 0.0f;
+	}
+
+	inline float& Particle::currentParam(size_t enableIndex)
+	{
+		return data->currentParams[enableIndex * data->pitch + index];
+	}
+
+	inline float& Particle::extendedParam(size_t extendedIndex)
+	{
+		return data->extendedParams[extendedIndex * data->pitch + index];
+	}
+
+	inline const float& Particle::currentParam(size_t enableIndex) const
+	{
+		return data->currentParams[enableIndex * data->pitch + index];
+	}
+
+	inline const float& Particle::extendedParam(size_t extendedIndex) const
+	{
+		return data->extendedParams[extendedIndex * data->pitch + index];
 	}
 
 	// specialization of the swap for particle
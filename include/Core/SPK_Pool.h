@@ -554,6 +554,18 @@ namespace SPK
 		/** @brief Inactivates all the elements */
 		void makeAllInactive();
 
+		/**
+		* @brief Inactivates the last active elements
+		*
+		* The active elements from the index nbActive are inactivated without being moved.
+		* This allows to inactivate many elements at once once the elements to keep were moved at the beginning of the Pool.<br>
+		* If nbActive is not lower than the number of active elements, nothing will happen.
+		*
+		* @param nbActive : the number of elements to keep active
+		* @since 1.06.00
+		*/
+		void truncateActive(size_t nbActive);
+
 		/**
 		* @brief Activates the first inactive element
 		*
@@ -972,6 +984,13 @@ namespace SPK
 		nbActive = 0;
 	}
 
+	template<class T>
+	inline void Pool<T>::truncateActive(size_t nbActive)
+	{
+		if (nbActive < this->nbActive)
+			this->nbActive = nbActive;
+	}
+
 	template<class T>
 	T* Pool<T>::makeActive()
 	{
@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef H_SPK_RANDOMGENERATOR
+#define H_SPK_RANDOMGENERATOR
+
+#include "Core/SPK_DEF.h"
+
+
+namespace SPK
+{
+	/**
+	* @class RandomGenerator
+	* @brief A stream of pseudo random numbers
+	*
+	* The numbers are generated by hashing a counter with a key derived from the seed.
+	* The nth number of a stream only depends on the seed and on n, which allows to generate many numbers at once with SIMD instructions
+	* (see generate(float*,size_t,float,float)).<br>
+	* <br>
+	* Unlike the global random(T,T) function, a RandomGenerator is an independent stream :
+	* each Group owns a RandomGenerator from which the Particles are generated (see Group::getRandomGenerator()),
+	* so that the Groups can be updated in parallel and give the same results whatever the order of their updates.<br>
+	* <br>
+	* A RandomGenerator is not thread safe. It must not be used by several threads at the same time.
+	*
+	* @since 1.06.00
+	*/
+	class SPK_PREFIX RandomGenerator
+	{
+	public :
+
+		/** @brief The step between the hashed counters of 2 consecutive numbers (2^32 divided by the golden ratio) */
+		static const unsigned int COUNTER_STEP = 0x9E3779B9;
+
+		/**
+		* @brief Constructor of RandomGenerator
+		* @param seed : the seed of the stream
+		*/
+		RandomGenerator(unsigned int seed = 1);
+
+		/**
+		* @brief Sets the seed of this RandomGenerator
+		*
+		* The stream restarts from its beginning.
+		*
+		* @param seed : the seed of the stream
+		*/
+		void setSeed(unsigned int seed);
+
+		/**
+		* @brief Returns a random number in the range [min,max[
+		* @param min : the minimum value
+		* @param max : the maximum value
+		* @return a random number within [min,max[
+		*/
+		template<typename T>
+		T random(T min,T max);
+
+		/**
+		* @brief Fills an array with random floats in the range [min,max[
+		*
+		* The array is filled with the next nb numbers of the stream, using the instruction set of the kernels (see setInstructionSet(InstructionSet)).<br>
+		* This is faster than calling random(T,T) nb times but the numbers are not exactly the same :
+		* only the 24 upper bits of each number of the stream are kept (the precision of a float), whereas random(T,T) uses its 32 bits.
+		* The values are therefore spaced by (max - min) / 2^24 and may differ from the ones of random(T,T) in their last bits.
+		*
+		* @param values : the array to fill
+		* @param nb : the number of floats to generate
+		* @param min : the minimum value
+		* @param max : the maximum value
+		*/
+		void generate(float* values,size_t nb,float min,float max);
+
+		/**
+		* @brief Hashes a 32 bits integer
+		*
+		* This is the function used to generate the numbers of the streams.
+		*
+		* @param x : the integer to hash
+		* @return the hashed integer
+		*/
+		static unsigned int hash(unsigned int x);
+
+	private :
+
+		unsigned int key;
+		unsigned int counter;
+
+		unsigned int next();
+	};
+
+	/**
+	* @brief Gets the RandomGenerator of the calling thread
+	*
+	* This stream is used when random numbers are needed outside of the generation of a Particle,
+	* while the particles may be updated in parallel (see Zone::normalizeOrRandomize(vec3&) for instance).<br>
+	* The stream of each thread is given a distinct seed. While a Group is updated, it is reseeded before the modifiers process each chunk of particles,
+	* so that the numbers they draw only depend on the Group and on the chunk (see Group::getRandomGenerator()).
+	*
+	* @return the RandomGenerator of the calling thread
+	* @since 1.06.00
+	*/
+	SPK_PREFIX RandomGenerator& getThreadRandomGenerator();
+
+
+	inline RandomGenerator::RandomGenerator(unsigned int seed)
+	{
+		setSeed(seed);
+	}
+
+	inline void RandomGenerator::setSeed(unsigned int seed)
+	{
+		key = hash(seed);
+		counter = 0;
+	}
+
+	template<typename T>
+	inline T RandomGenerator::random(T min,T max)
+	{
+		return static_cast<T>(min + (next() / 4294967296.0) * (max - min));
+	}
+
+	inline unsigned int RandomGenerator::hash(unsigned int x)
+	{
+		// finalizer of MurmurHash3
+		x ^= x >> 16;
+		x *= 0x85EBCA6B;
+		x ^= x >> 13;
+		x *= 0xC2B2AE35;
+		x ^= x >> 16;
+		return x;
+	}
+
+	inline unsigned int RandomGenerator::next()
+	{
+		unsigned int value = hash(key + counter * COUNTER_STEP);
+
+		// a new key is derived each time the counter wraps around
+		if (++counter == 0)
+			key = hash(key + COUNTER_STEP);
+
+		return value;
+	}
+}
+
+#endif
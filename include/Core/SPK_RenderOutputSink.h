@@ -0,0 +1,348 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef H_SPK_RENDEROUTPUTSINK
+#define H_SPK_RENDEROUTPUTSINK
+
+#include "Core/SPK_DEF.h"
+
+#include <atomic>
+
+
+namespace SPK
+{
+	class Group;
+
+	/**
+	* @class RenderOutputSink
+	* @brief An abstract class receiving the output of a Group in a ring of memory regions given by the user
+	*
+	* A sink decouples the writing of the data to render from the rendering itself :
+	* when a Group holding a sink is rendered (see Group::setOutputSink(RenderOutputSink*)), it writes its output (geometry, instances...)
+	* in the next free region of the sink. The consumer, typically a renderer on another thread, then acquires the latest output, draws it
+	* and releases the region. The regions can be persistently mapped buffers of the rendering API or plain memory.<br>
+	* <br>
+	* Neither side ever blocks :
+	* <ul>
+	* <li>The producer writes in a free region. If there is none, it overwrites the oldest output the consumer has not acquired yet.
+	* If all the regions are being read, the output is dropped and write(const Group&) returns false.</li>
+	* <li>The consumer acquires the most recent output with acquireOutput() and the older outputs it did not acquire are dropped.</li>
+	* </ul>
+	* With 3 regions, the producer can therefore always write while the consumer reads a region and another one is still used by the GPU.<br>
+	* <br>
+	* As the GPU may still read a region after the consumer has released it, a fence callback can be set (see setFenceCallback(FenceCallback,void*)) :
+	* a released region is only reused once the callback tells that its fence is signaled.<br>
+	* <br>
+	* The states of the regions are changed with atomic operations only and the output is written by the producer without any lock.
+	* A sink has a single producer and a single consumer, which can use it at the same time :
+	* a sink can only be set to one Group at a time (see Group::setOutputSink(RenderOutputSink*)).
+	* As the outputs are then written one after the other, the consumer always acquires them in the order they were written.
+	* Several groups rendered on several threads must each have their own sink.<br>
+	* <br>
+	* The regions and the fence callback must be set while the sink is not used.<br>
+	* <br>
+	* The output itself is written by the subclasses in writeOutput(const Group&,void*,size_t,size_t&).
+	*
+	* @since 1.06.00
+	*/
+	class SPK_PREFIX RenderOutputSink
+	{
+	friend class Group;
+
+	public :
+
+		/**
+		* @brief A function telling whether the GPU is done with a region
+		*
+		* The function is called by the producer with the index of a region released by the consumer and the data given with the callback.
+		* It must not block : for instance it queries the status of a Vulkan fence or waits for an OpenGL sync object with a timeout of 0.
+		*
+		* @param region : the index of the region
+		* @param data : the data given with the callback
+		* @return true if the fence of the region is signaled and the region can be written again, false otherwise
+		*/
+		typedef bool (*FenceCallback)(size_t region,void* data);
+
+		/** @brief The index returned when there is no region */
+		static const size_t NO_REGION = static_cast<size_t>(-1);
+
+		//////////////////
+		// Constructors //
+		//////////////////
+
+		/**
+		* @brief Constructor of RenderOutputSink
+		*
+		* The regions have no memory until it is set with setRegion(size_t,void*,size_t).
+		*
+		* @param nbRegions : the number of regions of the ring
+		*/
+		RenderOutputSink(size_t nbRegions);
+
+		/** @brief Destructor of RenderOutputSink */
+		virtual ~RenderOutputSink();
+
+		/////////////
+		// Setters //
+		/////////////
+
+		/**
+		* @brief Sets the memory of a region
+		*
+		* The memory is not owned by the sink. A region without memory is never written.<br>
+		* The output previously written in the region is dropped.
+		*
+		* @param index : the index of the region
+		* @param memory : the memory of the region
+		* @param size : the size of the memory in bytes
+		*/
+		void setRegion(size_t index,void* memory,size_t size);
+
+		/**
+		* @brief Sets the fence callback
+		*
+		* If the callback is NULL, a region is reused as soon as the consumer releases it.
+		* By default, there is no callback.
+		*
+		* @param callback : the fence callback or NULL
+		* @param data : the data given to the callback
+		*/
+		void setFenceCallback(FenceCallback callback,void* data = NULL);
+
+		/////////////
+		// Getters //
+		/////////////
+
+		/**
+		* @brief Gets the number of regions
+		* @return the number of regions of the ring
+		*/
+		size_t getNbRegions() const;
+
+		/**
+		* @brief Gets the memory of a region
+		* @param index : the index of the region
+		* @return the memory of the region
+		*/
+		void* getRegionMemory(size_t index) const;
+
+		/**
+		* @brief Gets the size of a region
+		* @param index : the index of the region
+		* @return the size of the memory of the region in bytes
+		*/
+		size_t getRegionSize(size_t index) const;
+
+		/**
+		* @brief Gets the number of particles of the output held by a region
+		*
+		* The output must have been acquired with acquireOutput().
+		*
+		* @param index : the index of the region
+		* @return the number of particles written in the region
+		*/
+		size_t getNbParticles(size_t index) const;
+
+		/**
+		* @brief Gets the number of bytes of the output held by a region
+		*
+		* The output must have been acquired with acquireOutput().
+		*
+		* @param index : the index of the region
+		* @return the number of bytes written in the region
+		*/
+		size_t getNbBytes(size_t index) const;
+
+		/**
+		* @brief Gets the number of outputs dropped because all the regions were being read
+		* @return the number of outputs dropped
+		*/
+		size_t getNbDroppedOutputs() const;
+
+		/**
+		* @brief Gets the Group writing its output in this sink
+		* @return the Group this sink is set to or NULL if it is set to no Group
+		*/
+		const Group* getProducer() const;
+
+		///////////////
+		// Interface //
+		///////////////
+
+		/**
+		* @brief Writes the output of a Group in the next free region
+		*
+		* This method is called by Group::render() and never blocks.<br>
+		* It must only be called by one thread at a time.
+		* If the sink is set to a Group, the output of any other Group is not written and false is returned.
+		*
+		* @param group : the Group whose output is written
+		* @return true if the output is written, false if it is dropped
+		*/
+		bool write(const Group& group);
+
+		/**
+		* @brief Acquires the most recent output
+		*
+		* The region holding the output is not written until it is released with releaseOutput(size_t).
+		* The outputs older than the acquired one are dropped.
+		*
+		* @return the index of the region holding the output or NO_REGION if no output was written since the last one acquired
+		*/
+		size_t acquireOutput();
+
+		/**
+		* @brief Releases an output acquired with acquireOutput()
+		*
+		* If a fence callback is set, the region is reused once its fence is signaled.
+		*
+		* @param index : the index of the region holding the output
+		*/
+		void releaseOutput(size_t index);
+
+	protected :
+
+		/**
+		* @brief Writes the output of a Group in the memory of a region
+		*
+		* This method is called by write(const Group&), only by one thread at a time.
+		*
+		* @param group : the Group whose output is written
+		* @param memory : the memory of the region
+		* @param size : the size of the memory in bytes
+		* @param nbBytes : the number of bytes written
+		* @return the number of particles written
+		*/
+		virtual size_t writeOutput(const Group& group,void* memory,size_t size,size_t& nbBytes) = 0;
+
+	private :
+
+		// The state of a region is stored with the sequence number of its output in a single atomic word,
+		// so that an output can never be mistaken for another one written in the same region
+		enum RegionState
+		{
+			REGION_FREE,
+			REGION_WRITING,
+			REGION_READY,
+			REGION_READING,
+			REGION_FENCED,
+		};
+
+		static const size_t STATE_BITS = 3;
+		static const size_t STATE_MASK = (1 << STATE_BITS) - 1;
+
+		struct Region
+		{
+			void* memory;
+			size_t size;
+			size_t nbParticles;
+			size_t nbBytes;
+			std::atomic<size_t> state;
+		};
+
+		Region* regions;
+		size_t nbRegions;
+
+		FenceCallback fenceCallback;
+		void* fenceData;
+
+		// Only the producer writes the outputs, so their sequence numbers are the order they are published in
+		const Group* producer;
+		size_t nextSequence;
+		size_t nextRegion;
+		std::atomic<size_t> nbDroppedOutputs;
+
+		static size_t getState(size_t word);
+		static size_t getWord(size_t sequence,size_t state);
+		static size_t changeState(size_t word,size_t state);
+		static bool isOlder(size_t word0,size_t word1);
+
+		// Gets a region to write and sets it to REGION_WRITING
+		size_t acquireRegion(size_t sequence);
+
+		// Frees the released regions whose fence is signaled
+		void recycleRegions();
+
+		// private copy
+		RenderOutputSink(const RenderOutputSink&);
+		RenderOutputSink& operator=(const RenderOutputSink&);
+	};
+
+
+	inline size_t RenderOutputSink::getNbRegions() const
+	{
+		return nbRegions;
+	}
+
+	inline void* RenderOutputSink::getRegionMemory(size_t index) const
+	{
+		return regions[index].memory;
+	}
+
+	inline size_t RenderOutputSink::getRegionSize(size_t index) const
+	{
+		return regions[index].size;
+	}
+
+	inline size_t RenderOutputSink::getNbParticles(size_t index) const
+	{
+		return regions[index].nbParticles;
+	}
+
+	inline size_t RenderOutputSink::getNbBytes(size_t index) const
+	{
+		return regions[index].nbBytes;
+	}
+
+	inline size_t RenderOutputSink::getNbDroppedOutputs() const
+	{
+		return nbDroppedOutputs;
+	}
+
+	inline const Group* RenderOutputSink::getProducer() const
+	{
+		return producer;
+	}
+
+	inline size_t RenderOutputSink::getState(size_t word)
+	{
+		return word & STATE_MASK;
+	}
+
+	inline size_t RenderOutputSink::getWord(size_t sequence,size_t state)
+	{
+		return (sequence << STATE_BITS) | state;
+	}
+
+	inline size_t RenderOutputSink::changeState(size_t word,size_t state)
+	{
+		return (word & ~STATE_MASK) | state;
+	}
+
+	inline bool RenderOutputSink::isOlder(size_t word0,size_t word1)
+	{
+		// the difference handles the wrapping of the sequence numbers
+		return static_cast<ptrdiff_t>((word0 & ~STATE_MASK) - (word1 & ~STATE_MASK)) < 0;
+	}
+}
+
+#endif
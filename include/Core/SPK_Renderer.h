@@ -174,6 +174,28 @@ namespace SPK
 		*/
 		virtual void render(const Group& group) = 0;
 
+		/**
+		* @brief Gets the data of a Group read by this Renderer
+		*
+		* When the snapshots of a Group are enabled (see Group::enableSnapshot(bool)), only the data read by its Renderer are copied in them.<br>
+		* By default, the positions, the sorted indices and the bounding box are read.
+		*
+		* @return the flag of the SnapshotChannel constants read by this Renderer
+		* @since 1.06.00
+		*/
+		virtual int getSnapshotChannels() const;
+
+		/**
+		* @brief Gets the parameters of the particles read by this Renderer
+		*
+		* When the snapshots of a Group are enabled (see Group::enableSnapshot(bool)), only the parameters read by its Renderer are copied in them.<br>
+		* By default, the color, the size, the angle and the texture index are read.
+		*
+		* @return the flag of the ModelParamFlag constants read by this Renderer
+		* @since 1.06.00
+		*/
+		virtual int getSnapshotParams() const;
+
 	private :
 
 		bool active;
@@ -172,6 +172,27 @@ namespace SPK
 		*/
 		void enableAABBComputing(bool AABB);
 
+		/**
+		* @brief Enables or disables the parallel update of the Groups of this System
+		*
+		* When the parallel update is enabled, the update of each Group is a task run on the worker threads of the ThreadPool.
+		* The number of particles and the AABB of the System are computed once all the Groups are updated.<br>
+		* <br>
+		* The Groups are updated one after the other when several of them share a Group, an Emitter or a Modifier
+		* (including the modifiers held by other modifiers, see Modifier::getProcessingModifiers(std::vector<const Modifier*>&)),
+		* as those objects are modified by the update.<br>
+		* Note that the custom functions of the Groups (see Group::setCustomUpdate(bool (*)(Particle&,float)) for instance)
+		* are then called from the worker threads and must be thread safe.<br>
+		* As each Group generates its particles from its own stream of random numbers (see Group::getRandomGenerator()),
+		* the results are the same whether the parallel update is enabled or not.<br>
+		* <br>
+		* This is independent of the parallel update of the particles within a Group (see Group::enableParallelUpdate(bool)). By default it is disabled.
+		*
+		* @param parallel : true to enable the parallel update, false to disable it
+		* @since 1.06.00
+		*/
+		void enableParallelUpdate(bool parallel);
+
 		/////////////
 		// Getters //
 		/////////////
@@ -254,6 +275,16 @@ namespace SPK
 		*/
 		bool isAABBComputingEnabled() const;
 
+		/**
+		* @brief Tells whether the parallel update of the Groups is enabled
+		*
+		* For a description of the parallel update, see enableParallelUpdate(bool).
+		*
+		* @return true if the parallel update is enabled, false if it is disabled
+		* @since 1.06.00
+		*/
+		bool isParallelUpdateEnabled() const;
+
 		/**
 		* @brief Gets a vec3 holding the minimum coordinates of the AABB of this System.
 		*
@@ -394,6 +425,14 @@ namespace SPK
 		static bool clampStepEnabled;
 		static float clampStep;
 
+		struct UpdateTaskData
+		{
+			System* system;
+			float deltaTime;
+		};
+
+		static void updateGroupTask(void* data,size_t index);
+
 		float deltaStep;
 
 		size_t nbParticles;
@@ -402,7 +441,11 @@ namespace SPK
 		vec3 AABBMin;
 		vec3 AABBMax;
 
+		bool parallelUpdateEnabled;
+		std::vector<unsigned char> aliveGroups; // Results of the update of each Group when updated in parallel
+
 		bool innerUpdate(float deltaTime);
+		bool canUpdateGroupsInParallel() const;
 	};
 
 
@@ -418,6 +461,11 @@ namespace SPK
 		boundingBoxEnabled = AABB;
 	}
 
+	inline void System::enableParallelUpdate(bool parallel)
+	{
+		parallelUpdateEnabled = parallel;
+	}
+
 	inline size_t System::getNbParticles() const
 	{
 		return nbParticles;
@@ -443,6 +491,11 @@ namespace SPK
 		return boundingBoxEnabled;
 	}
 
+	inline bool System::isParallelUpdateEnabled() const
+	{
+		return parallelUpdateEnabled;
+	}
+
 	inline const vec3& System::getAABBMin() const
 	{
 		return AABBMin;
@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef H_SPK_THREADPOOL
+#define H_SPK_THREADPOOL
+
+#include "Core/SPK_DEF.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace SPK
+{
+	/**
+	* @class ThreadPool
+	* @brief A pool of worker threads used to run the parallel parts of the update
+	*
+	* The ThreadPool runs a batch of tasks on its workers and on the calling thread and returns when all the tasks are done.<br>
+	* Batches can be nested : a task can itself run a batch, the calling thread then helps processing it instead of waiting.<br>
+	* <br>
+	* The workers are created at the first call to run(Task,void*,size_t).
+	* By default, there is one worker less than the number of hardware threads, as the calling thread also processes tasks.<br>
+	* <br>
+	* There is a unique instance of the ThreadPool which can be gotten with getInstance().
+	*
+	* @since 1.06.00
+	*/
+	class SPK_PREFIX ThreadPool
+	{
+	public :
+
+		/**
+		* @brief The function type of the tasks
+		*
+		* The first argument is the data passed to run(Task,void*,size_t) and the second one is the index of the task in its batch.
+		*/
+		typedef void (*Task)(void* data,size_t index);
+
+		/**
+		* @brief Returns the unique instance of the ThreadPool
+		* @return the unique instance of the ThreadPool
+		*/
+		static ThreadPool& getInstance();
+
+		/**
+		* @brief Destroys the unique instance of the ThreadPool
+		*
+		* The workers are stopped and joined. This must not be called while a batch is running.
+		*/
+		static void destroyInstance();
+
+		/**
+		* @brief Sets the number of worker threads
+		*
+		* The existing workers are stopped and the new ones are created at the next call to run(Task,void*,size_t).<br>
+		* Setting 0 worker makes the calling thread process all the tasks.<br>
+		* This must not be called while a batch is running.
+		*
+		* @param nbWorkers : the number of worker threads
+		*/
+		void setNbWorkers(size_t nbWorkers);
+
+		/**
+		* @brief Gets the number of worker threads
+		* @return the number of worker threads
+		*/
+		size_t getNbWorkers() const;
+
+		/**
+		* @brief Runs a batch of tasks
+		*
+		* The task is called once for each index in [0,nbTasks[, in any order and from any thread.<br>
+		* The method returns when all the tasks are done.
+		*
+		* @param task : the function to call for each task
+		* @param data : the data passed to the task
+		* @param nbTasks : the number of tasks of the batch
+		*/
+		void run(Task task,void* data,size_t nbTasks);
+
+	private :
+
+		struct Batch
+		{
+			Task task;
+			void* data;
+			size_t nbTasks;
+			size_t nextTask;
+			size_t nbDone;
+		};
+
+		static ThreadPool* instance;
+
+		size_t nbWorkers;
+		std::vector<std::thread> workers;
+		bool stopping;
+
+		std::mutex mutex;
+		std::condition_variable taskCondition;
+		std::condition_variable doneCondition;
+		std::deque<Batch*> batches; // Batches that still have tasks to start
+
+		void startWorkers();
+		void stopWorkers();
+		void work();
+
+		// Starts the next task of the batch or removes the batch if all its tasks are started. The lock must be held
+		bool processTask(Batch& batch,std::unique_lock<std::mutex>& lock);
+
+		// private constructors
+		ThreadPool();
+		ThreadPool(const ThreadPool&);
+		~ThreadPool();
+	};
+
+
+	inline size_t ThreadPool::getNbWorkers() const
+	{
+		return nbWorkers;
+	}
+}
+
+#endif
@@ -27,11 +27,27 @@
 #include "Core/SPK_Registerable.h"
 #include "Core/SPK_Transformable.h"
 #include "Core/SPK_Vector3D.h"
+#include "Core/SPK_RandomGenerator.h"
 
 
 namespace SPK
 {
     class Particle;
+	class Group;
+
+	/**
+	* @brief The intersection of a line with a Zone
+	*
+	* This structure holds the result of the test of a Modifier trigger on a Particle (see Modifier::checkTrigger(Particle&,ZoneIntersection&)).
+	* Each test writes its own structure so that several particles can be tested at the same time.
+	*
+	* @since 1.06.00
+	*/
+	struct ZoneIntersection
+	{
+		vec3 position;	/**< @brief the point where the line intersects the Zone */
+		vec3 normal;	/**< @brief the normal of the Zone at the intersection point */
+	};
 
 	/**
 	* @class Zone
@@ -47,6 +63,15 @@ namespace SPK
 	{
 	public :
 
+		/**
+		* @brief The number of points tested at once by the batch methods that need a temporary array
+		*
+		* This is also the size of the blocks in which the modifiers test their zone.
+		*
+		* @since 1.06.00
+		*/
+		static const size_t BATCH_SIZE = 256;
+
 		/////////////////
 		// Constructor //
 		/////////////////
@@ -102,6 +127,21 @@ namespace SPK
 		*/
 		virtual void generatePosition(Particle& particle,bool full) const = 0;
 
+		/**
+		* @brief Randomly generates the positions of a range of particles of a Group
+		*
+		* This is used to launch many particles at once (see Emitter::emitBatch(Group&,size_t,size_t)).<br>
+		* The default implementation calls generatePosition(Particle&,bool) for each Particle of the range.
+		* The zones of SPARK override it to draw the random numbers of the whole range at once from the RandomGenerator of the Group.
+		*
+		* @param group : the Group whose particles positions will be generated
+		* @param begin : the index of the first Particle of the range
+		* @param end : the index following the last Particle of the range
+		* @param full : true to generate the positions in the whole volume of this Zone, false to generate them only at borders
+		* @since 1.06.00
+		*/
+		virtual void generatePositions(Group& group,size_t begin,size_t end,bool full) const;
+
 		/**
 		* @brief Checks whether a point is within the Zone
 		* @param point : the point to check
@@ -123,6 +163,51 @@ namespace SPK
 		*/
 		virtual bool intersects(const vec3& v0,const vec3& v1,vec3* intersection,vec3* normal) const = 0;
 
+		/**
+		* @brief Checks whether the points of an array are within the Zone
+		*
+		* The ith result is set to 1 if <i>contains(points[i])</i> is true, 0 otherwise.<br>
+		* The default implementation calls contains(const vec3&) for each point.
+		* The zones of SPARK override it to test several points at once with SIMD instructions (see getInstructionSet()).
+		*
+		* @param points : the array of points to check
+		* @param nb : the number of points
+		* @param results : the array of nb results to write
+		* @since 1.06.00
+		*/
+		virtual void containsBatch(const vec3* points,size_t nb,unsigned char* results) const;
+
+		/**
+		* @brief Checks whether the lines defined by 2 arrays of points intersect the Zone
+		*
+		* The ith result is set to 1 if <i>intersects(starts[i],ends[i],NULL,NULL)</i> is true, 0 otherwise.<br>
+		* The default implementation calls intersects(const vec3&,const vec3&,vec3*,vec3*) for each line.
+		* The zones of SPARK override it to test several lines at once with SIMD instructions (see getInstructionSet()).
+		*
+		* @param starts : the array of the starts of the lines
+		* @param ends : the array of the ends of the lines
+		* @param nb : the number of lines
+		* @param results : the array of nb results to write
+		* @since 1.06.00
+		*/
+		virtual void intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const;
+
+		/**
+		* @brief Gets the axis aligned bounding box of this Zone
+		*
+		* The box is expressed with the transformed coordinates of this Zone and is conservative :
+		* no point out of the box is within this Zone and no line out of the box intersects it.<br>
+		* It is used by a Group to cull the modifiers whose Zone is out of reach of its particles (see Group::enableModifierCulling(bool)).<br>
+		* <br>
+		* By default false is returned, which means that the Zone is not bounded (like a Plane).
+		*
+		* @param AABBMin : the vec3 where to write the minimum coordinates of the box
+		* @param AABBMax : the vec3 where to write the maximum coordinates of the box
+		* @return true if the box is written, false if this Zone is not bounded
+		* @since 1.06.00
+		*/
+		virtual bool getAABB(vec3& AABBMin,vec3& AABBMax) const;
+
 		/**
 		* @brief Moves a point at the border of the Zone
 		* @param point : the point that will be moved to the border of the Zone
@@ -143,17 +228,45 @@ namespace SPK
 		/** @brief Value used for approximation */
 		static const float APPROXIMATION_VALUE;
 
+		/** @brief The value of pi (since 1.06.00) */
+		static const float PI;
+
+		/**
+		* @brief A helper static method to compute an orthonormal basis of the plane orthogonal to a direction
+		*
+		* The basis is computed without branching on the direction (method of Duff et al.) so that it is stable for any direction.
+		*
+		* @param direction : the normalized direction
+		* @param u : the vec3 where to write the first vector of the basis
+		* @param v : the vec3 where to write the second vector of the basis
+		* @since 1.06.00
+		*/
+		static void computeBasis(const vec3& direction,vec3& u,vec3& v);
 		/**
 		* @brief A helper static method to normalize a vec3
 		*
 		* If the vec3 is NULL, a random normal vec3 is set.<br>
 		* The randomness is guaranteed to be uniformely distributed.
 		*
+		* The random numbers are drawn from the RandomGenerator of the calling thread (see getThreadRandomGenerator()).
+		*
 		* @param v : the vec3 to normalize or randomize if not normalizable
 		* @since 1.03.00
 		*/
 		static void normalizeOrRandomize(vec3& v);
 
+		/**
+		* @brief A helper static method to normalize a vec3
+		*
+		* This is the same as normalizeOrRandomize(vec3&) except that the random numbers are drawn from the given RandomGenerator.
+		* It should be used when generating a Particle, with the RandomGenerator of the Particle (see Particle::getRandomGenerator()).
+		*
+		* @param v : the vec3 to normalize or randomize if not normalizable
+		* @param randomGenerator : the RandomGenerator to use
+		* @since 1.06.00
+		*/
+		static void normalizeOrRandomize(vec3& v,RandomGenerator& randomGenerator);
+
 		virtual void innerUpdateTransform();
 
 	private :
@@ -180,13 +293,28 @@ namespace SPK
 	}
 
 	inline void Zone::normalizeOrRandomize(vec3& v)
+	{
+		normalizeOrRandomize(v,getThreadRandomGenerator());
+	}
+
+	inline void Zone::normalizeOrRandomize(vec3& v,RandomGenerator& randomGenerator)
 	{
 //		while(!v.normalize())
 		while(glm::length2(v) == 0.0)
 		{
-			do v = vec3(random(-1.0f,1.0f),random(-1.0f,1.0f),random(-1.0f,1.0f));
+			do v = vec3(randomGenerator.random(-1.0f,1.0f),randomGenerator.random(-1.0f,1.0f),randomGenerator.random(-1.0f,1.0f));
 			while (glm::length2(v) > 1.0f);
 		}
+		v = glm::normalize(v);
+	}
+
+	inline void Zone::computeBasis(const vec3& direction,vec3& u,vec3& v)
+	{
+		float sign = direction.z >= 0.0f ? 1.0f : -1.0f;
+		float a = -1.0f / (sign + direction.z);
+		float b = direction.x * direction.y * a;
+		u = vec3(1.0f + sign * direction.x * direction.x * a,sign * b,-sign * direction.x);
+		v = vec3(b,sign + direction.y * direction.y * a,-direction.y);
 	}
 
 	inline void Zone::innerUpdateTransform()
@@ -49,6 +49,7 @@ namespace SPK
 	private :
 
 		virtual void generateVelocity(Particle& particle,float speed) const;
+		virtual void generateVelocities(Group& group,size_t begin,size_t end,const float* speeds) const;
 	};
 
 
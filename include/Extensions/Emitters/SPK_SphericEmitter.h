@@ -149,6 +149,7 @@ namespace SPK
 		void computeMatrix();
 
 		virtual void generateVelocity(Particle& particle,float speed) const;
+		virtual void generateVelocities(Group& group,size_t begin,size_t end,const float* speeds) const;
 	};
 
 
@@ -96,6 +96,7 @@ namespace SPK
 		vec3 tDirection;
 
 		virtual void generateVelocity(Particle& particle,float speed) const;
+		virtual void generateVelocities(Group& group,size_t begin,size_t end,const float* speeds) const;
 	};
 
 
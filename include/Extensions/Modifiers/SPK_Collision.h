@@ -25,6 +25,7 @@
 
 #include "Core/SPK_Modifier.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
 
 namespace SPK
 {
@@ -46,9 +47,16 @@ namespace SPK
 	* <li>An elasticity inferior to 0.0f has no sens and cannot be set</li>
 	* <li>To simulate collisions the elasticity will generally be set between ]0.0f,1.0f[ depending on the material of the particle</li>
 	* </ul>
-	* Note that collision particle vs particles requires intensive processing.
-	* Moreover the algorithm has a complexity that badly scales which means processing times increase fastly as particles count increase.<br>
-	* Tries to limitate the number of particles to perform collision on. More than 1000 particles can require a lot of processing time even of recent hardware.<br>
+	* Note that collision particle vs particles requires intensive processing.<br>
+	* Since 1.06.00, the particles are placed in a spatial hash whose cells are as large as the largest particle,
+	* so that a particle is only tested against the particles of the neighbouring cells.
+	* The processing time therefore grows linearly with the number of particles as long as they do not pile up in a few cells.<br>
+	* The results are the same as when testing each particle against all the previous ones as long as the other modifiers of the Group
+	* only move the particles of the range they process : this is the case of all the modifiers of SPARK except Collision itself.
+	* Therefore several Collision modifiers set to the same Group may give slightly different results.<br>
+	* The narrow phase can also be run in parallel (see enableParallelNarrowPhase(bool)).<br>
+	* <br>
+	* Note that when a Collision is held by a ModifierGroup using its global Zone, every particle is tested against all the others.<br>
 	* <br>
 	* The accuracy of the collisions is better with small update steps.
 	* Therefore try to keep the update time small by for instance multiplying the number of updates per frame.
@@ -104,6 +112,23 @@ namespace SPK
 		*/
 		void setElasticity(float elasticity);
 
+		/**
+		* @brief Enables or disables the parallel narrow phase
+		*
+		* By default, the particles are processed one after the other in the order of the Group, with the same results as the brute force algorithm (see the class description).<br>
+		* When the parallel narrow phase is enabled, the cells of the spatial hash are split into 27 sets
+		* so that the cells of a set are at least 3 cells apart from each other.
+		* The sets are processed one after the other and the cells of a set are processed in parallel on the ThreadPool.<br>
+		* <br>
+		* The collisions are then resolved in a different order than with the sequential processing but the results are deterministic :
+		* they do not depend on the number of threads.<br>
+		* Note that all the particles of the Group are processed at once (see Modifier::needsWholeRange()).
+		*
+		* @param parallel : true to enable the parallel narrow phase, false to disable it
+		* @since 1.06.00
+		*/
+		void enableParallelNarrowPhase(bool parallel);
+
 		/////////////
 		// Getters //
 		/////////////
@@ -120,13 +145,114 @@ namespace SPK
 		*/
 		float getScale() const;
 
+		/**
+		* @brief Tells whether the parallel narrow phase is enabled
+		*
+		* See enableParallelNarrowPhase(bool) for more information.
+		*
+		* @return true if the parallel narrow phase is enabled, false if not
+		* @since 1.06.00
+		*/
+		bool isParallelNarrowPhaseEnabled() const;
+
+		///////////////
+		// Interface //
+		///////////////
+
+		/**
+		* @brief Tells whether this Collision can process several ranges of particles of a Group at the same time
+		*
+		* A Collision is never thread safe as it modifies the particles of the whole Group.
+		*
+		* @return false
+		* @since 1.06.00
+		*/
+		virtual bool isThreadSafe() const;
+
+		/**
+		* @brief Tells whether this Collision needs all the particles of a Group at once
+		*
+		* This is the case when the parallel narrow phase is enabled.
+		*
+		* @return true if the parallel narrow phase is enabled, false if not
+		* @since 1.06.00
+		*/
+		virtual bool needsWholeRange() const;
+
+	protected :
+
+		virtual void prepareProcess(Group& group);
+		virtual void modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const;
+
 	private :
 
+		// A particle in a cell of the spatial hash (used by the parallel narrow phase)
+		struct CellEntry
+		{
+			int x,y,z;
+			unsigned int index;
+
+			bool operator<(const CellEntry& entry) const;
+		};
+
+		// A cell of the spatial hash (used by the parallel narrow phase)
+		struct Cell
+		{
+			int x,y,z;
+			size_t begin; // first entry of the cell
+			size_t end; // entry following the last one of the cell
+
+			bool operator<(const Cell& cell) const;
+		};
+
+		struct CellTaskData
+		{
+			const Collision* collision;
+			Group* group;
+			const unsigned int* cellIndices;
+			size_t nbCells;
+		};
+
+		static const unsigned int NO_PARTICLE = 0xFFFFFFFF;
+		static const size_t CELLS_PER_TASK = 32; // Number of cells processed by a task of the parallel narrow phase
+
 		float elasticity;
 		float scale;
+		bool parallelNarrowPhaseEnabled;
+
+		// broad phase (since 1.06.00)
+		const Group* preparedGroup; // Group the spatial hash is prepared for
+		mutable float cellSize;
+		mutable size_t nbInsertedParticles; // Particles before this index are in the spatial hash
+		mutable size_t nbSyncedParticles; // Particles before this index are in the bucket of their position at the beginning of the range
+		mutable std::vector<unsigned int> buckets; // First particle of each bucket of the spatial hash
+		mutable std::vector<unsigned int> nextParticles; // Next particle in the bucket of each particle
+		mutable std::vector<unsigned int> particleBuckets; // Bucket of each particle
+		mutable std::vector<unsigned int> largeParticles; // Particles too large for the cells
+		mutable std::vector<unsigned int> visitedBuckets;
+		mutable std::vector<unsigned int> candidates;
+
+		mutable std::vector<CellEntry> cellEntries;
+		mutable std::vector<Cell> cells;
+		mutable std::vector<unsigned int> coloredCells; // Indices of the cells sorted by set
 
 		virtual void modify(Particle& particle,float deltaTime) const;
 
+		bool resolveCollision(Particle& particle,Particle& particle2,float radius1,float radius2,const ParamAccessor& masses) const;
+		float getRadius(const ParamAccessor& sizes,size_t index) const;
+		void updateCellSize(const Group& group) const;
+
+		void findCandidates(Group& group,size_t index,float radius) const;
+		void insertParticle(size_t index,const vec3& position,float radius) const;
+		void moveParticle(size_t index,const vec3& position) const;
+		unsigned int getBucket(int x,int y,int z) const;
+		int getCellCoordinate(float coordinate) const;
+		static size_t getCellSet(const Cell& cell);
+
+		void modifyCells(Group& group) const;
+		void modifyCell(Group& group,const Cell& cell,std::vector<unsigned int>& cellCandidates) const;
+		static void modifyCellsTask(void* data,size_t index);
+
 		static void getMinMax(const vec3& v0,const vec3& v1,vec3& min,vec3& max);
 		static bool checkBoundingRect(const vec3& min1,const vec3& max1,const vec3& min2,const vec3& max2);
 	};
@@ -155,10 +281,55 @@ namespace SPK
 		return elasticity;
 	}
 
+	inline void Collision::enableParallelNarrowPhase(bool parallel)
+	{
+		parallelNarrowPhaseEnabled = parallel;
+	}
+
 	inline float Collision::getScale() const
 	{
 		return scale;
 	}
+
+	inline bool Collision::isParallelNarrowPhaseEnabled() const
+	{
+		return parallelNarrowPhaseEnabled;
+	}
+
+	inline bool Collision::isThreadSafe() const
+	{
+		return false;
+	}
+
+	inline bool Collision::needsWholeRange() const
+	{
+		return parallelNarrowPhaseEnabled;
+	}
+
+	inline size_t Collision::getCellSet(const Cell& cell)
+	{
+		return ((cell.x % 3 + 3) % 3) * 9 + ((cell.y % 3 + 3) % 3) * 3 + (cell.z % 3 + 3) % 3;
+	}
+
+	inline bool Collision::CellEntry::operator<(const CellEntry& entry) const
+	{
+		if (x != entry.x)
+			return x < entry.x;
+		if (y != entry.y)
+			return y < entry.y;
+		if (z != entry.z)
+			return z < entry.z;
+		return index < entry.index;
+	}
+
+	inline bool Collision::Cell::operator<(const Cell& cell) const
+	{
+		if (x != cell.x)
+			return x < cell.x;
+		if (y != cell.y)
+			return y < cell.y;
+		return z < cell.z;
+	}
 }
 
 #endif
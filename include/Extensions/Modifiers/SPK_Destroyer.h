@@ -58,10 +58,19 @@ namespace SPK
 		*/
 		static Destroyer* create(Zone* zone = NULL,ModifierTrigger trigger = INSIDE_ZONE);
 
+		///////////////
+		// Interface //
+		///////////////
+
+		virtual bool isThreadSafe() const;
+
 	private :
 
 		virtual void modify(Particle& particle,float deltaTime) const;
+		virtual void modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection) const;
+		virtual void modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const;
 		virtual void modifyWrongSide(Particle& particle,bool inside) const;
+		virtual void modifyWrongSide(Particle& particle,bool inside,const ModifierContext& context) const;
 	};
 
 
@@ -71,6 +80,11 @@ namespace SPK
 		registerObject(obj);
 		return obj;
 	}
+
+	inline bool Destroyer::isThreadSafe() const
+	{
+		return true;
+	}
 }
 
 #endif
@@ -25,6 +25,7 @@
 
 #include "Core/SPK_Modifier.h"
 #include "Core/SPK_Model.h"
+#include "Core/SPK_Group.h"
 
 
 namespace SPK
@@ -144,6 +145,12 @@ namespace SPK
 		*/
 		ModelParam getFactorParam() const;
 
+		///////////////
+		// Interface //
+		///////////////
+
+		virtual bool isThreadSafe() const;
+
 	protected :
 
 		virtual void innerUpdateTransform();
@@ -157,6 +164,7 @@ namespace SPK
 		ModelParam factorParam;
 
 		virtual void modify(Particle& particle,float deltaTime) const;
+		virtual void modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const;
 	};
 
 
@@ -204,6 +212,11 @@ namespace SPK
 		Modifier::innerUpdateTransform();
 		transformDir(tForce,force);
 	}
+
+	inline bool LinearForce::isThreadSafe() const
+	{
+		return true;
+	}
 }
 
 #endif
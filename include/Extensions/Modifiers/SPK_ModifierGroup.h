@@ -78,6 +78,7 @@ namespace SPK
 		* <li>If the trigger of the partition group is activated, then the all children modifiers are activated no matter their Zone.</li>
 		* <li>The same happens for the wrong side.</li>
 		* </ul>
+		* The children are then processed against the Zone of this group, whether it is full or not, without their own Zone being changed.<br>
 		* Note that if a child Modifier needs intersection or normal computation (the Modifier Obstacle for instance), the variables have to be set.
 		*
 		* @param useIntersection : true to enable intersection computation in this ModifierGroup
@@ -208,6 +209,38 @@ namespace SPK
 
 		virtual Registerable* findByName(const std::string& name);
 
+		/**
+		* @brief Tells whether this ModifierGroup can process several ranges of particles of a Group at the same time
+		*
+		* A ModifierGroup is thread safe if all its children are thread safe.<br>
+		* When it is used as a global group, its Zone is passed to the children at each call (see ModifierContext) and is never set to them.
+		*
+		* @return true if this ModifierGroup is thread safe, false if not
+		* @since 1.06.00
+		*/
+		virtual bool isThreadSafe() const;
+
+		/**
+		* @brief Tells whether this ModifierGroup must process all the particles of a Group in a single range
+		*
+		* This is the case when one of its children needs the whole range and the global Zone is not used
+		* (with the global Zone, the children process the particles one by one).
+		*
+		* @return true if this ModifierGroup needs the whole range of particles, false if not
+		* @since 1.06.00
+		*/
+		virtual bool needsWholeRange() const;
+
+		/**
+		* @brief Gets the modifiers which process particles when this ModifierGroup processes particles
+		*
+		* This ModifierGroup and its children, with the modifiers they hold, are added to the vector.
+		*
+		* @param modifiers : the vector to which the modifiers are added
+		* @since 1.06.00
+		*/
+		virtual void getProcessingModifiers(std::vector<const Modifier*>& modifiers) const;
+
 	protected :
 
 		virtual void registerChildren(bool registerAll);
@@ -215,6 +248,7 @@ namespace SPK
 		virtual void destroyChildren(bool keepChildren);
 
 		virtual bool checkBuffers(const Group& group);
+		virtual bool movesParticlesAway() const;
 
 	private :
 
@@ -224,7 +258,12 @@ namespace SPK
 		bool handleWrongSide;
 
 		virtual void modify(Particle& particle,float deltaTime) const;
+		virtual void modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection) const;
+		virtual void modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection,const ModifierContext& context) const;
+		virtual void modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const;
 		virtual void modifyWrongSide(Particle& particle,bool inside) const;
+		virtual void modifyWrongSide(Particle& particle,bool inside,const ModifierContext& context) const;
+		virtual void prepareProcess(Group& group);
 	};
 
 
@@ -101,13 +101,22 @@ namespace SPK
 		*/
 		float getFriction() const;
 
+		///////////////
+		// Interface //
+		///////////////
+
+		virtual bool isThreadSafe() const;
+
 	private :
 
 		float bouncingRatio;
 		float friction;
 
 		virtual void modify(Particle& particle,float deltaTime) const;
+		virtual void modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection) const;
+		virtual void modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const;
 		virtual void modifyWrongSide(Particle& particle,bool inside) const;
+		virtual void modifyWrongSide(Particle& particle,bool inside,const ModifierContext& context) const;
 	};
 
 
@@ -143,6 +152,17 @@ namespace SPK
 		if (isFullZone())
 			getZone()->moveAtBorder(particle.position(),inside);
 	}
+
+	inline void Obstacle::modifyWrongSide(Particle& particle,bool inside,const ModifierContext& context) const
+	{
+		if (context.full)
+			context.zone->moveAtBorder(particle.position(),inside);
+	}
+
+	inline bool Obstacle::isThreadSafe() const
+	{
+		return true;
+	}
 }
 
 #endif
@@ -128,6 +128,12 @@ namespace SPK
 		*/
 		float getMinDistance() const;
 
+		///////////////
+		// Interface //
+		///////////////
+
+		virtual bool isThreadSafe() const;
+
 	protected :
 
 		virtual void innerUpdateTransform();
@@ -141,7 +147,11 @@ namespace SPK
 		float minDistance;
 		float sqrMinDistance;
 
+		void attract(Particle& particle,const Zone* zone,float deltaTime) const;
+
 		virtual void modify(Particle& particle,float deltaTime) const;
+		virtual void modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection,const ModifierContext& context) const;
+		virtual void modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const;
 	};
 
 
@@ -194,6 +204,11 @@ namespace SPK
 		Modifier::innerUpdateTransform();
 		transformDir(tPosition,position); // the delta position is actually a direction not a position
 	}
+
+	inline bool PointMass::isThreadSafe() const
+	{
+		return true;
+	}
 }
 
 #endif
@@ -24,6 +24,7 @@
 #define H_SPK_ROTATOR
 
 #include "Core/SPK_Modifier.h"
+#include "Core/SPK_Group.h"
 
 
 namespace SPK
@@ -59,13 +60,22 @@ namespace SPK
 		*/
 		static Rotator* create();
 
+		///////////////
+		// Interface //
+		///////////////
+
+		virtual bool isThreadSafe() const;
+
 	private :
 
 		virtual void modify(Particle& particle,float deltaTime) const;
+		virtual void modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const;
 	};
 
 
-	inline Rotator::Rotator() : Modifier(ALWAYS | INSIDE_ZONE | OUTSIDE_ZONE) {}
+	inline Rotator::Rotator() :
+		Modifier(ALWAYS | INSIDE_ZONE | OUTSIDE_ZONE)
+	{}
 
 	inline Rotator* Rotator::create()
 	{
@@ -79,6 +89,45 @@ namespace SPK
 		float angle = particle.getParamCurrentValue(PARAM_ANGLE) + deltaTime * particle.getParamCurrentValue(PARAM_ROTATION_SPEED);
 		particle.setParamCurrentValue(PARAM_ANGLE,angle);
 	}
+
+	inline void Rotator::modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const
+	{
+		if (!isAlwaysTriggered())
+		{
+			unsigned char triggers[Zone::BATCH_SIZE];
+			for (size_t blockBegin = begin; blockBegin < end; blockBegin += Zone::BATCH_SIZE)
+			{
+				size_t blockEnd = std::min(blockBegin + Zone::BATCH_SIZE,end);
+				checkTriggers(group,blockBegin,blockEnd,triggers);
+				for (size_t i = blockBegin; i < blockEnd; ++i)
+					if (triggers[i - blockBegin] != 0)
+						Rotator::modify(group.getParticle(i),deltaTime);
+			}
+			return;
+		}
+
+		// The parameters are resolved for the processed group as a Rotator can be shared by several groups
+		float* angles = group.getParamArray(PARAM_ANGLE);
+		if (angles == NULL)
+			return;
+
+		ParamAccessor rotationSpeeds = group.getParamAccessor(PARAM_ROTATION_SPEED);
+
+		if (!rotationSpeeds.isEnabled())
+		{
+			const float rotation = deltaTime * rotationSpeeds[0];
+			for (size_t i = begin; i < end; ++i)
+				angles[i] += rotation;
+		}
+		else
+			for (size_t i = begin; i < end; ++i)
+				angles[i] += deltaTime * rotationSpeeds.values[i];
+	}
+
+	inline bool Rotator::isThreadSafe() const
+	{
+		return true;
+	}
 }
 
 #endif
@@ -214,9 +214,16 @@ namespace SPK
 		*/
 		bool isParticleKillingEnabled() const;
 
+		///////////////
+		// Interface //
+		///////////////
+
+		virtual bool isThreadSafe() const;
+
 	protected :
 
 		virtual void innerUpdateTransform();
+		virtual bool movesParticlesAway() const;
 
 	private :
 
@@ -235,7 +242,10 @@ namespace SPK
 		float eyeRadius;
 		bool killingParticleEnabled;
 
+		bool rotate(vec3& position,float deltaTime) const; // returns false if the particle has to be killed
+
 		virtual void modify(Particle& particle,float deltaTime) const;
+		virtual void modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const;
 	};
 
 
@@ -333,6 +343,17 @@ namespace SPK
 	{
 		return killingParticleEnabled;
 	}
+
+	inline bool Vortex::movesParticlesAway() const
+	{
+		// The particles are rotated around the vortex and not moved along their paths
+		return true;
+	}
+
+	inline bool Vortex::isThreadSafe() const
+	{
+		return true;
+	}
 }
 
 #endif
@@ -0,0 +1,306 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef H_SPK_GEOMETRYBUILDER
+#define H_SPK_GEOMETRYBUILDER
+
+#include "Core/SPK_DEF.h"
+#include "Core/SPK_Vector3D.h"
+#include "Extensions/Renderers/SPK_QuadRendererInterface.h"
+#include "Extensions/Renderers/SPK_LineRendererInterface.h"
+#include "Extensions/Renderers/SPK_PointRendererInterface.h"
+#include "Extensions/Renderers/SPK_Oriented2DRendererInterface.h"
+#include "Extensions/Renderers/SPK_Oriented3DRendererInterface.h"
+
+namespace SPK
+{
+	class Group;
+
+	/**
+	* @struct QuadVertex
+	* @brief A vertex of the quads written by a GeometryBuilder
+	* @since 1.06.00
+	*/
+	struct QuadVertex
+	{
+		vec3 position;	/**< The position of the vertex */
+		float red;		/**< The red component of the color */
+		float green;	/**< The green component of the color */
+		float blue;		/**< The blue component of the color */
+		float alpha;	/**< The alpha component of the color */
+		float u;		/**< The first texture coordinate */
+		float v;		/**< The second texture coordinate */
+		float w;		/**< The third texture coordinate (the texture index with TEXTURE_3D, 0 otherwise) */
+	};
+
+	/**
+	* @struct LineVertex
+	* @brief A vertex of the lines written by a GeometryBuilder
+	* @since 1.06.00
+	*/
+	struct LineVertex
+	{
+		vec3 position;	/**< The position of the vertex */
+		float red;		/**< The red component of the color */
+		float green;	/**< The green component of the color */
+		float blue;		/**< The blue component of the color */
+		float alpha;	/**< The alpha component of the color */
+	};
+
+	/**
+	* @struct PointVertex
+	* @brief A vertex of the points written by a GeometryBuilder
+	*
+	* It can also be used as the data of an instance expanded into a quad on the GPU.
+	*
+	* @since 1.06.00
+	*/
+	struct PointVertex
+	{
+		vec3 position;	/**< The position of the vertex */
+		float red;		/**< The red component of the color */
+		float green;	/**< The green component of the color */
+		float blue;		/**< The blue component of the color */
+		float alpha;	/**< The alpha component of the color */
+		float size;		/**< The size of the point (the size of the renderer multiplied by the size of the Particle) */
+	};
+
+	/**
+	* @class GeometryBuilder
+	* @brief Builds the geometry of the particles of a Group in a buffer given by the caller
+	*
+	* The GeometryBuilder writes interleaved vertices for all the particles of a Group with the settings of the renderer interfaces,
+	* so that a renderer only has to upload the buffer to the rendering API (a mapped buffer can be given directly).<br>
+	* <br>
+	* Unlike the interfaces, the builder does not store anything while building :
+	* several groups can be built at the same time from several threads with the same interfaces.
+	* The particles of a Group can also be built by chunks on the ThreadPool (see enableParallelBuild(bool)).<br>
+	* <br>
+	* The particles are built in the order of their sorted indices when the Group has some (see Group::getSortedIndices()),
+	* so that the geometry is sorted with the SORTING_INDICES mode as well. Otherwise they are built in the order of the Group.<br>
+	* <br>
+	* The vertices are expanded with the SIMD instructions of the kernels (see expandQuads(), expandLines() and packPoints()).
+	*
+	* @since 1.06.00
+	*/
+	class SPK_PREFIX GeometryBuilder
+	{
+	public :
+
+		/////////////////
+		// Constructor //
+		/////////////////
+
+		/** @brief Constructor of GeometryBuilder */
+		GeometryBuilder();
+
+		/////////////
+		// Setters //
+		/////////////
+
+		/**
+		* @brief Sets the camera used to orient the quads
+		*
+		* The vectors are given in the coordinates of the universe. They are used by the orientations depending on the camera
+		* (LOOK_CAMERA_PLANE, LOOK_CAMERA_POINT and UP_CAMERA).
+		*
+		* @param look : the look vector of the camera
+		* @param up : the up vector of the camera
+		* @param position : the position of the camera
+		*/
+		void setCamera(const vec3& look,const vec3& up,const vec3& position);
+
+		/**
+		* @brief Enables or disables the parallel build of the particles
+		*
+		* When the parallel build is enabled, the particles are built by chunks on the worker threads of the ThreadPool.
+		* The result is the same whether the parallel build is enabled or not. By default it is disabled.
+		*
+		* @param parallel : true to enable the parallel build, false to disable it
+		*/
+		void enableParallelBuild(bool parallel);
+
+		/////////////
+		// Getters //
+		/////////////
+
+		/**
+		* @brief Gets the look vector of the camera
+		* @return the look vector of the camera
+		*/
+		const vec3& getCameraLook() const;
+
+		/**
+		* @brief Gets the up vector of the camera
+		* @return the up vector of the camera
+		*/
+		const vec3& getCameraUp() const;
+
+		/**
+		* @brief Gets the position of the camera
+		* @return the position of the camera
+		*/
+		const vec3& getCameraPosition() const;
+
+		/**
+		* @brief Tells whether the parallel build is enabled or not
+		* @return true if the parallel build is enabled, false if it is disabled
+		*/
+		bool isParallelBuildEnabled() const;
+
+		///////////////
+		// Interface //
+		///////////////
+
+		/**
+		* @brief Builds the quads of the particles of a Group oriented in a 3D world
+		*
+		* 4 vertices are written per Particle in this order : top right, top left, bottom left and bottom right.
+		* They can be drawn with the indices written by buildQuadIndices(unsigned int*,size_t).<br>
+		* The particles are rotated if PARAM_ANGLE is enabled in the Model of the Group.<br>
+		* <br>
+		* If the buffer is too small for all the particles, only the first ones are built.
+		*
+		* @param group : the Group whose particles are built
+		* @param quadInterface : the interface giving the scale and the texturing of the quads
+		* @param orientationInterface : the interface giving the orientation of the quads
+		* @param vertices : the buffer of vertices to write
+		* @param nbMaxVertices : the number of vertices the buffer can hold
+		* @return the number of particles built
+		*/
+		size_t buildQuads(const Group& group,const QuadRendererInterface& quadInterface,const Oriented3DRendererInterface& orientationInterface,QuadVertex* vertices,size_t nbMaxVertices) const;
+
+		/**
+		* @brief Builds the quads of the particles of a Group oriented in a 2D world
+		*
+		* This is the same as buildQuads(const Group&,const QuadRendererInterface&,const Oriented3DRendererInterface&,QuadVertex*,size_t)
+		* but the quads are oriented in the xy plane.
+		*
+		* @param group : the Group whose particles are built
+		* @param quadInterface : the interface giving the scale and the texturing of the quads
+		* @param orientationInterface : the interface giving the orientation of the quads
+		* @param vertices : the buffer of vertices to write
+		* @param nbMaxVertices : the number of vertices the buffer can hold
+		* @return the number of particles built
+		*/
+		size_t buildQuads(const Group& group,const QuadRendererInterface& quadInterface,const Oriented2DRendererInterface& orientationInterface,QuadVertex* vertices,size_t nbMaxVertices) const;
+
+		/**
+		* @brief Builds the lines of the particles of a Group
+		*
+		* 2 vertices are written per Particle : its position and its position plus its velocity multiplied by the length of the interface.
+		*
+		* @param group : the Group whose particles are built
+		* @param lineInterface : the interface giving the length of the lines
+		* @param vertices : the buffer of vertices to write
+		* @param nbMaxVertices : the number of vertices the buffer can hold
+		* @return the number of particles built
+		*/
+		size_t buildLines(const Group& group,const LineRendererInterface& lineInterface,LineVertex* vertices,size_t nbMaxVertices) const;
+
+		/**
+		* @brief Builds the points of the particles of a Group
+		*
+		* A vertex is written per Particle.
+		*
+		* @param group : the Group whose particles are built
+		* @param pointInterface : the interface giving the size of the points
+		* @param vertices : the buffer of vertices to write
+		* @param nbMaxVertices : the number of vertices the buffer can hold
+		* @return the number of particles built
+		*/
+		size_t buildPoints(const Group& group,const PointRendererInterface& pointInterface,PointVertex* vertices,size_t nbMaxVertices) const;
+
+		/**
+		* @brief Writes the indices of the triangles of quads
+		*
+		* 6 indices are written per quad, for the triangles (0,1,2) and (0,2,3) of its vertices.
+		* They only depend on the number of quads and can be written once in a static buffer.
+		*
+		* @param indices : the array of 6 * nbQuads indices to write
+		* @param nbQuads : the number of quads
+		*/
+		static void buildQuadIndices(unsigned int* indices,size_t nbQuads);
+
+	private :
+
+		struct QuadJob;
+		struct LineJob;
+		struct PointJob;
+
+		static const size_t BLOCK_SIZE = 256; // Number of particles whose vectors are computed before being expanded
+		static const size_t CHUNK_SIZE = 4096; // Number of particles built by each task of the parallel build
+
+		vec3 cameraLook;
+		vec3 cameraUp;
+		vec3 cameraPosition;
+
+		bool parallelBuildEnabled;
+
+		size_t buildQuads(QuadJob& job,const Group& group,const QuadRendererInterface& quadInterface,QuadVertex* vertices,size_t nbMaxVertices) const;
+
+		template<class Job> void run(const Job& job) const;
+		template<class Job> static void runChunk(void* data,size_t index);
+	};
+
+
+	inline GeometryBuilder::GeometryBuilder() :
+		cameraLook(0.0f,0.0f,-1.0f),
+		cameraUp(0.0f,1.0f,0.0f),
+		cameraPosition(0.0f,0.0f,0.0f),
+		parallelBuildEnabled(false)
+	{}
+
+	inline void GeometryBuilder::setCamera(const vec3& look,const vec3& up,const vec3& position)
+	{
+		cameraLook = look;
+		cameraUp = up;
+		cameraPosition = position;
+	}
+
+	inline void GeometryBuilder::enableParallelBuild(bool parallel)
+	{
+		parallelBuildEnabled = parallel;
+	}
+
+	inline const vec3& GeometryBuilder::getCameraLook() const
+	{
+		return cameraLook;
+	}
+
+	inline const vec3& GeometryBuilder::getCameraUp() const
+	{
+		return cameraUp;
+	}
+
+	inline const vec3& GeometryBuilder::getCameraPosition() const
+	{
+		return cameraPosition;
+	}
+
+	inline bool GeometryBuilder::isParallelBuildEnabled() const
+	{
+		return parallelBuildEnabled;
+	}
+}
+
+#endif
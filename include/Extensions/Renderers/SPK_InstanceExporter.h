@@ -0,0 +1,271 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef H_SPK_INSTANCEEXPORTER
+#define H_SPK_INSTANCEEXPORTER
+
+#include "Core/SPK_DEF.h"
+#include "Core/SPK_Vector3D.h"
+
+namespace SPK
+{
+	class Group;
+	class GroupSnapshot;
+
+	/**
+	* @enum InstanceAttribute
+	* @brief Constants for the attributes of the instances written by an InstanceExporter
+	* @since 1.06.00
+	*/
+	enum InstanceAttribute
+	{
+		INSTANCE_POSITION = 0,			/**< The position of the Particle (3 components) */
+		INSTANCE_COLOR = 1,				/**< The red, green, blue and alpha of the Particle (4 components) */
+		INSTANCE_SIZE = 2,				/**< The size of the Particle */
+		INSTANCE_ANGLE = 3,				/**< The angle of the Particle */
+		INSTANCE_TEXTURE_INDEX = 4,		/**< The texture index of the Particle */
+	};
+
+	/**
+	* @enum InstanceFormat
+	* @brief Constants for the formats of the attributes of the instances written by an InstanceExporter
+	* @since 1.06.00
+	*/
+	enum InstanceFormat
+	{
+		INSTANCE_FORMAT_NONE = 0,		/**< The attribute is not written */
+		INSTANCE_FORMAT_FLOAT = 1,		/**< 32 bits floats (all the attributes) */
+		INSTANCE_FORMAT_HALF = 2,		/**< 16 bits floats (position, size and angle) */
+		INSTANCE_FORMAT_UNORM8 = 3,		/**< 8 bits normalized integers, the values being clamped within [0,1] (color) */
+		INSTANCE_FORMAT_UNORM16 = 4,	/**< 16 bits normalized integers, a turn being divided in 65536 steps (angle) */
+		INSTANCE_FORMAT_UINT8 = 5,		/**< 8 bits integers, the values being clamped within [0,255] and truncated (texture index) */
+	};
+
+	/**
+	* @class InstanceExporter
+	* @brief Exports the particles of a Group as compact instances in a buffer given by the caller
+	*
+	* Each Particle is written as a record of getStride() bytes holding the attributes set with setFormat(InstanceAttribute,InstanceFormat),
+	* so that a renderer expanding the particles on the GPU only uploads what it needs with the precision it needs.<br>
+	* By default, the position is written as 3 floats, the color on 8 bits per component, the size as a half float,
+	* the angle on 16 bits and the texture index on 8 bits : a record takes 24 bytes instead of 40 bytes with floats only.
+	* With the position as half floats relative to the camera (see setOrigin(const vec3&)), it takes 16 bytes.<br>
+	* <br>
+	* The attributes are read directly from the arrays of the Group and quantized by blocks with the SIMD instructions of the kernels
+	* (see convertToHalfFloats(), quantizeColors(), quantizeAngles() and quantizeIndices()).
+	* The parameters which are not enabled in the Model of the Group are written with their default value.<br>
+	* <br>
+	* The attributes are placed in the record by decreasing size of their components (floats first, then 16 bits and 8 bits values)
+	* and in the order of InstanceAttribute for the same size, so that each one is aligned without padding.
+	* The color on 8 bits per component counts as a single 32 bits value. The stride is a multiple of 4 bytes.
+	* The offset of each attribute is given by getOffset(InstanceAttribute) to describe the layout to the rendering API.<br>
+	* <br>
+	* Like the GeometryBuilder, the exporter does not store anything while exporting
+	* and the particles of a Group can be exported by chunks on the ThreadPool (see enableParallelExport(bool)).
+	*
+	* @since 1.06.00
+	*/
+	class SPK_PREFIX InstanceExporter
+	{
+	public :
+
+		/////////////////
+		// Constructor //
+		/////////////////
+
+		/** @brief Constructor of InstanceExporter */
+		InstanceExporter();
+
+		/////////////
+		// Setters //
+		/////////////
+
+		/**
+		* @brief Sets the format of an attribute of the instances
+		*
+		* The available formats depend on the attribute :
+		* <ul>
+		* <li>INSTANCE_POSITION : INSTANCE_FORMAT_NONE, INSTANCE_FORMAT_FLOAT or INSTANCE_FORMAT_HALF</li>
+		* <li>INSTANCE_COLOR : INSTANCE_FORMAT_NONE, INSTANCE_FORMAT_FLOAT or INSTANCE_FORMAT_UNORM8</li>
+		* <li>INSTANCE_SIZE : INSTANCE_FORMAT_NONE, INSTANCE_FORMAT_FLOAT or INSTANCE_FORMAT_HALF</li>
+		* <li>INSTANCE_ANGLE : INSTANCE_FORMAT_NONE, INSTANCE_FORMAT_FLOAT, INSTANCE_FORMAT_HALF or INSTANCE_FORMAT_UNORM16</li>
+		* <li>INSTANCE_TEXTURE_INDEX : INSTANCE_FORMAT_NONE, INSTANCE_FORMAT_FLOAT or INSTANCE_FORMAT_UINT8</li>
+		* </ul>
+		* If the format is not available for the attribute, nothing happens and false is returned.<br>
+		* The layout of the records is updated.
+		*
+		* @param attribute : the attribute
+		* @param format : the format of the attribute
+		* @return true if the format is set, false if it is not available for the attribute
+		*/
+		bool setFormat(InstanceAttribute attribute,InstanceFormat format);
+
+		/**
+		* @brief Sets the origin of the positions written as half floats
+		*
+		* The precision of half floats decreases quickly away from 0 (about 0.03 between 32 and 64) :
+		* the positions written with INSTANCE_FORMAT_HALF are relative to the origin, typically the position of the camera.<br>
+		* The positions written with INSTANCE_FORMAT_FLOAT are not relative. By default, the origin is (0,0,0).
+		*
+		* @param origin : the origin of the positions written as half floats
+		*/
+		void setOrigin(const vec3& origin);
+
+		/**
+		* @brief Enables or disables the parallel export of the particles
+		*
+		* When the parallel export is enabled, the particles are exported by chunks on the worker threads of the ThreadPool.
+		* The result is the same whether the parallel export is enabled or not. By default it is disabled.
+		*
+		* @param parallel : true to enable the parallel export, false to disable it
+		*/
+		void enableParallelExport(bool parallel);
+
+		/////////////
+		// Getters //
+		/////////////
+
+		/**
+		* @brief Gets the format of an attribute of the instances
+		* @param attribute : the attribute
+		* @return the format of the attribute
+		*/
+		InstanceFormat getFormat(InstanceAttribute attribute) const;
+
+		/**
+		* @brief Gets the offset of an attribute within the records
+		* @param attribute : the attribute
+		* @return the offset of the attribute in bytes (meaningless if the attribute is not written)
+		*/
+		size_t getOffset(InstanceAttribute attribute) const;
+
+		/**
+		* @brief Gets the size of a record
+		* @return the number of bytes written per Particle
+		*/
+		size_t getStride() const;
+
+		/**
+		* @brief Gets the origin of the positions written as half floats
+		* @return the origin of the positions written as half floats
+		*/
+		const vec3& getOrigin() const;
+
+		/**
+		* @brief Tells whether the parallel export is enabled or not
+		* @return true if the parallel export is enabled, false if it is disabled
+		*/
+		bool isParallelExportEnabled() const;
+
+		///////////////
+		// Interface //
+		///////////////
+
+		/**
+		* @brief Exports the particles of a Group
+		*
+		* A record of getStride() bytes is written per Particle.
+		* If the buffer is too small for all the particles, only the first ones are exported.<br>
+		* When the Group provides sorted indices (see Group::getSortedIndices()), the particles are exported in their order.
+		*
+		* @param group : the Group whose particles are exported
+		* @param instances : the buffer of records to write
+		* @param nbMaxInstances : the number of records the buffer can hold
+		* @return the number of particles exported
+		*/
+		size_t exportInstances(const Group& group,void* instances,size_t nbMaxInstances) const;
+
+		/**
+		* @brief Exports the particles of a GroupSnapshot
+		*
+		* This allows to export the particles of a Group while it is updated (see Group::enableSnapshot(bool)).<br>
+		* The parameters which were not copied in the snapshot are exported with their default value.
+		* If the positions were not copied, their slot in the records is filled with zeros.<br>
+		* When the snapshot holds sorted indices, the particles are exported in their order.
+		*
+		* @param snapshot : the snapshot whose particles are exported
+		* @param instances : the buffer of records to write
+		* @param nbMaxInstances : the number of records the buffer can hold
+		* @return the number of particles exported
+		*/
+		size_t exportInstances(const GroupSnapshot& snapshot,void* instances,size_t nbMaxInstances) const;
+
+	private :
+
+		struct ExportJob;
+
+		static const size_t NB_ATTRIBUTES = 5;
+		static const size_t BLOCK_SIZE = 256; // Number of particles quantized before being written in the records
+		static const size_t CHUNK_SIZE = 4096; // Number of particles exported by each task of the parallel export
+
+		InstanceFormat formats[NB_ATTRIBUTES];
+		size_t offsets[NB_ATTRIBUTES];
+		size_t stride;
+
+		vec3 origin;
+
+		bool parallelExportEnabled;
+
+		void computeLayout();
+		size_t exportJob(ExportJob& job,void* instances,size_t nbParticles) const;
+
+		static void exportChunk(void* data,size_t index);
+	};
+
+
+	inline void InstanceExporter::setOrigin(const vec3& origin)
+	{
+		this->origin = origin;
+	}
+
+	inline void InstanceExporter::enableParallelExport(bool parallel)
+	{
+		parallelExportEnabled = parallel;
+	}
+
+	inline InstanceFormat InstanceExporter::getFormat(InstanceAttribute attribute) const
+	{
+		return formats[attribute];
+	}
+
+	inline size_t InstanceExporter::getOffset(InstanceAttribute attribute) const
+	{
+		return offsets[attribute];
+	}
+
+	inline size_t InstanceExporter::getStride() const
+	{
+		return stride;
+	}
+
+	inline const vec3& InstanceExporter::getOrigin() const
+	{
+		return origin;
+	}
+
+	inline bool InstanceExporter::isParallelExportEnabled() const
+	{
+		return parallelExportEnabled;
+	}
+}
+
+#endif
@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef H_SPK_INSTANCEOUTPUTSINK
+#define H_SPK_INSTANCEOUTPUTSINK
+
+#include "Core/SPK_RenderOutputSink.h"
+#include "Extensions/Renderers/SPK_InstanceExporter.h"
+
+namespace SPK
+{
+	/**
+	* @class InstanceOutputSink
+	* @brief A RenderOutputSink receiving the particles of a Group as compact instances
+	*
+	* The particles are written in the regions by an InstanceExporter : each output holds getNbParticles(size_t) records
+	* of InstanceExporter::getStride() bytes. If a region is too small, only the first particles are written.<br>
+	* <br>
+	* The exporter must be set up while the sink is not written.
+	*
+	* @since 1.06.00
+	*/
+	class SPK_PREFIX InstanceOutputSink : public RenderOutputSink
+	{
+	public :
+
+		/**
+		* @brief Constructor of InstanceOutputSink
+		* @param nbRegions : the number of regions of the ring
+		*/
+		InstanceOutputSink(size_t nbRegions);
+
+		/**
+		* @brief Gets the exporter writing the instances
+		* @return the exporter writing the instances
+		*/
+		InstanceExporter& getExporter();
+
+		/**
+		* @brief Gets the exporter writing the instances
+		*
+		* This is the constant version of getExporter().
+		*
+		* @return the exporter writing the instances
+		*/
+		const InstanceExporter& getExporter() const;
+
+	protected :
+
+		virtual size_t writeOutput(const Group& group,void* memory,size_t size,size_t& nbBytes);
+
+	private :
+
+		InstanceExporter exporter;
+	};
+
+
+	inline InstanceOutputSink::InstanceOutputSink(size_t nbRegions) :
+		RenderOutputSink(nbRegions),
+		exporter()
+	{}
+
+	inline InstanceExporter& InstanceOutputSink::getExporter()
+	{
+		return exporter;
+	}
+
+	inline const InstanceExporter& InstanceOutputSink::getExporter() const
+	{
+		return exporter;
+	}
+}
+
+#endif
@@ -28,6 +28,8 @@
 
 namespace SPK
 {
+	class GeometryBuilder;
+
 	/**
 	* @brief Defines the orientation of a particle oriented in 2D
 	* @since 1.04.00
@@ -47,6 +49,8 @@ namespace SPK
 	*/
 	class Oriented2DRendererInterface
 	{
+	friend class GeometryBuilder;
+
 	public :
 
 		///////////////
@@ -110,9 +114,17 @@ namespace SPK
 		void scaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const;
 		void rotateAndScaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const;
 
+		// Versions taking the values of the parameters, that can be read with accessors resolved once per Group (since 1.06.00)
+		void scaleQuadVectors(float size,float scaleX,float scaleY) const;
+		void rotateAndScaleQuadVectors(float size,float angle,float scaleX,float scaleY) const;
+
 		const vec3& quadUp() const;
 		const vec3& quadSide() const;
 
+		// Versions computing the vectors without the mutable members, so that several threads can compute them (since 1.06.00)
+		static void normalizeQuadUp(vec3& up);
+		static void rotateQuadVectors(const vec3& up,float angle,vec3& upQuad,vec3& sideQuad);
+
 	private :
 
 		// Used to store the orientation of quads before scaling
@@ -128,7 +140,7 @@ namespace SPK
 	inline Oriented2DRendererInterface::Oriented2DRendererInterface() :
 		orientation(ORIENTATION2D_UP)
 	{
-		orientationVector.set(0.0f,-1.0f);
+		orientationVector = vec3(0.0f,-1.0f,0.0f);
 	}
 		
 	inline void Oriented2DRendererInterface::setOrientation(Orientation2D orientation)
@@ -153,18 +165,17 @@ namespace SPK
 
 	inline bool Oriented2DRendererInterface::hasGlobalOrientation()
 	{
-		return ((orientation == ORIENTATION2D_UP)||(ORIENTATION2D_AXIS));
+		return ((orientation == ORIENTATION2D_UP)||(orientation == ORIENTATION2D_AXIS));
 	}
 	
 	inline void Oriented2DRendererInterface::computeGlobalOrientation2D()
 	{
 		if (orientation == ORIENTATION2D_UP)
-			up.set(0.0f,-0.5f);
+			up = vec3(0.0f,-0.5f,0.0f);
 		else if (orientation == ORIENTATION2D_AXIS)
 		{
-			up.set(orientationVector.x,orientationVector.y);
-			up.normalize();
-			up *= 0.5f;
+			up = orientationVector;
+			normalizeQuadUp(up);
 		}
 	}
 	
@@ -178,38 +189,54 @@ namespace SPK
 			up -= particle.position();
 		}
 		
+		normalizeQuadUp(up);
+	}
+
+	inline void Oriented2DRendererInterface::normalizeQuadUp(vec3& up)
+	{
 		up.z = 0.0f;
-		up.normalize();
+//		up.normalize();
+		up = glm::normalize(up);
 		up *= 0.5f;
 	}
 
 	inline void Oriented2DRendererInterface::scaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const
 	{
-		float size = particle.getParamCurrentValue(PARAM_SIZE);
+		scaleQuadVectors(particle.getParamCurrentValue(PARAM_SIZE),scaleX,scaleY);
+	}
 
-		upQuad.set(up.x,up.y);
+	inline void Oriented2DRendererInterface::rotateAndScaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const
+	{
+		rotateAndScaleQuadVectors(particle.getParamCurrentValue(PARAM_SIZE),particle.getParamCurrentValue(PARAM_ANGLE),scaleX,scaleY);
+	}
+
+	inline void Oriented2DRendererInterface::scaleQuadVectors(float size,float scaleX,float scaleY) const
+	{
+		upQuad = vec3(up.x,up.y,0.0f);
 		upQuad *= size * scaleY;
 		
-		sideQuad.set(-up.y,up.x);
+		sideQuad = vec3(-up.y,up.x,0.0f);
 		sideQuad *= size * scaleX;
 	}
 
-	inline void Oriented2DRendererInterface::rotateAndScaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const
+	inline void Oriented2DRendererInterface::rotateAndScaleQuadVectors(float size,float angle,float scaleX,float scaleY) const
 	{
-		float size = particle.getParamCurrentValue(PARAM_SIZE);
+		rotateQuadVectors(up,angle,upQuad,sideQuad);
+		
+		sideQuad *= size * scaleX;
+		upQuad *= size * scaleY;
+	}
 
-		float angleTexture = particle.getParamCurrentValue(PARAM_ANGLE);
-		float cosA = std::cos(angleTexture);
-		float sinA = std::sin(angleTexture);
+	inline void Oriented2DRendererInterface::rotateQuadVectors(const vec3& up,float angle,vec3& upQuad,vec3& sideQuad)
+	{
+		float cosA = std::cos(angle);
+		float sinA = std::sin(angle);
 
 		upQuad.x = cosA * up.x + sinA * up.y;
 		upQuad.y = -sinA * up.x + cosA * up.y;
 		upQuad.z = 0.0f;
 
-		sideQuad.set(-upQuad.y,upQuad.x);
-		
-		sideQuad *= size * scaleX;
-		upQuad *= size * scaleY;
+		sideQuad = vec3(-upQuad.y,upQuad.x,0.0f);
 	}
 }
 
@@ -31,6 +31,8 @@
 
 namespace SPK
 {
+	class GeometryBuilder;
+
 	/**
 	* @brief Defines the orientation of the vector Look of an oriented 3D particle
 	*
@@ -97,6 +99,8 @@ namespace SPK
 	*/
 	class SPK_PREFIX Oriented3DRendererInterface
 	{
+	friend class GeometryBuilder;
+
 	public :
 
 		///////////////
@@ -205,9 +209,17 @@ namespace SPK
 		void scaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const;
 		void rotateAndScaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const;
 
+		// Versions taking the values of the parameters, that can be read with accessors resolved once per Group (since 1.06.00)
+		void scaleQuadVectors(float size,float scaleX,float scaleY) const;
+		void rotateAndScaleQuadVectors(float size,float angle,float scaleX,float scaleY) const;
+
 		const vec3& quadUp() const;
 		const vec3& quadSide() const;
 
+		// Versions computing the vectors without the mutable members, so that several threads can compute them (since 1.06.00)
+		static void orientQuadVectors(LockedAxis lockedAxis,bool rotated,vec3& look,vec3& up,vec3& side);
+		static void rotateQuadVectors(const vec3& look,const vec3& up,float angle,vec3& upQuad,vec3& sideQuad);
+
 	private :
 
 		// Used to store modelview information
@@ -288,24 +300,7 @@ namespace SPK
 	{
 		look = globalLook;
 		up = globalUp;
-
-		crossProduct(up,look,side);
-		if (lockedAxis == LOCK_LOOK)
-			crossProduct(look,side,up);
-		else if (quadRotated)
-		{
-			crossProduct(side,up,look);
-//			look.normalize();
-			look = glm::normalize(look);
-		}
-
-//		up.normalize();
-		up = glm::normalize(up);
-		up *= 0.5f;
-
-//		side.normalize();
-		side = glm::normalize(side);
-		side *= 0.5f;
+		orientQuadVectors(lockedAxis,quadRotated != 0,look,up,side);
 	}
 	
 	inline void Oriented3DRendererInterface::computeSingleOrientation3D(const Particle& particle)
@@ -333,10 +328,15 @@ namespace SPK
 		else 
 			up = globalUp;
 
+		orientQuadVectors(lockedAxis,quadRotated != 0,look,up,side);
+	}
+
+	inline void Oriented3DRendererInterface::orientQuadVectors(LockedAxis lockedAxis,bool rotated,vec3& look,vec3& up,vec3& side)
+	{
 		crossProduct(up,look,side);
 		if (lockedAxis == LOCK_LOOK)
 			crossProduct(look,side,up);
-		else if (quadRotated)
+		else if (rotated)
 		{
 			crossProduct(side,up,look);
 //			look.normalize();
@@ -354,8 +354,16 @@ namespace SPK
 
 	inline void Oriented3DRendererInterface::scaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const
 	{
-		float size = particle.getParamCurrentValue(PARAM_SIZE);
+		scaleQuadVectors(particle.getParamCurrentValue(PARAM_SIZE),scaleX,scaleY);
+	}
+
+	inline void Oriented3DRendererInterface::rotateAndScaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const
+	{
+		rotateAndScaleQuadVectors(particle.getParamCurrentValue(PARAM_SIZE),particle.getParamCurrentValue(PARAM_ANGLE),scaleX,scaleY);
+	}
 
+	inline void Oriented3DRendererInterface::scaleQuadVectors(float size,float scaleX,float scaleY) const
+	{
 		sideQuad = side;
 		sideQuad *= size * scaleX;
 
@@ -363,13 +371,18 @@ namespace SPK
 		upQuad *= size * scaleY;
 	}
 
-	inline void Oriented3DRendererInterface::rotateAndScaleQuadVectors(const Particle& particle,float scaleX,float scaleY) const
+	inline void Oriented3DRendererInterface::rotateAndScaleQuadVectors(float size,float angle,float scaleX,float scaleY) const
 	{
-		float size = particle.getParamCurrentValue(PARAM_SIZE);
+		rotateQuadVectors(look,up,angle,upQuad,sideQuad);
+		
+		sideQuad *= size * scaleX;
+		upQuad *= size * scaleY;
+	}
 
-		float angleTexture = particle.getParamCurrentValue(PARAM_ANGLE);
-		float cosA = std::cos(angleTexture);
-		float sinA = std::sin(angleTexture);
+	inline void Oriented3DRendererInterface::rotateQuadVectors(const vec3& look,const vec3& up,float angle,vec3& upQuad,vec3& sideQuad)
+	{
+		float cosA = std::cos(angle);
+		float sinA = std::sin(angle);
 
 		upQuad.x = (look.x * look.x + (1.0f - look.x * look.x) * cosA) * up.x
 			+ (look.x * look.y * (1.0f - cosA) - look.z * sinA) * up.y
@@ -384,9 +397,6 @@ namespace SPK
 			+ (look.z * look.z + (1.0f - look.z * look.z) * cosA) * up.z;
 
 		crossProduct(upQuad,look,sideQuad);
-		
-		sideQuad *= size * scaleX;
-		upQuad *= size * scaleY;
 	}
 }
 
@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef H_SPK_QUADOUTPUTSINK
+#define H_SPK_QUADOUTPUTSINK
+
+#include "Core/SPK_RenderOutputSink.h"
+#include "Extensions/Renderers/SPK_GeometryBuilder.h"
+
+namespace SPK
+{
+	/**
+	* @class QuadOutputSink
+	* @brief A RenderOutputSink receiving the particles of a Group as quads
+	*
+	* The quads are written in the regions by a GeometryBuilder with the settings of the renderer interfaces given to the sink :
+	* each output holds 4 QuadVertex per Particle (see GeometryBuilder::buildQuads(const Group&,const QuadRendererInterface&,const Oriented3DRendererInterface&,QuadVertex*,size_t)).
+	* If a region is too small, only the first particles are written. The memory of the regions must be aligned for floats.<br>
+	* <br>
+	* The camera of the builder is typically set on the producer thread before rendering the Group.
+	* The interfaces are read while writing and must not be modified at the same time.
+	*
+	* @since 1.06.00
+	*/
+	class SPK_PREFIX QuadOutputSink : public RenderOutputSink
+	{
+	public :
+
+		/**
+		* @brief Constructor of QuadOutputSink
+		*
+		* The interfaces are typically the ones of the renderer drawing the quads.
+		*
+		* @param nbRegions : the number of regions of the ring
+		* @param quadInterface : the interface giving the scale and the texturing of the quads
+		* @param orientationInterface : the interface giving the orientation of the quads
+		*/
+		QuadOutputSink(size_t nbRegions,const QuadRendererInterface& quadInterface,const Oriented3DRendererInterface& orientationInterface);
+
+		/**
+		* @brief Gets the builder writing the quads
+		* @return the builder writing the quads
+		*/
+		GeometryBuilder& getBuilder();
+
+		/**
+		* @brief Gets the builder writing the quads
+		*
+		* This is the constant version of getBuilder().
+		*
+		* @return the builder writing the quads
+		*/
+		const GeometryBuilder& getBuilder() const;
+
+	protected :
+
+		virtual size_t writeOutput(const Group& group,void* memory,size_t size,size_t& nbBytes);
+
+	private :
+
+		GeometryBuilder builder;
+		const QuadRendererInterface* quadInterface;
+		const Oriented3DRendererInterface* orientationInterface;
+	};
+
+
+	inline QuadOutputSink::QuadOutputSink(size_t nbRegions,const QuadRendererInterface& quadInterface,const Oriented3DRendererInterface& orientationInterface) :
+		RenderOutputSink(nbRegions),
+		builder(),
+		quadInterface(&quadInterface),
+		orientationInterface(&orientationInterface)
+	{}
+
+	inline GeometryBuilder& QuadOutputSink::getBuilder()
+	{
+		return builder;
+	}
+
+	inline const GeometryBuilder& QuadOutputSink::getBuilder() const
+	{
+		return builder;
+	}
+}
+
+#endif
@@ -28,6 +28,8 @@
 
 namespace SPK
 {
+	class GeometryBuilder;
+
 	/**
 	* @enum TexturingMode
 	* @brief Constants defining the way to apply texture over the particles
@@ -47,6 +49,8 @@ namespace SPK
 	*/
 	class SPK_PREFIX QuadRendererInterface
 	{
+	friend class GeometryBuilder;
+
 	public :
 
 		//////////////////
@@ -179,6 +183,10 @@ namespace SPK
 		float textureAtlasH;
 
 		void computeAtlasCoordinates(const Particle& particle) const;
+		void computeAtlasCoordinates(float textureIndexValue) const; // since 1.06.00
+
+		// Computes the texture coordinates without storing them, so that several threads can compute them (since 1.06.00)
+		void getAtlasCoordinates(float textureIndexValue,float& u0,float& u1,float& v0,float& v1) const;
 
 		float textureAtlasU0() const;
 		float textureAtlasU1() const;
@@ -254,11 +262,21 @@ namespace SPK
 
 	inline void QuadRendererInterface::computeAtlasCoordinates(const Particle& particle) const
 	{
-		int textureIndex = static_cast<int>(particle.getParamCurrentValue(PARAM_TEXTURE_INDEX));
-		atlasU0 = atlasU1 = static_cast<float>(textureIndex % textureAtlasNbX) / textureAtlasNbX;
-		atlasV0 = atlasV1 = static_cast<float>(textureIndex / textureAtlasNbX) / textureAtlasNbY;
-		atlasU1 += textureAtlasW;
-		atlasV1 += textureAtlasH;
+		computeAtlasCoordinates(particle.getParamCurrentValue(PARAM_TEXTURE_INDEX));
+	}
+
+	inline void QuadRendererInterface::computeAtlasCoordinates(float textureIndexValue) const
+	{
+		getAtlasCoordinates(textureIndexValue,atlasU0,atlasU1,atlasV0,atlasV1);
+	}
+
+	inline void QuadRendererInterface::getAtlasCoordinates(float textureIndexValue,float& u0,float& u1,float& v0,float& v1) const
+	{
+		int textureIndex = static_cast<int>(textureIndexValue);
+		u0 = u1 = static_cast<float>(textureIndex % textureAtlasNbX) / textureAtlasNbX;
+		v0 = v1 = static_cast<float>(textureIndex / textureAtlasNbX) / textureAtlasNbY;
+		u1 += textureAtlasW;
+		v1 += textureAtlasH;
 	}
 }
 
@@ -38,7 +38,10 @@ namespace SPK
 	* <li>The radius of the cylinder</li>
 	* <li>A dimension (length) along the direction</li>
 	* </ul>
-	* Note that the direction does not have to be normalized as it is normalized internally when set.
+	* Note that the direction does not have to be normalized as it is normalized internally when set.<br>
+	* <br>
+	* As intersects(const vec3&,const vec3&,vec3*,vec3*) tests the whole line of the axis and not only the segment between the disks,
+	* a cylinder is not bounded (see Zone::getAABB(vec3&,vec3&)).
 	*
 	* @since 1.05.03
 	*/
@@ -135,8 +138,11 @@ namespace SPK
 		///////////////
 
 		virtual void generatePosition(Particle& particle,bool full) const;
+		virtual void generatePositions(Group& group,size_t begin,size_t end,bool full) const;
 		virtual bool contains(const vec3& v) const;
 		virtual bool intersects(const vec3& v0,const vec3& v1,vec3* intersection,vec3* normal) const;
+		virtual void containsBatch(const vec3* points,size_t nb,unsigned char* results) const;
+		virtual void intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const;
 		virtual void moveAtBorder(vec3& v,bool inside) const;
 		virtual vec3 computeNormal(const vec3& point) const;
 
@@ -59,8 +59,12 @@ namespace SPK
 
 		// Interface
 		virtual void generatePosition(Particle& particle,bool full) const;
+		virtual void generatePositions(Group& group,size_t begin,size_t end,bool full) const;
 		virtual bool contains(const vec3& v) const;
 		virtual bool intersects(const vec3& v0,const vec3& v1,vec3* intersection,vec3* normal) const;
+		virtual void containsBatch(const vec3* points,size_t nb,unsigned char* results) const;
+		virtual void intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const;
+		virtual bool getAABB(vec3& AABBMin,vec3& AABBMax) const;
 		virtual void moveAtBorder(vec3& v,bool inside) const;
 		virtual vec3 computeNormal(const vec3& point) const;
 	};
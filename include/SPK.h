@@ -34,6 +34,7 @@
 #include "Core/SPK_BufferHandler.h" // 1.04
 #include "Core/SPK_RegWrapper.h" // 1.03
 #include "Core/SPK_Renderer.h"
+#include "Core/SPK_RenderOutputSink.h" // 1.06
 #include "Core/SPK_System.h"
 #include "Core/SPK_Particle.h"
 #include "Core/SPK_Pool.h"
@@ -43,7 +44,11 @@
 #include "Core/SPK_Emitter.h"
 #include "Core/SPK_Modifier.h"
 #include "Core/SPK_Group.h"
+#include "Core/SPK_GroupSnapshot.h" // 1.06
 #include "Core/SPK_Factory.h" // 1.03
+#include "Core/SPK_Kernel.h" // 1.06
+#include "Core/SPK_ThreadPool.h" // 1.06
+#include "Core/SPK_RandomGenerator.h" // 1.06
 
 // Zones
 #include "Extensions/Zones/SPK_AABox.h"
@@ -74,7 +79,12 @@
 // Renderer Interfaces
 #include "Extensions/Renderers/SPK_PointRendererInterface.h" // 1.04
 #include "Extensions/Renderers/SPK_LineRendererInterface.h" // 1.04
+#include "Extensions/Renderers/SPK_Oriented2DRendererInterface.h" // 1.04
 #include "Extensions/Renderers/SPK_Oriented3DRendererInterface.h" // 1.04
 #include "Extensions/Renderers/SPK_QuadRendererInterface.h"
+#include "Extensions/Renderers/SPK_GeometryBuilder.h" // 1.06
+#include "Extensions/Renderers/SPK_InstanceExporter.h" // 1.06
+#include "Extensions/Renderers/SPK_InstanceOutputSink.h" // 1.06
+#include "Extensions/Renderers/SPK_QuadOutputSink.h" // 1.06
 
 #endif
@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Core/SPK_Buffer.h"
+
+
+namespace SPK
+{
+	void Buffer::reset(size_t) {}
+
+	void Buffer::applyPermutation(const unsigned int* permutation,size_t begin,size_t end)
+	{
+		// The buffer can only swap its elements so the permutation is applied by following its cycles
+		std::vector<bool> moved(end - begin,false);
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (moved[i - begin])
+				continue;
+
+			size_t j = i;
+			moved[j - begin] = true;
+			for (size_t k = permutation[j]; k != i; k = permutation[j])
+			{
+				swap(j,k);
+				j = k;
+				moved[j - begin] = true;
+			}
+		}
+	}
+
+	void Buffer::compact(const unsigned long long* aliveMask,size_t nbParticles)
+	{
+		// The particles of the first words that are all alive are not moved
+		size_t src = 0;
+		while ((src + 64 <= nbParticles)&&(aliveMask[src >> 6] == ~0ULL))
+			src += 64;
+
+		// Swapping keeps the order as the data swapped to the back are dead
+		for (size_t dst = src; src < nbParticles; ++src)
+			if (((aliveMask[src >> 6] >> (src & 63)) & 1) != 0)
+			{
+				if (src != dst)
+					swap(dst,src);
+				++dst;
+			}
+	}
+}
@@ -21,8 +21,29 @@
 
 #include "Core/SPK_DEF.h"
 
+#include <new>
+
 
 namespace SPK
 {
 	unsigned int randomSeed = 1;
+
+	void* allocateAligned(size_t size)
+	{
+		// the address of the raw block is stored just before the aligned block
+		char* raw = static_cast<char*>(std::malloc(size + DATA_ALIGNMENT + sizeof(void*)));
+		if (raw == NULL)
+			throw std::bad_alloc();
+
+		size_t address = reinterpret_cast<size_t>(raw + sizeof(void*));
+		char* block = raw + sizeof(void*) + (DATA_ALIGNMENT - (address & (DATA_ALIGNMENT - 1))) % DATA_ALIGNMENT;
+		reinterpret_cast<void**>(block)[-1] = raw;
+		return block;
+	}
+
+	void releaseAligned(void* block)
+	{
+		if (block != NULL)
+			std::free(reinterpret_cast<void**>(block)[-1]);
+	}
 }
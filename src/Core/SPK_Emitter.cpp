@@ -21,6 +21,7 @@
 
 
 #include "Core/SPK_Emitter.h"
+#include "Core/SPK_Group.h"
 #include "Extensions/Zones/SPK_Point.h"
 
 
@@ -105,6 +106,26 @@ namespace SPK
 		return defaultZone;
 	}
 
+	void Emitter::generateVelocities(Group& group,size_t begin,size_t end) const
+	{
+		ParamAccessor masses = group.getParamAccessor(PARAM_MASS);
+		float speeds[Zone::BATCH_SIZE];
+		for (size_t i = begin; i < end; i += Zone::BATCH_SIZE)
+		{
+			size_t nb = std::min(end - i,Zone::BATCH_SIZE);
+			group.getRandomGenerator().generate(speeds,nb,forceMin,forceMax);
+			for (size_t j = 0; j < nb; ++j)
+				speeds[j] /= masses[i + j];
+			generateVelocities(group,i,i + nb,speeds);
+		}
+	}
+
+	void Emitter::generateVelocities(Group& group,size_t begin,size_t end,const float* speeds) const
+	{
+		for (size_t i = begin; i < end; ++i)
+			generateVelocity(group.getParticle(i),speeds[i - begin]);
+	}
+
 	unsigned int Emitter::updateNumber(float deltaTime)
 	{
 		int nbBorn;
@@ -24,8 +24,12 @@
 #include "Core/SPK_Emitter.h"
 #include "Core/SPK_Modifier.h"
 #include "Core/SPK_Renderer.h"
+#include "Core/SPK_RenderOutputSink.h"
+#include "Core/SPK_GroupSnapshot.h"
 #include "Core/SPK_Factory.h"
 #include "Core/SPK_Buffer.h"
+#include "Core/SPK_Kernel.h"
+#include "Core/SPK_ThreadPool.h"
 
 
 namespace SPK
@@ -37,14 +41,14 @@ namespace SPK
 		Transformable(),
 		model(m != NULL ? m : &getDefaultModel()),
 		renderer(NULL),
+		outputSink(NULL),
 		friction(0.0f),
 		gravity(vec3()),
 		pool(Pool<Particle>(capacity)),
-		particleData(new Particle::ParticleData[capacity]),
-		particleCurrentParams(new float[capacity * model->getSizeOfParticleCurrentArray()]),
-		particleExtendedParams(new float[capacity * model->getSizeOfParticleExtendedArray()]),
+		randomGenerator(random(0u,0xFFFFFFFFu)),
 		sortingEnabled(false),
 		distanceComputationEnabled(false),
+		sortingMode(SORTING_SWAP),
 		creationBuffer(),
 		nbBufferedParticles(0),
 		fupdate(NULL),
@@ -54,20 +58,37 @@ namespace SPK
 		emitters(),
 		modifiers(),
 		activeModifiers(),
+		chunks(),
+		parallelUpdateEnabled(false),
+		modifierCullingEnabled(false),
+		reachComputed(false),
+		maxSqrVelocity(0.0f),
+		deathCompactionEnabled(false),
+		snapshots(NULL),
+		publishedSnapshot(NULL),
 		additionalBuffers(),
 		swappableBuffers()
-	{}
+	{
+		sortingStats.path = SORTING_PATH_NONE;
+		sortingStats.nbNewBorns = 0;
+		sortingStats.nbMoves = 0;
+
+		allocateParticleData(pool.getNbReserved());
+	}
 
 	Group::Group(const Group& group) :
 		Registerable(group),
 		Transformable(group),
 		model(group.model),
 		renderer(group.renderer),
+		outputSink(NULL),
 		friction(group.friction),
 		gravity(group.gravity),
 		pool(group.pool),
+		randomGenerator(random(0u,0xFFFFFFFFu)), // the copy has its own stream of random numbers
 		sortingEnabled(group.sortingEnabled),
 		distanceComputationEnabled(group.distanceComputationEnabled),
+		sortingMode(group.sortingMode),
 		creationBuffer(group.creationBuffer),
 		nbBufferedParticles(group.nbBufferedParticles),
 		fupdate(group.fupdate),
@@ -77,31 +98,33 @@ namespace SPK
 		emitters(group.emitters),
 		modifiers(group.modifiers),
 		activeModifiers(group.activeModifiers.capacity()),
+		chunks(),
+		parallelUpdateEnabled(group.parallelUpdateEnabled),
+		modifierCullingEnabled(group.modifierCullingEnabled),
+		reachComputed(false),
+		maxSqrVelocity(0.0f),
+		deathCompactionEnabled(group.deathCompactionEnabled),
+		snapshots(NULL), // the copy publishes its own snapshots
+		publishedSnapshot(NULL),
 		additionalBuffers(),
 		swappableBuffers()
 	{
-		particleData = new Particle::ParticleData[pool.getNbReserved()];
-		particleCurrentParams = new float[pool.getNbReserved() * model->getSizeOfParticleCurrentArray()];
-		particleExtendedParams = new float[pool.getNbReserved() * model->getSizeOfParticleExtendedArray()];
+		sortingStats = group.sortingStats;
 
-		std::memcpy(particleData,group.particleData,pool.getNbTotal() * sizeof(Particle::ParticleData));
-		std::memcpy(particleCurrentParams,group.particleCurrentParams,pool.getNbTotal() * sizeof(float) * model->getSizeOfParticleCurrentArray());
-		std::memcpy(particleExtendedParams,group.particleExtendedParams,pool.getNbTotal() * sizeof(float) * model->getSizeOfParticleExtendedArray());
+		allocateParticleData(pool.getNbReserved());
+		copyParticleData(group.particleData,pool.getNbTotal());
 
 		for (Pool<Particle>::iterator it = pool.begin(); it != pool.endInactive(); ++it)
-		{
-			it->group = this;
-			it->data = particleData + it->index;
-			it->currentParams = particleCurrentParams + it->index * model->getSizeOfParticleCurrentArray();
-			it->extendedParams = particleExtendedParams + it->index * model->getSizeOfParticleExtendedArray();
-		}
+			it->data = &particleData;
+
+		enableSnapshot(group.isSnapshotEnabled());
 	}
 
 	Group::~Group()
 	{
-		delete[] particleData;
-		delete[] particleCurrentParams;
-		delete[] particleExtendedParams;
+		setOutputSink(NULL);
+		releaseParticleData();
+		delete[] snapshots;
 
 		// destroys additional buffers
 		destroyAllBuffers();
@@ -198,13 +221,8 @@ namespace SPK
 		model = newmodel;
 
 		// recreate data
-		delete[] particleData;
-		delete[] particleCurrentParams;
-		delete[] particleExtendedParams;
-
-		particleData = new Particle::ParticleData[pool.getNbReserved()];
-		particleCurrentParams = new float[pool.getNbReserved() * model->getSizeOfParticleCurrentArray()];
-		particleExtendedParams = new float[pool.getNbReserved() * model->getSizeOfParticleExtendedArray()];
+		releaseParticleData();
+		allocateParticleData(pool.getNbReserved());
 
 		pool.clear();
 
@@ -226,6 +244,21 @@ namespace SPK
 		this->renderer = renderer;
 	}
 
+	bool Group::setOutputSink(RenderOutputSink* sink)
+	{
+		// A sink has a single producer
+		if ((sink != NULL)&&(sink->producer != NULL)&&(sink->producer != this))
+			return false;
+
+		if (outputSink != NULL)
+			outputSink->producer = NULL;
+		outputSink = sink;
+		if (outputSink != NULL)
+			outputSink->producer = this;
+
+		return true;
+	}
+
 	void Group::addEmitter(Emitter* emitter)
 	{
 		if (emitter == NULL)
@@ -306,6 +339,16 @@ namespace SPK
 
 		unsigned int nbBorn = nbAutoBorn + nbManualBorn;
 
+		// Computes the box that the particles can reach during this update from the bounding box and the velocities of the previous one
+		bool culling = (modifierCullingEnabled)&&(boundingBoxEnabled)&&(reachComputed)&&(pool.getNbActive() > 0);
+		vec3 reachMin,reachMax;
+		if (culling)
+		{
+			float reach = std::sqrt(maxSqrVelocity) * std::abs(deltaTime);
+			reachMin = AABBMin - vec3(reach,reach,reach);
+			reachMax = AABBMax + vec3(reach,reach,reach);
+		}
+
 		// Inits bounding box
 		if (boundingBoxEnabled)
 		{
@@ -313,45 +356,100 @@ namespace SPK
 			AABBMin = vec3(maxFloat,maxFloat,maxFloat);
 			AABBMax = vec3(-maxFloat,-maxFloat,-maxFloat);
 		}
+		maxSqrVelocity = 0.0f;
 
 		// Prepare modifiers for processing
+		// The modifiers whose zone is out of reach are culled until one may move the particles out of the box
 		activeModifiers.clear();
 		for (std::vector<Modifier*>::iterator it = modifiers.begin(); it != modifiers.end(); ++it)
 		{
 			(*it)->beginProcess(*this);
+			if ((culling)&&((*it)->isActive()))
+				culling = (*it)->cullProcess(reachMin,reachMax);
 			if ((*it)->isActive())
 				activeModifiers.push_back(*it);
 		}
 
-		// Updates particles
-		for (size_t i = 0; i < pool.getNbActive(); ++i)
+		// Updates particles by chunks so that each modifier processes a range of particles at once
+		// A modifier that needs the whole range gets all the particles in a single chunk
+		size_t chunkSize = UPDATE_CHUNK_SIZE;
+		for (std::vector<Modifier*>::const_iterator it = activeModifiers.begin(); it != activeModifiers.end(); ++it)
+			if ((*it)->needsWholeRange())
+				chunkSize = std::max<size_t>(pool.getNbActive(),1);
+
+		size_t nbChunks = (pool.getNbActive() + chunkSize - 1) / chunkSize;
+		if (chunks.size() < nbChunks)
+			chunks.resize(nbChunks);
+
+		// The chunks hold a multiple of 64 particles (or all of them) so that each word of the mask is written by a single chunk
+		if (deathCompactionEnabled)
 		{
-			if ((pool[i].update(deltaTime))||((fupdate != NULL)&&((*fupdate)(pool[i],deltaTime))))
-			{
-				if (fdeath != NULL)
-					(*fdeath)(pool[i]);
+			aliveMask.assign((pool.getNbActive() + 63) >> 6,~0ULL);
+			if ((pool.getNbActive() & 63) != 0)
+				aliveMask.back() = (1ULL << (pool.getNbActive() & 63)) - 1;
+		}
+
+		bool parallel = (parallelUpdateEnabled)&&(nbChunks > 1);
+		for (std::vector<Modifier*>::const_iterator it = activeModifiers.begin(); (parallel)&&(it != activeModifiers.end()); ++it)
+			parallel = (*it)->isThreadSafe();
+
+		// The random numbers drawn by the modifiers are keyed by the update and by the chunk, whatever the thread the chunk is updated by
+		unsigned int randomKey = randomGenerator.random(0u,0xFFFFFFFFu);
+
+		if (parallel)
+		{
+			UpdateTaskData taskData = {this,chunkSize,deltaTime,randomKey};
+			ThreadPool::getInstance().run(&Group::updateChunkTask,&taskData,nbChunks);
+		}
+		else
+			for (size_t i = 0; i < nbChunks; ++i)
+				updateChunk(i,chunkSize,deltaTime,randomKey);
 
-				if (nbBorn > 0)
+		// Merges the bounding boxes of the chunks (a chunk whose particles all died has an empty bounding box)
+		if (boundingBoxEnabled)
+			for (size_t i = 0; i < nbChunks; ++i)
+				if (chunks[i].AABBMin.x <= chunks[i].AABBMax.x)
 				{
-					pool[i].init();
-					launchParticle(pool[i],emitterIt,nbManualBorn);
-					--nbBorn;
+					updateAABB(chunks[i].AABBMin,AABBMin,AABBMax);
+					updateAABB(chunks[i].AABBMax,AABBMin,AABBMax);
+					maxSqrVelocity = std::max(maxSqrVelocity,chunks[i].maxSqrVelocity);
 				}
-				else
+
+		// Handles dead particles
+		// When the compaction is enabled they are removed at once and the particles born are all pushed afterwards (since 1.06.00)
+		// Otherwise they are parsed from the last one so that the particles swapped in their place are always alive
+		if (deathCompactionEnabled)
+		{
+			size_t nbDeaths = 0;
+			for (size_t i = 0; i < nbChunks; ++i)
+				nbDeaths += chunks[i].nbDeaths;
+			compactParticles(nbDeaths);
+		}
+		else
+		{
+			for (size_t chunkIndex = nbChunks; chunkIndex > 0; --chunkIndex)
+			{
+				const std::vector<size_t>& deadParticles = chunks[chunkIndex - 1].deadParticles;
+				for (std::vector<size_t>::const_reverse_iterator it = deadParticles.rbegin(); it != deadParticles.rend(); ++it)
 				{
-					particleData[i].sqrDist = 0.0f;
-					pool.makeInactive(i);
-					--i;
+					size_t i = *it;
+
+					if (fdeath != NULL)
+						(*fdeath)(pool[i]);
+
+					if (nbBorn > 0)
+					{
+						pool[i].init();
+						launchParticle(pool[i],emitterIt,nbManualBorn);
+						--nbBorn;
+					}
+					else
+					{
+						particleData.sqrDists[i] = 0.0f;
+						pool.makeInactive(i);
+					}
 				}
 			}
-			else
-			{
-				if (boundingBoxEnabled)
-					updateAABB(pool[i]);
-
-				if (distanceComputationEnabled)
-					pool[i].computeSqrDist();
-			}
 		}
 
 		// Terminates modifiers processing
@@ -359,12 +457,17 @@ namespace SPK
 			(*it)->endProcess(*this);
 
 		// Emits new particles if some left
-		for (int i = nbBorn; i > 0; --i)
+		// The particles added manually come first, the ones of the emitters are then launched by batches (since 1.06.00)
+		for (; (nbBorn > 0)&&(nbManualBorn > 0); --nbBorn)
 			pushParticle(emitterIt,nbManualBorn);
+		if (nbBorn > 0)
+			pushParticles(nbBorn,emitterIt);
 
 		// Sorts particles if enabled
-		if ((sortingEnabled)&&(pool.getNbActive() > 1))
-			sortParticles(0,pool.getNbActive() - 1);
+		if (sortingEnabled)
+			sortActiveParticles();
+		else
+			sortingStats.path = SORTING_PATH_NONE;
 
 		if ((!boundingBoxEnabled)||(pool.getNbActive() == 0))
 		{
@@ -372,9 +475,230 @@ namespace SPK
 			AABBMax = vec3(0.0f,0.0f,0.0f);
 		}
 
+		reachComputed = (modifierCullingEnabled)&&(boundingBoxEnabled);
+
+		if (snapshots != NULL)
+			publishSnapshot();
+
 		return (hasActiveEmitters)||(pool.getNbActive() > 0);
 	}
 
+	void Group::updateChunkTask(void* data,size_t index)
+	{
+		UpdateTaskData* taskData = static_cast<UpdateTaskData*>(data);
+		taskData->group->updateChunk(index,taskData->chunkSize,taskData->deltaTime,taskData->randomKey);
+	}
+
+	void Group::updateChunk(size_t chunkIndex,size_t chunkSize,float deltaTime,unsigned int randomKey)
+	{
+		size_t begin = chunkIndex * chunkSize;
+		size_t end = std::min(begin + chunkSize,pool.getNbActive());
+
+		ChunkData& chunk = chunks[chunkIndex];
+		chunk.deadParticles.clear();
+		chunk.nbDeaths = 0;
+		if (boundingBoxEnabled)
+		{
+			const float maxFloat = std::numeric_limits<float>::max();
+			chunk.AABBMin = vec3(maxFloat,maxFloat,maxFloat);
+			chunk.AABBMax = vec3(-maxFloat,-maxFloat,-maxFloat);
+			chunk.maxSqrVelocity = 0.0f;
+		}
+
+		(*model->updateKernel)(*this,begin,end,deltaTime);
+
+		interpolateParameters(begin,end,chunk.interpolationXs);
+
+		integrateParticles(particleData.oldPositions + begin,particleData.positions + begin,particleData.velocities + begin,end - begin,gravity,deltaTime);
+
+		getThreadRandomGenerator().setSeed(randomKey + static_cast<unsigned int>(chunkIndex) * RandomGenerator::COUNTER_STEP);
+		for (std::vector<Modifier*>::const_iterator it = activeModifiers.begin(); it != activeModifiers.end(); ++it)
+			(*it)->modifyBatch(*this,begin,end,deltaTime);
+
+		if (friction != 0.0f)
+		{
+			const float* masses = getParamArray(PARAM_MASS);
+			applyFriction(particleData.velocities + begin,masses != NULL ? masses + begin : NULL,end - begin,friction,deltaTime);
+		}
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			Particle& particle = pool[i];
+
+			if ((!particle.isAlive())||((fupdate != NULL)&&((*fupdate)(particle,deltaTime))))
+			{
+				if (deathCompactionEnabled)
+				{
+					aliveMask[i >> 6] &= ~(1ULL << (i & 63));
+					++chunk.nbDeaths;
+				}
+				else
+					chunk.deadParticles.push_back(i);
+			}
+			else
+			{
+				if (boundingBoxEnabled)
+				{
+					updateAABB(particle.position(),chunk.AABBMin,chunk.AABBMax);
+					if (modifierCullingEnabled)
+						chunk.maxSqrVelocity = std::max(chunk.maxSqrVelocity,dotProduct(particle.velocity(),particle.velocity()));
+				}
+
+				if (distanceComputationEnabled)
+					particle.computeSqrDist();
+			}
+		}
+	}
+
+	template<typename T>
+	static void compactArray(T* data,const std::vector<unsigned int>& indices,const std::vector<unsigned int>& runs,size_t begin,size_t end)
+	{
+		// The particles are moved towards the beginning of the array in their order so that the array can be compacted in place
+		if (runs.empty())
+			for (size_t i = begin; i < end; ++i)
+				data[i] = data[indices[i - begin]];
+		else
+			for (size_t i = 0; i < runs.size(); i += 2)
+			{
+				std::copy(data + runs[i],data + runs[i] + runs[i + 1],data + begin);
+				begin += runs[i + 1];
+			}
+	}
+
+	void Group::compactParticles(size_t nbDeaths)
+	{
+		if (nbDeaths == 0)
+			return;
+
+		const size_t nbActive = pool.getNbActive();
+		const size_t nbWords = (nbActive + 63) >> 6;
+		const unsigned long long* mask = &aliveMask[0];
+
+		// The particles before the first word holding a death are not moved
+		size_t firstWord = 0;
+		while (mask[firstWord] == ~0ULL)
+			++firstWord;
+
+		const size_t begin = firstWord << 6;
+		const size_t end = nbActive - nbDeaths;
+
+		// The death function is called in the order of the particles before they are moved
+		if (fdeath != NULL)
+			for (size_t i = firstWord; i < nbWords; ++i)
+				if (mask[i] != ~0ULL)
+					for (size_t j = i << 6, last = std::min(j + 64,nbActive); j < last; ++j)
+						if (((mask[i] >> (j & 63)) & 1) == 0)
+							(*fdeath)(pool[j]);
+
+		// When the deaths are rare, the runs of consecutive particles alive are moved at once
+		// Otherwise the indices of the particles alive are collected without branches and each particle is gathered
+		aliveRuns.clear();
+		aliveIndices.resize(end - begin + 1);
+		if (end - begin >= nbDeaths * COMPACTION_MIN_RUN_SIZE)
+		{
+			size_t runStart = begin;
+			for (size_t i = firstWord; i < nbWords; ++i)
+				if (mask[i] != ~0ULL)
+					for (size_t j = i << 6, last = std::min(j + 64,nbActive); j < last; ++j)
+						if (((mask[i] >> (j & 63)) & 1) == 0)
+						{
+							if (j > runStart)
+							{
+								aliveRuns.push_back(static_cast<unsigned int>(runStart));
+								aliveRuns.push_back(static_cast<unsigned int>(j - runStart));
+							}
+							runStart = j + 1;
+						}
+
+			if (nbActive > runStart)
+			{
+				aliveRuns.push_back(static_cast<unsigned int>(runStart));
+				aliveRuns.push_back(static_cast<unsigned int>(nbActive - runStart));
+			}
+		}
+		else
+		{
+			unsigned int* indices = &aliveIndices[0];
+			size_t nbAlive = 0;
+			for (size_t i = begin; i < nbActive; ++i)
+			{
+				indices[nbAlive] = static_cast<unsigned int>(i);
+				nbAlive += (mask[i >> 6] >> (i & 63)) & 1;
+			}
+		}
+
+		// Moves the particles alive one array after the other
+		compactArray(particleData.oldPositions,aliveIndices,aliveRuns,begin,end);
+		compactArray(particleData.positions,aliveIndices,aliveRuns,begin,end);
+		compactArray(particleData.velocities,aliveIndices,aliveRuns,begin,end);
+		compactArray(particleData.ages,aliveIndices,aliveRuns,begin,end);
+		compactArray(particleData.lives,aliveIndices,aliveRuns,begin,end);
+		compactArray(particleData.sqrDists,aliveIndices,aliveRuns,begin,end);
+
+		for (size_t i = 0; i < model->getSizeOfParticleCurrentArray(); ++i)
+			compactArray(particleData.currentParams + i * particleData.pitch,aliveIndices,aliveRuns,begin,end);
+		for (size_t i = 0; i < model->getSizeOfParticleExtendedArray(); ++i)
+			compactArray(particleData.extendedParams + i * particleData.pitch,aliveIndices,aliveRuns,begin,end);
+
+		for (std::vector<Buffer*>::const_iterator it = swappableBuffers.begin(); it != swappableBuffers.end(); ++it)
+			(*it)->compact(mask,nbActive);
+
+		pool.truncateActive(end);
+	}
+
+	void Group::interpolateParameters(size_t begin,size_t end,std::vector<float>& xs)
+	{
+		size_t nb = end - begin;
+		if ((nb == 0)||(model->nbInterpolatedParams == 0))
+			return;
+
+		if (xs.size() < nb)
+			xs.resize(nb);
+
+		// The parameters are interpolated on the whole range one after the other, in the same order as Particle::interpolateParameters()
+		// so that a parameter interpolated from another interpolated parameter gets the same value
+		const size_t pitch = particleData.pitch;
+		size_t extendedIndex = model->nbMutableParams;
+		for (size_t i = 0; i < model->nbInterpolatedParams; ++i)
+		{
+			ModelParam param = static_cast<ModelParam>(model->interpolatedParams[i]);
+			Interpolator* interpolator = model->interpolators[param];
+
+			// Gets or computes the x of the particles
+			const float* x = &xs[0];
+			switch(interpolator->getType())
+			{
+			case INTERPOLATOR_LIFETIME :
+				for (size_t j = 0; j < nb; ++j)
+					xs[j] = particleData.ages[begin + j] / (particleData.ages[begin + j] + particleData.lives[begin + j]);
+				break;
+
+			case INTERPOLATOR_AGE :
+				x = particleData.ages + begin;
+				break;
+
+			case INTERPOLATOR_PARAM :
+				{
+					ModelParam xParam = interpolator->getInterpolatorParam();
+					if (model->isEnabled(xParam))
+						x = particleData.currentParams + model->particleEnableIndices[xParam] * pitch + begin;
+					else
+						std::fill(xs.begin(),xs.begin() + nb,Model::getDefaultValue(xParam));
+				}
+				break;
+
+			case INTERPOLATOR_VELOCITY :
+				for (size_t j = 0; j < nb; ++j)
+					xs[j] = glm::length2(particleData.velocities[begin + j]);
+				break;
+			}
+
+			const float* extendedParams = particleData.extendedParams + extendedIndex * pitch + begin;
+			interpolator->interpolate(particleData.currentParams + model->particleEnableIndices[param] * pitch + begin,x,extendedParams,extendedParams + pitch,extendedParams + (pitch << 1),nb,param);
+			extendedIndex += 3;
+		}
+	}
+
 	void Group::pushParticle(std::vector<EmitterData>::iterator& emitterIt,unsigned int& nbManualBorn)
 	{
 		Particle* ptr = pool.makeActive();
@@ -383,6 +707,7 @@ namespace SPK
 			if (pool.getNbEmpty() > 0)
 			{
 				Particle p(this,pool.getNbActive());
+				p.init();
 				launchParticle(p,emitterIt,nbManualBorn);
 				pool.pushActive(p);
 			}
@@ -424,6 +749,10 @@ namespace SPK
 		// Resets old position (fix 1.04.00)
 		p.oldPosition() = p.position();
 
+		// Resets the data of the particle in the swappable buffers (since 1.06.00)
+		for (std::vector<Buffer*>::const_iterator it = swappableBuffers.begin(); it != swappableBuffers.end(); ++it)
+			(*it)->reset(p.getIndex());
+
 		// first parameter interpolation
 		// must be here so that the velocity has already been initialized
 		p.interpolateParameters();
@@ -432,24 +761,190 @@ namespace SPK
 			(*fbirth)(p);
 
 		if (boundingBoxEnabled)
-			updateAABB(p);
+		{
+			updateAABB(p.position(),AABBMin,AABBMax);
+			if (modifierCullingEnabled)
+				maxSqrVelocity = std::max(maxSqrVelocity,dotProduct(p.velocity(),p.velocity()));
+		}
 
 		if (distanceComputationEnabled)
 			p.computeSqrDist();
 	}
 
+	void Group::pushParticles(unsigned int nb,std::vector<EmitterData>::iterator& emitterIt)
+	{
+		// Activates the slots following the active particles
+		size_t begin = pool.getNbActive();
+		size_t end = begin + std::min<size_t>(nb,pool.getNbInactive() + pool.getNbEmpty());
+		for (size_t i = begin; i < end; ++i)
+			if (pool.makeActive() == NULL)
+			{
+				Particle p(this,i);
+				pool.pushActive(p);
+			}
+
+		// Launches the particles of each emitter at once
+		while (begin < end)
+		{
+			size_t nbEmitted = std::min<size_t>(emitterIt->nbParticles,end - begin);
+			launchParticles(begin,begin + nbEmitted,*emitterIt->emitter);
+			begin += nbEmitted;
+
+			emitterIt->nbParticles -= static_cast<unsigned int>(nbEmitted);
+			if (emitterIt->nbParticles == 0)
+				++emitterIt;
+		}
+	}
+
+	void Group::launchParticles(size_t begin,size_t end,const Emitter& emitter)
+	{
+		// This is the same as launchParticle for each particle but each step is performed on the whole range
+		Particle::initParticles(*this,begin,end);
+
+		emitter.emitBatch(*this,begin,end);
+		std::copy(particleData.positions + begin,particleData.positions + end,particleData.oldPositions + begin);
+
+		for (std::vector<Buffer*>::const_iterator it = swappableBuffers.begin(); it != swappableBuffers.end(); ++it)
+			for (size_t i = begin; i < end; ++i)
+				(*it)->reset(i);
+
+		std::vector<float> xs;
+		interpolateParameters(begin,end,xs);
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			Particle& p = pool[i];
+
+			if (fbirth != NULL)
+				(*fbirth)(p);
+
+			if (boundingBoxEnabled)
+			{
+				updateAABB(p.position(),AABBMin,AABBMax);
+				if (modifierCullingEnabled)
+					maxSqrVelocity = std::max(maxSqrVelocity,dotProduct(p.velocity(),p.velocity()));
+			}
+
+			if (distanceComputationEnabled)
+				p.computeSqrDist();
+		}
+	}
+
 	void Group::render()
 	{
+		if (outputSink != NULL)
+			outputSink->write(*this);
+
 		if ((renderer == NULL)||(!renderer->isActive()))
 			return;
 
 		renderer->render(*this);
 	}
 
+	void Group::enableSnapshot(bool snapshot)
+	{
+		if (snapshot == (snapshots != NULL))
+			return;
+
+		publishedSnapshot = NULL;
+		delete[] snapshots;
+		snapshots = snapshot ? new GroupSnapshot[2] : NULL;
+	}
+
+	const GroupSnapshot* Group::acquireSnapshot() const
+	{
+		// The snapshot is held before checking it is still the published one :
+		// either the update trying to write it sees the reader and gives up, or the reader sees the other snapshot published and tries again
+		while (true)
+		{
+			GroupSnapshot* snapshot = publishedSnapshot;
+			if (snapshot == NULL)
+				return NULL;
+
+			++snapshot->nbReaders;
+			if (publishedSnapshot == snapshot)
+				return snapshot;
+			--snapshot->nbReaders;
+		}
+	}
+
+	void Group::releaseSnapshot(const GroupSnapshot* snapshot) const
+	{
+		--snapshot->nbReaders;
+	}
+
+	void Group::publishSnapshot()
+	{
+		GroupSnapshot* front = publishedSnapshot;
+		GroupSnapshot* back = front == snapshots ? snapshots + 1 : snapshots;
+
+		// A reader still holds the snapshot to write, the previous one stays published
+		if (back->nbReaders != 0)
+			return;
+
+		// Without Renderer, all the data are copied
+		int channels = SNAPSHOT_POSITIONS | SNAPSHOT_VELOCITIES | SNAPSHOT_SORTED_INDICES | SNAPSHOT_AABB;
+		int params = ~0;
+		if (renderer != NULL)
+		{
+			channels = renderer->getSnapshotChannels();
+			params = renderer->getSnapshotParams();
+		}
+
+		size_t nbParticles = pool.getNbActive();
+		back->number = front != NULL ? front->number + 1 : 0;
+		back->nbParticles = nbParticles;
+		back->channels = 0;
+		back->params = 0;
+
+		if ((channels & SNAPSHOT_POSITIONS) != 0)
+		{
+			back->positions.assign(particleData.positions,particleData.positions + nbParticles);
+			back->channels |= SNAPSHOT_POSITIONS;
+		}
+
+		if ((channels & SNAPSHOT_VELOCITIES) != 0)
+		{
+			back->velocities.assign(particleData.velocities,particleData.velocities + nbParticles);
+			back->channels |= SNAPSHOT_VELOCITIES;
+		}
+
+		if (((channels & SNAPSHOT_SORTED_INDICES) != 0)&&(getSortedIndices() != NULL))
+		{
+			back->sortedIndices.assign(getSortedIndices(),getSortedIndices() + nbParticles);
+			back->channels |= SNAPSHOT_SORTED_INDICES;
+		}
+
+		if (((channels & SNAPSHOT_AABB) != 0)&&(boundingBoxEnabled))
+		{
+			back->AABBMin = AABBMin;
+			back->AABBMax = AABBMax;
+			back->channels |= SNAPSHOT_AABB;
+		}
+		else
+		{
+			back->AABBMin = vec3(0.0f,0.0f,0.0f);
+			back->AABBMax = vec3(0.0f,0.0f,0.0f);
+		}
+
+		for (size_t i = 0; i < Model::NB_PARAMS; ++i)
+		{
+			ModelParam param = static_cast<ModelParam>(i);
+			if (((params & (1 << i)) != 0)&&(model->isEnabled(param)))
+			{
+				const float* values = particleData.currentParams + model->getParameterOffset(param) * particleData.pitch;
+				back->paramValues[i].assign(values,values + nbParticles);
+				back->params |= 1 << i;
+			}
+		}
+
+		publishedSnapshot = back;
+	}
+
 	void Group::empty()
 	{
 		for (size_t i = 0; i < pool.getNbActive(); ++i)
-			particleData[i].sqrDist = 0.0f;
+			particleData.sqrDists[i] = 0.0f;
 
 		pool.makeAllInactive();
 		creationBuffer.clear();
@@ -539,7 +1034,7 @@ namespace SPK
 		computeDistances();
 
 		if (sortingEnabled)
-			sortParticles(0,pool.getNbActive() - 1);
+			sortActiveParticles();
 	}
 
 	void Group::computeDistances()
@@ -567,7 +1062,7 @@ namespace SPK
 
 		Pool<Particle>::iterator endIt = pool.end();
 		for (Pool<Particle>::iterator it = pool.begin(); it != endIt; ++it)
-			updateAABB(*it);
+			updateAABB(it->position(),AABBMin,AABBMax);
 	}
 
 	void Group::reallocate(size_t capacity)
@@ -576,29 +1071,14 @@ namespace SPK
 		{
 			pool.reallocate(capacity);
 
-			Particle::ParticleData* newData = new Particle::ParticleData[pool.getNbReserved()];
-			float* newCurrentParams = new float[pool.getNbReserved() * model->getSizeOfParticleCurrentArray()];
-			float* newExtendedParams = new float[pool.getNbReserved() * model->getSizeOfParticleExtendedArray()];
-
-			std::memcpy(newData,particleData,pool.getNbTotal() * sizeof(Particle::ParticleData));
-			std::memcpy(newCurrentParams,particleCurrentParams,pool.getNbTotal() * sizeof(float) * model->getSizeOfParticleCurrentArray());
-			std::memcpy(newExtendedParams,particleExtendedParams,pool.getNbTotal() * sizeof(float) * model->getSizeOfParticleExtendedArray());
+			// the particles keep pointing to particleData so only the arrays have to be moved
+			Particle::ParticleData oldData = particleData;
+			allocateParticleData(pool.getNbReserved());
+			copyParticleData(oldData,pool.getNbTotal());
 
-			delete[] particleData;
-			delete[] particleCurrentParams;
-			delete[] particleExtendedParams;
-
-			particleData = newData;
-			particleCurrentParams = newCurrentParams;
-			particleExtendedParams = newExtendedParams;
-
-			for (Pool<Particle>::iterator it = pool.begin(); it != pool.endInactive(); ++it)
-			{
-				it->group = this;
-				it->data = particleData + it->index;
-				it->currentParams = particleCurrentParams + it->index * model->getSizeOfParticleCurrentArray();
-				it->extendedParams = particleExtendedParams + it->index * model->getSizeOfParticleExtendedArray();
-			}
+			std::swap(oldData,particleData);
+			releaseParticleData();
+			particleData = oldData;
 
 			// Destroys all the buffers
 			destroyAllBuffers();
@@ -614,9 +1094,8 @@ namespace SPK
 			creationBuffer.pop_front();
 	}
 
-	void Group::updateAABB(const Particle& particle)
+	void Group::updateAABB(const vec3& position,vec3& AABBMin,vec3& AABBMax)
 	{
-		const vec3& position = particle.position();
 		if (AABBMin.x > position.x)
 			AABBMin.x = position.x;
 		if (AABBMin.y > position.y)
@@ -633,12 +1112,12 @@ namespace SPK
 
 	const void* Group::getParamAddress(ModelParam param) const
 	{
-		return particleCurrentParams + model->getParameterOffset(param);
+		return particleData.currentParams + model->getParameterOffset(param) * particleData.pitch;
 	}
 
 	size_t Group::getParamStride() const
 	{
-		return model->getSizeOfParticleCurrentArray() * sizeof(float);
+		return sizeof(float);
 	}
 
 	Buffer* Group::createBuffer(const std::string& ID,const BufferCreator& creator,unsigned int flag,bool swapEnabled) const
@@ -652,7 +1131,7 @@ namespace SPK
 
 		additionalBuffers.insert(std::pair<std::string,Buffer*>(ID,buffer));
 		if (swapEnabled)
-			swappableBuffers.insert(buffer);
+			swappableBuffers.push_back(buffer);
 
 		return buffer;
 	}
@@ -664,7 +1143,7 @@ namespace SPK
 		if (it != additionalBuffers.end())
 		{
 			if (it->second->isSwapEnabled())
-				swappableBuffers.erase(it->second);
+				swappableBuffers.erase(std::find(swappableBuffers.begin(),swappableBuffers.end(),it->second));
 			delete it->second;
 			additionalBuffers.erase(it);
 
@@ -709,19 +1188,60 @@ namespace SPK
 		return bufferManagement;
 	}
 
+	void Group::sortActiveParticles()
+	{
+		sortingStats.path = SORTING_PATH_NONE;
+		sortingStats.nbNewBorns = 0;
+		sortingStats.nbMoves = 0;
+
+		switch(sortingMode)
+		{
+		case SORTING_INDICES :
+			radixSortParticles();
+			sortingStats.path = SORTING_PATH_FULL;
+			break;
+
+		case SORTING_GATHER :
+		case SORTING_INCREMENTAL :
+			if (pool.getNbActive() > 1)
+			{
+				// Only the particles within [begin,end[ are moved
+				size_t begin = 0;
+				size_t end = pool.getNbActive();
+				if ((sortingMode != SORTING_INCREMENTAL)||(!incrementalSortParticles(begin,end)))
+				{
+					radixSortParticles();
+					sortingStats.path = SORTING_PATH_FULL;
+				}
+				if (begin < end)
+					gatherParticles(begin,end);
+			}
+			break;
+
+		default :
+			if (pool.getNbActive() > 1)
+			{
+				sortParticles(0,pool.getNbActive() - 1);
+				sortingStats.path = SORTING_PATH_FULL;
+			}
+			break;
+		}
+	}
+
 	void Group::sortParticles(int start,int end)
 	{
 		if (start < end)
 		{
 			int i = start - 1;
 			int j = end + 1;
-			float pivot = particleData[(start + end) >> 1].sqrDist;
+			const float* sqrDists = particleData.sqrDists;
+			float pivot = sqrDists[(start + end) >> 1];
 			while (true)
 			{
 				do ++i;
-				while (particleData[i].sqrDist > pivot);
+				while (sqrDists[i] > pivot);
 				do --j;
-				while (particleData[j].sqrDist < pivot);
+				while (sqrDists[j] < pivot);
 				if (i < j)
 					swapParticles(pool[i],pool[j]);
 				else break;
@@ -732,6 +1252,223 @@ namespace SPK
 		}
 	}
 
+	void Group::radixSortParticles()
+	{
+		const size_t RADIX_BITS = 11;
+		const size_t NB_BUCKETS = 1 << RADIX_BITS;
+		const size_t NB_PASSES = 3; // 3 passes of 11 bits cover the 32 bits of the keys
+
+		size_t nb = pool.getNbActive();
+		sortedIndices.resize(nb);
+		if (nb == 0)
+			return;
+
+		sortKeys.resize(nb);
+		radixKeys.resize(nb);
+		radixIndices.resize(nb);
+
+		// The bits of a positive float are ordered as the float itself
+		// They are inverted so that the particles are sorted from the furthest to the closest
+		std::memcpy(&sortKeys[0],particleData.sqrDists,nb * sizeof(unsigned int));
+
+		size_t counts[NB_PASSES][NB_BUCKETS] = {};
+		for (size_t i = 0; i < nb; ++i)
+		{
+			unsigned int key = ~sortKeys[i];
+			sortKeys[i] = key;
+			sortedIndices[i] = static_cast<unsigned int>(i);
+			for (size_t pass = 0; pass < NB_PASSES; ++pass)
+				++counts[pass][(key >> (pass * RADIX_BITS)) & (NB_BUCKETS - 1)];
+		}
+
+		unsigned int* keys = &sortKeys[0];
+		unsigned int* indices = &sortedIndices[0];
+		unsigned int* otherKeys = &radixKeys[0];
+		unsigned int* otherIndices = &radixIndices[0];
+
+		for (size_t pass = 0; pass < NB_PASSES; ++pass)
+		{
+			size_t shift = pass * RADIX_BITS;
+			size_t* passCounts = counts[pass];
+
+			// the pass is skipped if all the keys have the same digit
+			if (passCounts[(keys[0] >> shift) & (NB_BUCKETS - 1)] == nb)
+				continue;
+
+			size_t offset = 0;
+			for (size_t i = 0; i < NB_BUCKETS; ++i)
+			{
+				size_t count = passCounts[i];
+				passCounts[i] = offset;
+				offset += count;
+			}
+
+			for (size_t i = 0; i < nb; ++i)
+			{
+				size_t destination = passCounts[(keys[i] >> shift) & (NB_BUCKETS - 1)]++;
+				otherKeys[destination] = keys[i];
+				otherIndices[destination] = indices[i];
+			}
+
+			std::swap(keys,otherKeys);
+			std::swap(indices,otherIndices);
+		}
+
+		if (indices != &sortedIndices[0])
+			sortedIndices.swap(radixIndices);
+	}
+
+	bool Group::incrementalSortParticles(size_t& begin,size_t& end)
+	{
+		size_t nb = pool.getNbActive();
+		sortEntries.resize(nb);
+		unsigned long long* entries = &sortEntries[0];
+
+		// The keys are the inverted bits of the square distances (see radixSortParticles())
+		// Each entry holds the key in its upper bits and the index in its lower bits
+		// The particles left are in the order of the previous sort and are placed first, the newborn ones are placed last
+		size_t nbOld = 0;
+		size_t nbNew = 0;
+		for (size_t i = 0; i < nb; ++i)
+		{
+			unsigned int key;
+			std::memcpy(&key,particleData.sqrDists + i,sizeof(unsigned int));
+			unsigned long long entry = (static_cast<unsigned long long>(~key) << 32) | i;
+
+			if (particleData.ages[i] == 0.0f)
+				entries[nb - ++nbNew] = entry;
+			else
+				entries[nbOld++] = entry;
+		}
+
+		// Insertion sort of the particles left, given up when they are too much out of order
+		size_t maxMoves = nbOld * INCREMENTAL_SORT_MAX_MOVES;
+		size_t nbMoves = 0;
+		for (size_t i = 1; i < nbOld; ++i)
+		{
+			unsigned long long entry = entries[i];
+			size_t j = i;
+			while ((j > 0)&&(entries[j - 1] > entry))
+			{
+				entries[j] = entries[j - 1];
+				--j;
+			}
+			entries[j] = entry;
+
+			nbMoves += i - j;
+			if (nbMoves > maxMoves)
+				return false;
+		}
+
+		// The newborn particles are sorted apart and merged
+		std::sort(entries + nbOld,entries + nb);
+
+		sortedIndices.resize(nb);
+		size_t oldIndex = 0;
+		size_t newIndex = nbOld;
+		for (size_t i = 0; i < nb; ++i)
+		{
+			if ((newIndex == nb)||((oldIndex < nbOld)&&(entries[oldIndex] < entries[newIndex])))
+				sortedIndices[i] = static_cast<unsigned int>(entries[oldIndex++]);
+			else
+				sortedIndices[i] = static_cast<unsigned int>(entries[newIndex++]);
+		}
+
+		// The particles already in place at both ends are left untouched
+		begin = 0;
+		while ((begin < nb)&&(sortedIndices[begin] == begin))
+			++begin;
+		end = nb;
+		while ((end > begin)&&(sortedIndices[end - 1] == end - 1))
+			--end;
+
+		sortingStats.path = SORTING_PATH_INCREMENTAL;
+		sortingStats.nbNewBorns = nbNew;
+		sortingStats.nbMoves = nbMoves;
+		return true;
+	}
+
+	template<typename T>
+	static void gatherArray(T* data,const unsigned int* indices,size_t begin,size_t end,T* buffer)
+	{
+		for (size_t i = begin; i < end; ++i)
+			buffer[i - begin] = data[indices[i]];
+		std::memcpy(data + begin,buffer,(end - begin) * sizeof(T));
+	}
+
+	void Group::gatherParticles(size_t begin,size_t end)
+	{
+		const unsigned int* indices = &sortedIndices[0];
+
+		gatherBuffer.resize((end - begin) * 3);
+		float* floatBuffer = &gatherBuffer[0];
+		vec3* vectorBuffer = reinterpret_cast<vec3*>(floatBuffer);
+
+		gatherArray(particleData.oldPositions,indices,begin,end,vectorBuffer);
+		gatherArray(particleData.positions,indices,begin,end,vectorBuffer);
+		gatherArray(particleData.velocities,indices,begin,end,vectorBuffer);
+		gatherArray(particleData.ages,indices,begin,end,floatBuffer);
+		gatherArray(particleData.lives,indices,begin,end,floatBuffer);
+		gatherArray(particleData.sqrDists,indices,begin,end,floatBuffer);
+
+		for (size_t i = 0; i < model->getSizeOfParticleCurrentArray(); ++i)
+			gatherArray(particleData.currentParams + i * particleData.pitch,indices,begin,end,floatBuffer);
+		for (size_t i = 0; i < model->getSizeOfParticleExtendedArray(); ++i)
+			gatherArray(particleData.extendedParams + i * particleData.pitch,indices,begin,end,floatBuffer);
+
+		for (std::vector<Buffer*>::const_iterator it = swappableBuffers.begin(); it != swappableBuffers.end(); ++it)
+			(*it)->applyPermutation(indices,begin,end);
+	}
+
+	void Group::allocateParticleData(size_t capacity)
+	{
+		// the number of elements of each array is rounded up so that any array starts on an aligned address
+		const size_t nbFloatsPerBlock = DATA_ALIGNMENT / sizeof(float);
+		size_t pitch = (capacity + nbFloatsPerBlock - 1) / nbFloatsPerBlock * nbFloatsPerBlock;
+
+		particleData.group = this;
+		particleData.randomGenerator = &randomGenerator;
+		particleData.pitch = pitch;
+
+		particleData.oldPositions = static_cast<vec3*>(allocateAligned(pitch * sizeof(vec3)));
+		particleData.positions = static_cast<vec3*>(allocateAligned(pitch * sizeof(vec3)));
+		particleData.velocities = static_cast<vec3*>(allocateAligned(pitch * sizeof(vec3)));
+		particleData.ages = static_cast<float*>(allocateAligned(pitch * sizeof(float)));
+		particleData.lives = static_cast<float*>(allocateAligned(pitch * sizeof(float)));
+		particleData.sqrDists = static_cast<float*>(allocateAligned(pitch * sizeof(float)));
+
+		particleData.currentParams = static_cast<float*>(allocateAligned(pitch * model->getSizeOfParticleCurrentArray() * sizeof(float)));
+		particleData.extendedParams = static_cast<float*>(allocateAligned(pitch * model->getSizeOfParticleExtendedArray() * sizeof(float)));
+	}
+
+	void Group::releaseParticleData()
+	{
+		releaseAligned(particleData.oldPositions);
+		releaseAligned(particleData.positions);
+		releaseAligned(particleData.velocities);
+		releaseAligned(particleData.ages);
+		releaseAligned(particleData.lives);
+		releaseAligned(particleData.sqrDists);
+		releaseAligned(particleData.currentParams);
+		releaseAligned(particleData.extendedParams);
+	}
+
+	void Group::copyParticleData(const Particle::ParticleData& src,size_t nb)
+	{
+		std::memcpy(particleData.oldPositions,src.oldPositions,nb * sizeof(vec3));
+		std::memcpy(particleData.positions,src.positions,nb * sizeof(vec3));
+		std::memcpy(particleData.velocities,src.velocities,nb * sizeof(vec3));
+		std::memcpy(particleData.ages,src.ages,nb * sizeof(float));
+		std::memcpy(particleData.lives,src.lives,nb * sizeof(float));
+		std::memcpy(particleData.sqrDists,src.sqrDists,nb * sizeof(float));
+
+		// pitches may differ so parameters are copied array by array
+		for (size_t i = 0; i < model->getSizeOfParticleCurrentArray(); ++i)
+			std::memcpy(particleData.currentParams + i * particleData.pitch,src.currentParams + i * src.pitch,nb * sizeof(float));
+		for (size_t i = 0; i < model->getSizeOfParticleExtendedArray(); ++i)
+			std::memcpy(particleData.extendedParams + i * particleData.pitch,src.extendedParams + i * src.pitch,nb * sizeof(float));
+	}
+
 	void Group::propagateUpdateTransform()
 	{
 		for (std::vector<Emitter*>::const_iterator emitterIt = emitters.begin(); emitterIt != emitters.end(); ++emitterIt)
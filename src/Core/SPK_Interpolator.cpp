@@ -23,10 +23,16 @@
 #include "Core/SPK_Interpolator.h"
 #include "Core/SPK_Model.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Kernel.h"
+
+#include <mutex>
 
 
 namespace SPK
 {
+	// Mutex protecting the building of the data of the interpolators
+	static std::mutex dataMutex;
+
 	Interpolator::computeXFn Interpolator::COMPUTE_X_FN[4] =
 	{
 		&Interpolator::computeXLifeTime,
@@ -41,7 +47,28 @@ namespace SPK
 		param(PARAM_SIZE),
 		scaleXVariation(0.0f),
 		offsetXVariation(0.0f),
-		loopingEnabled(false)
+		loopingEnabled(false),
+		bakingEnabled(false),
+		bakingResolution(256),
+		entries(),
+		bakedEntries(),
+		bakedScaleX(0.0f),
+		dataOutdated(true)
+	{}
+
+	Interpolator::Interpolator(const Interpolator& interpolator) :
+		graph(interpolator.graph),
+		type(interpolator.type),
+		param(interpolator.param),
+		loopingEnabled(interpolator.loopingEnabled),
+		scaleXVariation(interpolator.scaleXVariation),
+		offsetXVariation(interpolator.offsetXVariation),
+		bakingEnabled(interpolator.bakingEnabled),
+		bakingResolution(interpolator.bakingResolution),
+		entries(),
+		bakedEntries(),
+		bakedScaleX(0.0f),
+		dataOutdated(true)
 	{}
 
 	float Interpolator::computeXLifeTime(const Particle& particle) const
@@ -67,44 +94,82 @@ namespace SPK
 
 	float Interpolator::interpolate(const Particle& particle,ModelParam interpolatedParam,float ratioY,float offsetX,float scaleX)
 	{
+		if (dataOutdated.load(std::memory_order_acquire))
+			updateData();
+
+		// If the graph has less than 2 entries, the value does not depend on x
+		if (entries.size() < 2)
+		{
+			if (entries.empty())
+				return Model::getDefaultValue(interpolatedParam);
+			else
+				return interpolateY(entries.front(),ratioY);
+		}
+
 		// First finds the current X of the particle
-		InterpolatorEntry currentKey((this->*Interpolator::COMPUTE_X_FN[type])(particle));
-		currentKey.x += offsetX; // Offsets it
-		currentKey.x *= scaleX;  // Scales it
+		float x = (this->*Interpolator::COMPUTE_X_FN[type])(particle);
+		x += offsetX; // Offsets it
+		x *= scaleX;  // Scales it
 
 		if (loopingEnabled)
+			x = loopX(x);
+
+		if (bakingEnabled)
+			return interpolateBakedEntries(x,ratioY);
+		else
+			return interpolateEntries(x,ratioY);
+	}
+
+	void Interpolator::interpolate(float* values,const float* xs,const float* ratiosY,const float* offsetsX,const float* scalesX,size_t nb,ModelParam interpolatedParam)
+	{
+		if (dataOutdated.load(std::memory_order_acquire))
+			updateData();
+
+		// If the graph has less than 2 entries, the values do not depend on x
+		if (entries.size() < 2)
+		{
+			if (entries.empty())
+				std::fill(values,values + nb,Model::getDefaultValue(interpolatedParam));
+			else
+				for (size_t i = 0; i < nb; ++i)
+					values[i] = interpolateY(entries.front(),ratiosY[i]);
+		}
+		else if (bakingEnabled)
 		{
-			// If the graph has les than 2 entries, we cannot loop
-			if (graph.size() < 2)
+			for (size_t i = 0; i < nb; ++i)
 			{
-				if (graph.empty())
-					return Model::getDefaultValue(interpolatedParam);
-				else
-					return interpolateY(*(graph.begin()),ratioY);
+				float x = (xs[i] + offsetsX[i]) * scalesX[i];
+				if (loopingEnabled)
+					x = loopX(x);
+				values[i] = interpolateBakedEntries(x,ratiosY[i]);
 			}
-
-			// Else finds the current X in the range
-			const float beginX = graph.begin()->x;
-			const float rangeX = graph.rbegin()->x - beginX;
-			float newX = (currentKey.x - beginX) / rangeX;
-			newX -= static_cast<int>(newX);
-			if (newX < 0.0f)
-				newX = 1.0f + newX;
-			currentKey.x = beginX + newX * rangeX;
 		}
+		else
+			interpolateValues(values,xs,offsetsX,scalesX,ratiosY,nb,&entries[0],entries.size(),loopingEnabled);
+	}
+
+	float Interpolator::loopX(float x) const
+	{
+		// Finds the current X in the range
+		const float beginX = entries.front().x;
+		const float rangeX = entries.back().x - beginX;
+		float newX = (x - beginX) / rangeX;
+		newX -= static_cast<int>(newX);
+		if (newX < 0.0f)
+			newX = 1.0f + newX;
+		return beginX + newX * rangeX;
+	}
 
+	float Interpolator::interpolateEntries(float x,float ratioY) const
+	{
 		// Gets the entry that is immediatly after the current X
-		std::set<InterpolatorEntry>::const_iterator nextIt = graph.upper_bound(currentKey);
+		std::vector<InterpolatorEntry>::const_iterator nextIt = std::upper_bound(entries.begin(),entries.end(),InterpolatorEntry(x));
 
-		// If the current X is higher than the one of the last entry
-		if (nextIt == graph.end())
+		if (nextIt == entries.end()) // If the current X is higher than the one of the last entry, sets the value of the last entry
 		{
-			if (graph.empty())	// If the graph has no entry, sets the default value
-				return Model::getDefaultValue(interpolatedParam);
-			else	// Else sets the value of the last entry
-				return interpolateY(*(--nextIt),ratioY);
+			return interpolateY(entries.back(),ratioY);
 		}
-		else if (nextIt == graph.begin()) // If the current X is lower than the first entry, sets the value to the first entry
+		else if (nextIt == entries.begin()) // If the current X is lower than the first entry, sets the value to the first entry
 		{
 			return interpolateY(*nextIt,ratioY);
 		}
@@ -115,11 +180,57 @@ namespace SPK
 			float y0 = interpolateY(previousEntry,ratioY);
 			float y1 = interpolateY(nextEntry,ratioY);
 
-			float ratioX = (currentKey.x - previousEntry.x) / (nextEntry.x - previousEntry.x);
+			float ratioX = (x - previousEntry.x) / (nextEntry.x - previousEntry.x);
 			return y0 + ratioX * (y1 - y0);
 		}
 	}
 
+	float Interpolator::interpolateBakedEntries(float x,float ratioY) const
+	{
+		// The current X is clamped to the range of the table
+		float position = (x - bakedEntries.front().x) * bakedScaleX;
+		if (!(position > 0.0f))
+			return interpolateY(bakedEntries.front(),ratioY);
+
+		size_t index = static_cast<size_t>(position);
+		if (index >= bakedEntries.size() - 1)
+			return interpolateY(bakedEntries.back(),ratioY);
+
+		// Interpolates between the samples before and after the current X
+		float y0 = interpolateY(bakedEntries[index],ratioY);
+		float y1 = interpolateY(bakedEntries[index + 1],ratioY);
+		return y0 + (position - index) * (y1 - y0);
+	}
+
+	void Interpolator::updateData()
+	{
+		// The data is only built by one thread, the others wait for it to be ready
+		std::lock_guard<std::mutex> lock(dataMutex);
+		if (!dataOutdated.load(std::memory_order_relaxed))
+			return;
+
+		entries.assign(graph.begin(),graph.end());
+
+		// Resamples the graph at regularly spaced x
+		bakedEntries.clear();
+		if ((bakingEnabled)&&(entries.size() >= 2))
+		{
+			const float beginX = entries.front().x;
+			const float rangeX = entries.back().x - beginX;
+
+			bakedEntries.resize(bakingResolution);
+			for (size_t i = 0; i < bakingResolution; ++i)
+			{
+				float x = i < bakingResolution - 1 ? beginX + rangeX * i / (bakingResolution - 1) : entries.back().x;
+				bakedEntries[i] = InterpolatorEntry(x,interpolateEntries(x,0.0f),interpolateEntries(x,1.0f));
+			}
+
+			bakedScaleX = (bakingResolution - 1) / rangeX;
+		}
+
+		dataOutdated.store(false,std::memory_order_release);
+	}
+
 	void Interpolator::generateSinCurve(float period,float amplitudeMin,float amplitudeMax,float offsetX,float offsetY,float startX,unsigned int length,unsigned int nbSamples)
 	{
 		// First clear any previous entry
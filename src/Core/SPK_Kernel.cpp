@@ -0,0 +1,1857 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "Core/SPK_Kernel.h"
+#include "Core/SPK_Model.h"
+#include "Core/SPK_RandomGenerator.h"
+
+#if !defined(SPK_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#define SPK_X86_KERNELS
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Allows to compile a function for an instruction set that is not enabled for the whole library
+// A scalar kernel finishing the work of the AVX-512 kernels must not be inlined in them :
+// AVX-512 having FMA instructions, its multiplications and additions could be fused and give different results
+#if defined(__GNUC__) || defined(__clang__)
+#define SPK_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#define SPK_NO_INLINE __attribute__((noinline))
+#else
+#define SPK_TARGET(instructionSet)
+#define SPK_NO_INLINE
+#endif
+
+// The multiplications and additions must not be fused in FMA instructions by the compiler,
+// as they would be in some kernels and not in others depending on the instruction sets enabled (-march=native for instance)
+#if defined(__clang__)
+#pragma float_control(push)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma float_control(push)
+#pragma fp_contract(off)
+#endif
+
+
+namespace SPK
+{
+	// The kernels parse the arrays of vec3 as arrays of floats (a vec3 is made of 3 tightly packed floats)
+	typedef void (*IntegrationKernel)(float*,float*,float*,size_t,const vec3&,float);
+	typedef void (*FrictionKernel)(float*,const float*,size_t,float);
+	typedef void (*RandomKernel)(float*,size_t,unsigned int,float,float);
+	typedef void (*InterpolationKernel)(float*,const float*,const float*,const float*,const float*,size_t,const InterpolatorEntry*,size_t,bool);
+	typedef void (*SphereContainmentKernel)(const float*,size_t,const vec3&,float,unsigned char*);
+	typedef void (*HalfSpaceContainmentKernel)(const float*,size_t,const vec3&,const vec3&,unsigned char*);
+	typedef void (*BoxContainmentKernel)(const float*,size_t,const vec3&,const vec3&,unsigned char*);
+	typedef void (*CylinderContainmentKernel)(const float*,size_t,const vec3&,const vec3&,float,float,unsigned char*);
+	typedef void (*BoxIntersectionKernel)(const float*,const float*,size_t,const vec3&,const vec3&,unsigned char*);
+	typedef void (*QuadExpansionKernel)(float*,const float*,const float*,const float*,const float* const*,const float* const*,size_t);
+	typedef void (*LineExpansionKernel)(float*,const float*,const float*,const float* const*,float,size_t);
+	typedef void (*PointPackingKernel)(float*,const float*,const float* const*,const float*,size_t);
+	typedef void (*HalfConversionKernel)(unsigned short*,const float*,size_t);
+	typedef void (*ColorQuantizationKernel)(unsigned char*,const float* const*,size_t);
+	typedef void (*AngleQuantizationKernel)(unsigned short*,const float*,size_t);
+	typedef void (*IndexQuantizationKernel)(unsigned char*,const float*,size_t);
+
+	// Converts the 24 upper bits of a hash to a float in [0,1[
+	static const float RANDOM_SCALE = 1.0f / 16777216.0f;
+	static const float TWO_PI = 6.2831853071795864769f;
+	static const size_t RANDOM_BLOCK_SIZE = 256; // Number of random numbers of each kind drawn at once
+
+	// Maximum number of entries of a graph processed by the SIMD interpolation kernels
+	static const size_t MAX_SIMD_INTERPOLATION_ENTRIES = 32;
+
+	// Number of floats of the vertices written by the geometry kernels
+	static const size_t QUAD_VERTEX_SIZE = 10;
+	static const size_t LINE_VERTEX_SIZE = 7;
+	static const size_t POINT_VERTEX_SIZE = 8;
+
+	// Signs of the side and up vectors and indices of the texture coordinates of the 4 vertices of a quad
+	static const float QUAD_SIDE_SIGNS[4] = {1.0f,-1.0f,-1.0f,1.0f};
+	static const float QUAD_UP_SIGNS[4] = {1.0f,1.0f,-1.0f,-1.0f};
+	static const size_t QUAD_U_INDICES[4] = {1,0,0,1};
+	static const size_t QUAD_V_INDICES[4] = {2,2,3,3};
+
+	// Bits used to convert floats to half floats (the floats are processed as their absolute value)
+	static const unsigned int FLOAT_INFINITY_BITS = 0x7f800000;
+	static const unsigned int HALF_OVERFLOW_BITS = 0x47800000;	// 65536, the first float rounded to an infinite half float
+	static const unsigned int HALF_MIN_NORMAL_BITS = 0x38800000;	// 2^-14, the smallest normal half float
+	static const unsigned int HALF_DENORMAL_BITS = 0x3f000000;	// 0.5, aligns the mantissa of a denormal half float on the one of the float
+	static const unsigned int HALF_REBIAS_BITS = 0xc8000fff;		// (15 - 127) << 23 to rebias the exponent plus the rounding of the 13 dropped bits
+	static const unsigned int HALF_INFINITY = 0x7c00;
+	static const unsigned int HALF_NAN = 0x7e00;
+
+	// Scale of the angles quantized on 16 bits and bound of the scaled angles so that they can be converted to int
+	static const float ANGLE_QUANTIZATION_SCALE = 65536.0f / TWO_PI;
+	static const float MAX_QUANTIZED_ANGLE = 1073741824.0f;
+
+	////////////////////
+	// Scalar kernels //
+	////////////////////
+
+	SPK_NO_INLINE static void integrateScalar(float* oldPositions,float* positions,float* velocities,size_t nb,const vec3& gravity,float deltaTime)
+	{
+		vec3* oldPositionIt = reinterpret_cast<vec3*>(oldPositions);
+		vec3* positionIt = reinterpret_cast<vec3*>(positions);
+		vec3* velocityIt = reinterpret_cast<vec3*>(velocities);
+		const vec3 gravityStep = gravity * deltaTime;
+
+		for (size_t i = 0; i < nb; ++i)
+		{
+			oldPositionIt[i] = positionIt[i];
+			positionIt[i] += velocityIt[i] * deltaTime;
+			velocityIt[i] += gravityStep;
+		}
+	}
+
+	SPK_NO_INLINE static void frictionScalar(float* velocities,const float* masses,size_t nb,float frictionStep)
+	{
+		vec3* velocityIt = reinterpret_cast<vec3*>(velocities);
+		for (size_t i = 0; i < nb; ++i)
+			velocityIt[i] *= 1.0f - std::min(1.0f,frictionStep / masses[i]);
+	}
+
+	// The random kernels take the first hashed counter (key + counter * COUNTER_STEP) rather than the key and the counter
+	SPK_NO_INLINE static void randomScalar(float* values,size_t nb,unsigned int hashedCounter,float min,float range)
+	{
+		for (size_t i = 0; i < nb; ++i)
+		{
+			unsigned int hash = RandomGenerator::hash(hashedCounter);
+			values[i] = min + static_cast<float>(hash >> 8) * RANDOM_SCALE * range;
+			hashedCounter += RandomGenerator::COUNTER_STEP;
+		}
+	}
+
+	// Follows the operations of Interpolator::interpolate(const Particle&,ModelParam,float,float,float)
+	SPK_NO_INLINE static void interpolateScalar(float* values,const float* xs,const float* offsetsX,const float* scalesX,const float* ratiosY,size_t nb,const InterpolatorEntry* entries,size_t nbEntries,bool looping)
+	{
+		const InterpolatorEntry* const endIt = entries + nbEntries;
+		const float beginX = entries[0].x;
+		const float rangeX = entries[nbEntries - 1].x - beginX;
+
+		for (size_t i = 0; i < nb; ++i)
+		{
+			float x = (xs[i] + offsetsX[i]) * scalesX[i];
+			if (looping)
+			{
+				float newX = (x - beginX) / rangeX;
+				newX -= static_cast<int>(newX);
+				if (newX < 0.0f)
+					newX = 1.0f + newX;
+				x = beginX + newX * rangeX;
+			}
+
+			const float ratioY = ratiosY[i];
+			const InterpolatorEntry* nextIt = std::upper_bound(entries,endIt,InterpolatorEntry(x));
+
+			if (nextIt == endIt)
+				values[i] = endIt[-1].y0 + (endIt[-1].y1 - endIt[-1].y0) * ratioY;
+			else if (nextIt == entries)
+				values[i] = nextIt->y0 + (nextIt->y1 - nextIt->y0) * ratioY;
+			else
+			{
+				const InterpolatorEntry* previousIt = nextIt - 1;
+				float y0 = previousIt->y0 + (previousIt->y1 - previousIt->y0) * ratioY;
+				float y1 = nextIt->y0 + (nextIt->y1 - nextIt->y0) * ratioY;
+				float ratioX = (x - previousIt->x) / (nextIt->x - previousIt->x);
+				values[i] = y0 + ratioX * (y1 - y0);
+			}
+		}
+	}
+
+	// The zone kernels follow the operations of the contains and intersects methods of the zones
+	static void testSphereContainmentScalar(const float* points,size_t nb,const vec3& center,float sqrRadius,unsigned char* results)
+	{
+		const vec3* pointIt = reinterpret_cast<const vec3*>(points);
+		for (size_t i = 0; i < nb; ++i)
+			results[i] = getSqrDist(center,pointIt[i]) <= sqrRadius ? 1 : 0;
+	}
+
+	static void testHalfSpaceContainmentScalar(const float* points,size_t nb,const vec3& position,const vec3& normal,unsigned char* results)
+	{
+		const vec3* pointIt = reinterpret_cast<const vec3*>(points);
+		for (size_t i = 0; i < nb; ++i)
+			results[i] = dotProduct(normal,pointIt[i] - position) <= 0.0f ? 1 : 0;
+	}
+
+	static void testBoxContainmentScalar(const float* points,size_t nb,const vec3& min,const vec3& max,unsigned char* results)
+	{
+		const vec3* pointIt = reinterpret_cast<const vec3*>(points);
+		for (size_t i = 0; i < nb; ++i)
+		{
+			const vec3& v = pointIt[i];
+			results[i] = ((v.x >= min.x)&&(v.x <= max.x)&&(v.y >= min.y)&&(v.y <= max.y)&&(v.z >= min.z)&&(v.z <= max.z)) ? 1 : 0;
+		}
+	}
+
+	static void testCylinderContainmentScalar(const float* points,size_t nb,const vec3& position,const vec3& direction,float halfLength,float radius,unsigned char* results)
+	{
+		const vec3* pointIt = reinterpret_cast<const vec3*>(points);
+		for (size_t i = 0; i < nb; ++i)
+		{
+			const vec3& v = pointIt[i];
+			float dist = dotProduct(direction,v - position);
+			vec3 ext = v - (direction * dist + position);
+			results[i] = ((dist <= halfLength)&&(dist >= -halfLength)&&(glm::length(ext) <= radius)) ? 1 : 0;
+		}
+	}
+
+	// The segment is clipped by the slabs of the 3 axis, it intersects the box if it is neither clipped out nor entirely inside
+	static void testBoxIntersectionScalar(const float* starts,const float* ends,size_t nb,const vec3& min,const vec3& max,unsigned char* results)
+	{
+		const vec3* startIt = reinterpret_cast<const vec3*>(starts);
+		const vec3* endIt = reinterpret_cast<const vec3*>(ends);
+		for (size_t i = 0; i < nb; ++i)
+		{
+			float tEnter = 0.0f;
+			float tExit = 1.0f;
+			bool intersects = true;
+
+			for (int axis = 0; (axis < 3)&&(intersects); ++axis)
+			{
+				float p0 = startIt[i][axis];
+				float dir = endIt[i][axis] - p0;
+
+				if (dir == 0.0f)
+				{
+					intersects = !((p0 < min[axis])||(p0 > max[axis]));
+					continue;
+				}
+
+				float t0 = (min[axis] - p0) / dir;
+				float t1 = (max[axis] - p0) / dir;
+				if (t0 > t1)
+					std::swap(t0,t1);
+
+				if ((t1 < tEnter)||(t0 > tExit))
+					intersects = false;
+				else
+				{
+					if (t0 > tEnter) tEnter = t0;
+					if (t1 < tExit) tExit = t1;
+				}
+			}
+
+			results[i] = ((intersects)&&((tEnter > 0.0f)||(tExit < 1.0f))) ? 1 : 0;
+		}
+	}
+
+	static void expandQuadsScalar(float* vertices,const float* positions,const float* sides,const float* ups,const float* const* colors,const float* const* textureCoords,size_t nb)
+	{
+		for (size_t i = 0; i < nb; ++i)
+			for (size_t j = 0; j < 4; ++j)
+			{
+				for (size_t k = 0; k < 3; ++k)
+					vertices[k] = positions[i * 3 + k] + QUAD_SIDE_SIGNS[j] * sides[i * 3 + k] + QUAD_UP_SIGNS[j] * ups[i * 3 + k];
+				for (size_t k = 0; k < 4; ++k)
+					vertices[3 + k] = colors[k][i];
+				vertices[7] = textureCoords[QUAD_U_INDICES[j]][i];
+				vertices[8] = textureCoords[QUAD_V_INDICES[j]][i];
+				vertices[9] = textureCoords[4][i];
+				vertices += QUAD_VERTEX_SIZE;
+			}
+	}
+
+	static void expandLinesScalar(float* vertices,const float* positions,const float* velocities,const float* const* colors,float length,size_t nb)
+	{
+		for (size_t i = 0; i < nb; ++i)
+			for (size_t j = 0; j < 2; ++j)
+			{
+				for (size_t k = 0; k < 3; ++k)
+					vertices[k] = j == 0 ? positions[i * 3 + k] : positions[i * 3 + k] + velocities[i * 3 + k] * length;
+				for (size_t k = 0; k < 4; ++k)
+					vertices[3 + k] = colors[k][i];
+				vertices += LINE_VERTEX_SIZE;
+			}
+	}
+
+	static void packPointsScalar(float* vertices,const float* positions,const float* const* colors,const float* sizes,size_t nb)
+	{
+		for (size_t i = 0; i < nb; ++i)
+		{
+			for (size_t k = 0; k < 3; ++k)
+				vertices[k] = positions[i * 3 + k];
+			for (size_t k = 0; k < 4; ++k)
+				vertices[3 + k] = colors[k][i];
+			vertices[7] = sizes[i];
+			vertices += POINT_VERTEX_SIZE;
+		}
+	}
+
+	// The conversions of single values are written as the SIMD code (min and max included) so that all the kernels give the same results
+
+	static inline unsigned short convertToHalfFloat(float value)
+	{
+		unsigned int bits;
+		std::memcpy(&bits,&value,sizeof(float));
+		unsigned int sign = (bits >> 16) & 0x8000;
+		bits &= 0x7fffffff;
+
+		unsigned int half;
+		if (bits >= HALF_OVERFLOW_BITS)
+			half = bits > FLOAT_INFINITY_BITS ? HALF_NAN : HALF_INFINITY;
+		else if (bits < HALF_MIN_NORMAL_BITS)
+		{
+			// the addition rounds the mantissa to the nearest even
+			float denormal;
+			std::memcpy(&denormal,&bits,sizeof(float));
+			denormal += 0.5f;
+			std::memcpy(&half,&denormal,sizeof(float));
+			half -= HALF_DENORMAL_BITS;
+		}
+		else
+			half = (bits + HALF_REBIAS_BITS + ((bits >> 13) & 1)) >> 13;
+
+		return static_cast<unsigned short>(half | sign);
+	}
+
+	static inline unsigned char quantizeUnorm8(float value)
+	{
+		value = value > 0.0f ? value : 0.0f;
+		value = value < 1.0f ? value : 1.0f;
+		return static_cast<unsigned char>(static_cast<int>(value * 255.0f + 0.5f));
+	}
+
+	static inline unsigned short quantizeAngle(float angle)
+	{
+		float value = angle * ANGLE_QUANTIZATION_SCALE + 0.5f;
+		value = value > -MAX_QUANTIZED_ANGLE ? value : -MAX_QUANTIZED_ANGLE;
+		value = value < MAX_QUANTIZED_ANGLE ? value : MAX_QUANTIZED_ANGLE;
+
+		int quantized = static_cast<int>(value);
+		if (static_cast<float>(quantized) > value) // floor of the negative values
+			--quantized;
+
+		return static_cast<unsigned short>(quantized & 0xffff);
+	}
+
+	static inline unsigned char quantizeIndex(float index)
+	{
+		index = index > 0.0f ? index : 0.0f;
+		index = index < 255.0f ? index : 255.0f;
+		return static_cast<unsigned char>(static_cast<int>(index));
+	}
+
+	static void convertToHalfFloatsScalar(unsigned short* halves,const float* values,size_t nb)
+	{
+		for (size_t i = 0; i < nb; ++i)
+			halves[i] = convertToHalfFloat(values[i]);
+	}
+
+	static void quantizeColorsScalar(unsigned char* colors,const float* const* components,size_t nb)
+	{
+		for (size_t i = 0; i < nb; ++i)
+			for (size_t k = 0; k < 4; ++k)
+				*(colors++) = quantizeUnorm8(components[k][i]);
+	}
+
+	static void quantizeAnglesScalar(unsigned short* angles,const float* values,size_t nb)
+	{
+		for (size_t i = 0; i < nb; ++i)
+			angles[i] = quantizeAngle(values[i]);
+	}
+
+	static void quantizeIndicesScalar(unsigned char* indices,const float* values,size_t nb)
+	{
+		for (size_t i = 0; i < nb; ++i)
+			indices[i] = quantizeIndex(values[i]);
+	}
+
+#ifdef SPK_X86_KERNELS
+
+	// Fills the patterns used to process the xyz components of a block of particles with registers of width floats
+	// As the pattern repeats every 3 floats, a block of width particles fits in 3 registers
+	static void fillGravityPattern(float* pattern,size_t width,const vec3& gravityStep)
+	{
+		const float components[3] = {gravityStep.x,gravityStep.y,gravityStep.z};
+		for (size_t i = 0; i < width * 3; ++i)
+			pattern[i] = components[i % 3];
+	}
+
+	static void fillFrictionPattern(int* pattern,size_t width)
+	{
+		for (size_t i = 0; i < width * 3; ++i)
+			pattern[i] = static_cast<int>(i / 3);
+	}
+
+	//////////////////
+	// SSE2 kernels //
+	//////////////////
+
+	SPK_TARGET("sse2") static void integrateSSE2(float* oldPositions,float* positions,float* velocities,size_t nb,const vec3& gravity,float deltaTime)
+	{
+		float pattern[12];
+		fillGravityPattern(pattern,4,gravity * deltaTime);
+		const __m128 gravityStep[3] = {_mm_loadu_ps(pattern),_mm_loadu_ps(pattern + 4),_mm_loadu_ps(pattern + 8)};
+		const __m128 step = _mm_set1_ps(deltaTime);
+
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks * 12; i += 12)
+			for (size_t j = 0; j < 3; ++j)
+			{
+				size_t offset = i + (j << 2);
+				__m128 position = _mm_loadu_ps(positions + offset);
+				__m128 velocity = _mm_loadu_ps(velocities + offset);
+				_mm_storeu_ps(oldPositions + offset,position);
+				_mm_storeu_ps(positions + offset,_mm_add_ps(position,_mm_mul_ps(velocity,step)));
+				_mm_storeu_ps(velocities + offset,_mm_add_ps(velocity,gravityStep[j]));
+			}
+
+		size_t offset = nbBlocks * 12;
+		integrateScalar(oldPositions + offset,positions + offset,velocities + offset,nb - (nbBlocks << 2),gravity,deltaTime);
+	}
+
+	SPK_TARGET("sse2") static void frictionSSE2(float* velocities,const float* masses,size_t nb,float frictionStep)
+	{
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 step = _mm_set1_ps(frictionStep);
+
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m128 factor = _mm_sub_ps(one,_mm_min_ps(_mm_div_ps(step,_mm_loadu_ps(masses + (i << 2))),one));
+			float* velocityIt = velocities + i * 12;
+
+			// dispatches the factors of the 4 particles on their xyz components
+			_mm_storeu_ps(velocityIt,_mm_mul_ps(_mm_loadu_ps(velocityIt),_mm_shuffle_ps(factor,factor,_MM_SHUFFLE(1,0,0,0))));
+			_mm_storeu_ps(velocityIt + 4,_mm_mul_ps(_mm_loadu_ps(velocityIt + 4),_mm_shuffle_ps(factor,factor,_MM_SHUFFLE(2,2,1,1))));
+			_mm_storeu_ps(velocityIt + 8,_mm_mul_ps(_mm_loadu_ps(velocityIt + 8),_mm_shuffle_ps(factor,factor,_MM_SHUFFLE(3,3,3,2))));
+		}
+
+		frictionScalar(velocities + nbBlocks * 12,masses + (nbBlocks << 2),nb - (nbBlocks << 2),frictionStep);
+	}
+
+	// SSE2 has no 32 bits multiplication so the even and odd elements are multiplied separately
+	SPK_TARGET("sse2") static inline __m128i multiplySSE2(__m128i a,__m128i b)
+	{
+		__m128i even = _mm_mul_epu32(a,b);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a,32),_mm_srli_epi64(b,32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even,_MM_SHUFFLE(0,0,2,0)),_mm_shuffle_epi32(odd,_MM_SHUFFLE(0,0,2,0)));
+	}
+
+	SPK_TARGET("sse2") static void randomSSE2(float* values,size_t nb,unsigned int hashedCounter,float min,float range)
+	{
+		const __m128i multiplier0 = _mm_set1_epi32(static_cast<int>(0x85EBCA6B));
+		const __m128i multiplier1 = _mm_set1_epi32(static_cast<int>(0xC2B2AE35));
+		const __m128i step = _mm_set1_epi32(static_cast<int>(RandomGenerator::COUNTER_STEP * 4));
+		const __m128 scale = _mm_set1_ps(RANDOM_SCALE);
+		const __m128 ranges = _mm_set1_ps(range);
+		const __m128 mins = _mm_set1_ps(min);
+
+		__m128i counters = _mm_setr_epi32(
+			static_cast<int>(hashedCounter),
+			static_cast<int>(hashedCounter + RandomGenerator::COUNTER_STEP),
+			static_cast<int>(hashedCounter + RandomGenerator::COUNTER_STEP * 2),
+			static_cast<int>(hashedCounter + RandomGenerator::COUNTER_STEP * 3));
+
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m128i hash = _mm_xor_si128(counters,_mm_srli_epi32(counters,16));
+			hash = multiplySSE2(hash,multiplier0);
+			hash = _mm_xor_si128(hash,_mm_srli_epi32(hash,13));
+			hash = multiplySSE2(hash,multiplier1);
+			hash = _mm_xor_si128(hash,_mm_srli_epi32(hash,16));
+
+			__m128 value = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(hash,8)),scale),ranges);
+			_mm_storeu_ps(values + (i << 2),_mm_add_ps(mins,value));
+			counters = _mm_add_epi32(counters,step);
+		}
+
+		size_t offset = nbBlocks << 2;
+		randomScalar(values + offset,nb - offset,hashedCounter + static_cast<unsigned int>(offset) * RandomGenerator::COUNTER_STEP,min,range);
+	}
+
+	// Selects a where the mask is set and b elsewhere (SSE2 has no blend instruction)
+	SPK_TARGET("sse2") static inline __m128 selectSSE2(__m128 mask,__m128 a,__m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask,a),_mm_andnot_ps(mask,b));
+	}
+
+	// The graph is parsed entirely for each block of values : the entries whose x is not greater than the value are counted,
+	// the last of them is the previous entry and the first of the others is the next entry
+	SPK_TARGET("sse2") static void interpolateSSE2(float* values,const float* xs,const float* offsetsX,const float* scalesX,const float* ratiosY,size_t nb,const InterpolatorEntry* entries,size_t nbEntries,bool looping)
+	{
+		const InterpolatorEntry& firstEntry = entries[0];
+		const InterpolatorEntry& lastEntry = entries[nbEntries - 1];
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 beginX = _mm_set1_ps(firstEntry.x);
+		const __m128 rangeX = _mm_set1_ps(lastEntry.x - firstEntry.x);
+		const __m128i nbEntriesBlock = _mm_set1_epi32(static_cast<int>(nbEntries));
+		__m128 masks[MAX_SIMD_INTERPOLATION_ENTRIES];
+
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 2;
+			__m128 x = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(xs + offset),_mm_loadu_ps(offsetsX + offset)),_mm_loadu_ps(scalesX + offset));
+			if (looping)
+			{
+				__m128 newX = _mm_div_ps(_mm_sub_ps(x,beginX),rangeX);
+				newX = _mm_sub_ps(newX,_mm_cvtepi32_ps(_mm_cvttps_epi32(newX)));
+				newX = selectSSE2(_mm_cmplt_ps(newX,zero),_mm_add_ps(one,newX),newX);
+				x = _mm_add_ps(beginX,_mm_mul_ps(newX,rangeX));
+			}
+
+			__m128i count = _mm_setzero_si128();
+			__m128 previousX = beginX;
+			__m128 previousY0 = _mm_set1_ps(firstEntry.y0);
+			__m128 previousY1 = _mm_set1_ps(firstEntry.y1);
+			for (size_t j = 0; j < nbEntries; ++j)
+			{
+				__m128 entryX = _mm_set1_ps(entries[j].x);
+				__m128 mask = _mm_cmpnlt_ps(x,entryX);
+				masks[j] = mask;
+				count = _mm_sub_epi32(count,_mm_castps_si128(mask));
+				previousX = selectSSE2(mask,entryX,previousX);
+				previousY0 = selectSSE2(mask,_mm_set1_ps(entries[j].y0),previousY0);
+				previousY1 = selectSSE2(mask,_mm_set1_ps(entries[j].y1),previousY1);
+			}
+
+			__m128 nextX = _mm_set1_ps(lastEntry.x);
+			__m128 nextY0 = _mm_set1_ps(lastEntry.y0);
+			__m128 nextY1 = _mm_set1_ps(lastEntry.y1);
+			for (size_t j = nbEntries; j > 0; --j)
+			{
+				__m128 mask = masks[j - 1];
+				nextX = selectSSE2(mask,nextX,_mm_set1_ps(entries[j - 1].x));
+				nextY0 = selectSSE2(mask,nextY0,_mm_set1_ps(entries[j - 1].y0));
+				nextY1 = selectSSE2(mask,nextY1,_mm_set1_ps(entries[j - 1].y1));
+			}
+
+			__m128 ratioY = _mm_loadu_ps(ratiosY + offset);
+			__m128 y0 = _mm_add_ps(previousY0,_mm_mul_ps(_mm_sub_ps(previousY1,previousY0),ratioY));
+			__m128 y1 = _mm_add_ps(nextY0,_mm_mul_ps(_mm_sub_ps(nextY1,nextY0),ratioY));
+			__m128 ratioX = _mm_div_ps(_mm_sub_ps(x,previousX),_mm_sub_ps(nextX,previousX));
+			__m128 y = _mm_add_ps(y0,_mm_mul_ps(ratioX,_mm_sub_ps(y1,y0)));
+
+			// before the first entry and after the last one, the value of the entry is taken
+			y = selectSSE2(_mm_castsi128_ps(_mm_cmpeq_epi32(count,_mm_setzero_si128())),y1,y);
+			y = selectSSE2(_mm_castsi128_ps(_mm_cmpeq_epi32(count,nbEntriesBlock)),y0,y);
+			_mm_storeu_ps(values + offset,y);
+		}
+
+		size_t offset = nbBlocks << 2;
+		interpolateScalar(values + offset,xs + offset,offsetsX + offset,scalesX + offset,ratiosY + offset,nb - offset,entries,nbEntries,looping);
+	}
+
+	// Loads the xyz components of 4 consecutive vec3 in 3 registers
+	SPK_TARGET("sse2") static inline void loadPointsSSE2(const float* points,__m128& x,__m128& y,__m128& z)
+	{
+		__m128 a = _mm_loadu_ps(points);		// x0 y0 z0 x1
+		__m128 b = _mm_loadu_ps(points + 4);	// y1 z1 x2 y2
+		__m128 c = _mm_loadu_ps(points + 8);	// z2 x3 y3 z3
+		x = _mm_shuffle_ps(a,_mm_shuffle_ps(b,c,_MM_SHUFFLE(1,1,2,2)),_MM_SHUFFLE(2,0,3,0));
+		y = _mm_shuffle_ps(_mm_shuffle_ps(a,b,_MM_SHUFFLE(0,0,1,1)),_mm_shuffle_ps(b,c,_MM_SHUFFLE(2,2,3,3)),_MM_SHUFFLE(2,0,2,0));
+		z = _mm_shuffle_ps(_mm_shuffle_ps(a,b,_MM_SHUFFLE(1,1,2,2)),c,_MM_SHUFFLE(3,0,2,0));
+	}
+
+	SPK_TARGET("sse2") static inline void storeResultsSSE2(__m128 mask,unsigned char* results)
+	{
+		int bits = _mm_movemask_ps(mask);
+		for (size_t i = 0; i < 4; ++i)
+			results[i] = static_cast<unsigned char>((bits >> i) & 1);
+	}
+
+	SPK_TARGET("sse2") static void testSphereContainmentSSE2(const float* points,size_t nb,const vec3& center,float sqrRadius,unsigned char* results)
+	{
+		const __m128 centerX = _mm_set1_ps(center.x);
+		const __m128 centerY = _mm_set1_ps(center.y);
+		const __m128 centerZ = _mm_set1_ps(center.z);
+		const __m128 sqrRadiusBlock = _mm_set1_ps(sqrRadius);
+
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m128 x,y,z;
+			loadPointsSSE2(points + i * 12,x,y,z);
+			x = _mm_sub_ps(centerX,x);
+			y = _mm_sub_ps(centerY,y);
+			z = _mm_sub_ps(centerZ,z);
+			__m128 sqrDist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x,x),_mm_mul_ps(y,y)),_mm_mul_ps(z,z));
+			storeResultsSSE2(_mm_cmple_ps(sqrDist,sqrRadiusBlock),results + (i << 2));
+		}
+
+		size_t offset = nbBlocks << 2;
+		testSphereContainmentScalar(points + offset * 3,nb - offset,center,sqrRadius,results + offset);
+	}
+
+	SPK_TARGET("sse2") static void testHalfSpaceContainmentSSE2(const float* points,size_t nb,const vec3& position,const vec3& normal,unsigned char* results)
+	{
+		const __m128 positionX = _mm_set1_ps(position.x);
+		const __m128 positionY = _mm_set1_ps(position.y);
+		const __m128 positionZ = _mm_set1_ps(position.z);
+		const __m128 normalX = _mm_set1_ps(normal.x);
+		const __m128 normalY = _mm_set1_ps(normal.y);
+		const __m128 normalZ = _mm_set1_ps(normal.z);
+
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m128 x,y,z;
+			loadPointsSSE2(points + i * 12,x,y,z);
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX,_mm_sub_ps(x,positionX)),_mm_mul_ps(normalY,_mm_sub_ps(y,positionY))),_mm_mul_ps(normalZ,_mm_sub_ps(z,positionZ)));
+			storeResultsSSE2(_mm_cmple_ps(dist,_mm_setzero_ps()),results + (i << 2));
+		}
+
+		size_t offset = nbBlocks << 2;
+		testHalfSpaceContainmentScalar(points + offset * 3,nb - offset,position,normal,results + offset);
+	}
+
+	SPK_TARGET("sse2") static void testBoxContainmentSSE2(const float* points,size_t nb,const vec3& min,const vec3& max,unsigned char* results)
+	{
+		const __m128 minX = _mm_set1_ps(min.x);
+		const __m128 minY = _mm_set1_ps(min.y);
+		const __m128 minZ = _mm_set1_ps(min.z);
+		const __m128 maxX = _mm_set1_ps(max.x);
+		const __m128 maxY = _mm_set1_ps(max.y);
+		const __m128 maxZ = _mm_set1_ps(max.z);
+
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m128 x,y,z;
+			loadPointsSSE2(points + i * 12,x,y,z);
+			__m128 inside = _mm_and_ps(_mm_cmpge_ps(x,minX),_mm_cmple_ps(x,maxX));
+			inside = _mm_and_ps(inside,_mm_and_ps(_mm_cmpge_ps(y,minY),_mm_cmple_ps(y,maxY)));
+			inside = _mm_and_ps(inside,_mm_and_ps(_mm_cmpge_ps(z,minZ),_mm_cmple_ps(z,maxZ)));
+			storeResultsSSE2(inside,results + (i << 2));
+		}
+
+		size_t offset = nbBlocks << 2;
+		testBoxContainmentScalar(points + offset * 3,nb - offset,min,max,results + offset);
+	}
+
+	SPK_TARGET("sse2") static void testCylinderContainmentSSE2(const float* points,size_t nb,const vec3& position,const vec3& direction,float halfLength,float radius,unsigned char* results)
+	{
+		const __m128 positionX = _mm_set1_ps(position.x);
+		const __m128 positionY = _mm_set1_ps(position.y);
+		const __m128 positionZ = _mm_set1_ps(position.z);
+		const __m128 directionX = _mm_set1_ps(direction.x);
+		const __m128 directionY = _mm_set1_ps(direction.y);
+		const __m128 directionZ = _mm_set1_ps(direction.z);
+		const __m128 maxDist = _mm_set1_ps(halfLength);
+		const __m128 minDist = _mm_set1_ps(-halfLength);
+		const __m128 radiusBlock = _mm_set1_ps(radius);
+
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m128 x,y,z;
+			loadPointsSSE2(points + i * 12,x,y,z);
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX,_mm_sub_ps(x,positionX)),_mm_mul_ps(directionY,_mm_sub_ps(y,positionY))),_mm_mul_ps(directionZ,_mm_sub_ps(z,positionZ)));
+			x = _mm_sub_ps(x,_mm_add_ps(_mm_mul_ps(directionX,dist),positionX));
+			y = _mm_sub_ps(y,_mm_add_ps(_mm_mul_ps(directionY,dist),positionY));
+			z = _mm_sub_ps(z,_mm_add_ps(_mm_mul_ps(directionZ,dist),positionZ));
+			__m128 r = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x,x),_mm_mul_ps(y,y)),_mm_mul_ps(z,z)));
+			__m128 inside = _mm_and_ps(_mm_cmple_ps(dist,maxDist),_mm_cmpge_ps(dist,minDist));
+			storeResultsSSE2(_mm_and_ps(inside,_mm_cmple_ps(r,radiusBlock)),results + (i << 2));
+		}
+
+		size_t offset = nbBlocks << 2;
+		testCylinderContainmentScalar(points + offset * 3,nb - offset,position,direction,halfLength,radius,results + offset);
+	}
+
+	SPK_TARGET("sse2") static void testBoxIntersectionSSE2(const float* starts,const float* ends,size_t nb,const vec3& min,const vec3& max,unsigned char* results)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 mins[3] = {_mm_set1_ps(min.x),_mm_set1_ps(min.y),_mm_set1_ps(min.z)};
+		const __m128 maxs[3] = {_mm_set1_ps(max.x),_mm_set1_ps(max.y),_mm_set1_ps(max.z)};
+
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m128 p0[3],p1[3];
+			loadPointsSSE2(starts + i * 12,p0[0],p0[1],p0[2]);
+			loadPointsSSE2(ends + i * 12,p1[0],p1[1],p1[2]);
+
+			__m128 tEnter = zero;
+			__m128 tExit = one;
+			__m128 intersects = _mm_cmpeq_ps(zero,zero);
+
+			// the lanes which are clipped out keep being computed but are masked out
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				__m128 dir = _mm_sub_ps(p1[axis],p0[axis]);
+				__m128 flat = _mm_cmpeq_ps(dir,zero);
+				__m128 outside = _mm_or_ps(_mm_cmplt_ps(p0[axis],mins[axis]),_mm_cmpgt_ps(p0[axis],maxs[axis]));
+
+				__m128 t0 = _mm_div_ps(_mm_sub_ps(mins[axis],p0[axis]),dir);
+				__m128 t1 = _mm_div_ps(_mm_sub_ps(maxs[axis],p0[axis]),dir);
+				__m128 swap = _mm_cmpgt_ps(t0,t1);
+				__m128 tMin = selectSSE2(swap,t1,t0);
+				__m128 tMax = selectSSE2(swap,t0,t1);
+
+				__m128 missed = _mm_or_ps(_mm_cmplt_ps(tMax,tEnter),_mm_cmpgt_ps(tMin,tExit));
+				intersects = _mm_andnot_ps(selectSSE2(flat,outside,missed),intersects);
+
+				tEnter = selectSSE2(_mm_andnot_ps(flat,_mm_cmpgt_ps(tMin,tEnter)),tMin,tEnter);
+				tExit = selectSSE2(_mm_andnot_ps(flat,_mm_cmplt_ps(tMax,tExit)),tMax,tExit);
+			}
+
+			__m128 inside = _mm_and_ps(_mm_cmple_ps(tEnter,zero),_mm_cmpge_ps(tExit,one));
+			storeResultsSSE2(_mm_andnot_ps(inside,intersects),results + (i << 2));
+		}
+
+		size_t offset = nbBlocks << 2;
+		testBoxIntersectionScalar(starts + offset * 3,ends + offset * 3,nb - offset,min,max,results + offset);
+	}
+
+	// Transposes 4 attributes of 4 vertices and stores them in the vertices, which are stride floats apart
+	SPK_TARGET("sse2") static inline void storeVertices4SSE2(float* vertices,size_t stride,__m128 a,__m128 b,__m128 c,__m128 d)
+	{
+		_MM_TRANSPOSE4_PS(a,b,c,d);
+		_mm_storeu_ps(vertices,a);
+		_mm_storeu_ps(vertices + stride,b);
+		_mm_storeu_ps(vertices + stride * 2,c);
+		_mm_storeu_ps(vertices + stride * 3,d);
+	}
+
+	SPK_TARGET("sse2") static inline void storeVertices3SSE2(float* vertices,size_t stride,__m128 a,__m128 b,__m128 c)
+	{
+		__m128 d = c;
+		_MM_TRANSPOSE4_PS(a,b,c,d);
+		__m128 v[4] = {a,b,c,d};
+		for (size_t i = 0; i < 4; ++i)
+		{
+			_mm_storel_pi(reinterpret_cast<__m64*>(vertices + stride * i),v[i]);
+			_mm_store_ss(vertices + stride * i + 2,_mm_movehl_ps(v[i],v[i]));
+		}
+	}
+
+	SPK_TARGET("sse2") static inline void storeVertices2SSE2(float* vertices,size_t stride,__m128 a,__m128 b)
+	{
+		__m128 low = _mm_unpacklo_ps(a,b);
+		__m128 high = _mm_unpackhi_ps(a,b);
+		_mm_storel_pi(reinterpret_cast<__m64*>(vertices),low);
+		_mm_storeh_pi(reinterpret_cast<__m64*>(vertices + stride),low);
+		_mm_storel_pi(reinterpret_cast<__m64*>(vertices + stride * 2),high);
+		_mm_storeh_pi(reinterpret_cast<__m64*>(vertices + stride * 3),high);
+	}
+
+	SPK_TARGET("sse2") static void expandQuadsSSE2(float* vertices,const float* positions,const float* sides,const float* ups,const float* const* colors,const float* const* textureCoords,size_t nb)
+	{
+		const size_t stride = QUAD_VERTEX_SIZE * 4; // The vertices of 4 consecutive particles
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 2;
+			__m128 x,y,z,sideX,sideY,sideZ,upX,upY,upZ;
+			loadPointsSSE2(positions + offset * 3,x,y,z);
+			loadPointsSSE2(sides + offset * 3,sideX,sideY,sideZ);
+			loadPointsSSE2(ups + offset * 3,upX,upY,upZ);
+
+			const __m128 red = _mm_loadu_ps(colors[0] + offset);
+			const __m128 green = _mm_loadu_ps(colors[1] + offset);
+			const __m128 blue = _mm_loadu_ps(colors[2] + offset);
+			const __m128 alpha = _mm_loadu_ps(colors[3] + offset);
+			const __m128 textureCoordBlocks[5] = {
+				_mm_loadu_ps(textureCoords[0] + offset),
+				_mm_loadu_ps(textureCoords[1] + offset),
+				_mm_loadu_ps(textureCoords[2] + offset),
+				_mm_loadu_ps(textureCoords[3] + offset),
+				_mm_loadu_ps(textureCoords[4] + offset)};
+
+			// The positions are computed in the same order as the scalar kernel : (position + side) + up
+			const __m128 plusSide[3] = {_mm_add_ps(x,sideX),_mm_add_ps(y,sideY),_mm_add_ps(z,sideZ)};
+			const __m128 minusSide[3] = {_mm_sub_ps(x,sideX),_mm_sub_ps(y,sideY),_mm_sub_ps(z,sideZ)};
+			const __m128 up[3] = {upX,upY,upZ};
+
+			float* quadVertices = vertices + offset * QUAD_VERTEX_SIZE * 4;
+			for (size_t j = 0; j < 4; ++j)
+			{
+				const __m128* base = QUAD_SIDE_SIGNS[j] > 0.0f ? plusSide : minusSide;
+				__m128 corner[3];
+				for (size_t k = 0; k < 3; ++k)
+					corner[k] = QUAD_UP_SIGNS[j] > 0.0f ? _mm_add_ps(base[k],up[k]) : _mm_sub_ps(base[k],up[k]);
+
+				float* vertex = quadVertices + j * QUAD_VERTEX_SIZE;
+				storeVertices4SSE2(vertex,stride,corner[0],corner[1],corner[2],red);
+				storeVertices4SSE2(vertex + 4,stride,green,blue,alpha,textureCoordBlocks[QUAD_U_INDICES[j]]);
+				storeVertices2SSE2(vertex + 8,stride,textureCoordBlocks[QUAD_V_INDICES[j]],textureCoordBlocks[4]);
+			}
+		}
+
+		size_t offset = nbBlocks << 2;
+		const float* colorOffsets[4] = {colors[0] + offset,colors[1] + offset,colors[2] + offset,colors[3] + offset};
+		const float* textureCoordOffsets[5] = {textureCoords[0] + offset,textureCoords[1] + offset,textureCoords[2] + offset,textureCoords[3] + offset,textureCoords[4] + offset};
+		expandQuadsScalar(vertices + offset * QUAD_VERTEX_SIZE * 4,positions + offset * 3,sides + offset * 3,ups + offset * 3,colorOffsets,textureCoordOffsets,nb - offset);
+	}
+
+	SPK_TARGET("sse2") static void expandLinesSSE2(float* vertices,const float* positions,const float* velocities,const float* const* colors,float length,size_t nb)
+	{
+		const size_t stride = LINE_VERTEX_SIZE * 2;
+		const __m128 lengthBlock = _mm_set1_ps(length);
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 2;
+			__m128 x,y,z,velocityX,velocityY,velocityZ;
+			loadPointsSSE2(positions + offset * 3,x,y,z);
+			loadPointsSSE2(velocities + offset * 3,velocityX,velocityY,velocityZ);
+
+			const __m128 red = _mm_loadu_ps(colors[0] + offset);
+			const __m128 green = _mm_loadu_ps(colors[1] + offset);
+			const __m128 blue = _mm_loadu_ps(colors[2] + offset);
+			const __m128 alpha = _mm_loadu_ps(colors[3] + offset);
+
+			float* lineVertices = vertices + offset * LINE_VERTEX_SIZE * 2;
+			storeVertices4SSE2(lineVertices,stride,x,y,z,red);
+			storeVertices3SSE2(lineVertices + 4,stride,green,blue,alpha);
+
+			lineVertices += LINE_VERTEX_SIZE;
+			storeVertices4SSE2(lineVertices,stride,
+				_mm_add_ps(x,_mm_mul_ps(velocityX,lengthBlock)),
+				_mm_add_ps(y,_mm_mul_ps(velocityY,lengthBlock)),
+				_mm_add_ps(z,_mm_mul_ps(velocityZ,lengthBlock)),
+				red);
+			storeVertices3SSE2(lineVertices + 4,stride,green,blue,alpha);
+		}
+
+		size_t offset = nbBlocks << 2;
+		const float* colorOffsets[4] = {colors[0] + offset,colors[1] + offset,colors[2] + offset,colors[3] + offset};
+		expandLinesScalar(vertices + offset * LINE_VERTEX_SIZE * 2,positions + offset * 3,velocities + offset * 3,colorOffsets,length,nb - offset);
+	}
+
+	SPK_TARGET("sse2") static void packPointsSSE2(float* vertices,const float* positions,const float* const* colors,const float* sizes,size_t nb)
+	{
+		const size_t stride = POINT_VERTEX_SIZE;
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 2;
+			__m128 x,y,z;
+			loadPointsSSE2(positions + offset * 3,x,y,z);
+
+			float* pointVertices = vertices + offset * POINT_VERTEX_SIZE;
+			storeVertices4SSE2(pointVertices,stride,x,y,z,_mm_loadu_ps(colors[0] + offset));
+			storeVertices4SSE2(pointVertices + 4,stride,_mm_loadu_ps(colors[1] + offset),_mm_loadu_ps(colors[2] + offset),_mm_loadu_ps(colors[3] + offset),_mm_loadu_ps(sizes + offset));
+		}
+
+		size_t offset = nbBlocks << 2;
+		const float* colorOffsets[4] = {colors[0] + offset,colors[1] + offset,colors[2] + offset,colors[3] + offset};
+		packPointsScalar(vertices + offset * POINT_VERTEX_SIZE,positions + offset * 3,colorOffsets,sizes + offset,nb - offset);
+	}
+
+	SPK_TARGET("sse2") static inline __m128i selectSSE2(__m128i mask,__m128i a,__m128i b)
+	{
+		return _mm_or_si128(_mm_and_si128(mask,a),_mm_andnot_si128(mask,b));
+	}
+
+	// Packs the 16 lower bits of the integers of 2 registers (SSE2 can only pack with a signed saturation)
+	SPK_TARGET("sse2") static inline __m128i packLow16SSE2(__m128i a,__m128i b)
+	{
+		a = _mm_srai_epi32(_mm_slli_epi32(a,16),16);
+		b = _mm_srai_epi32(_mm_slli_epi32(b,16),16);
+		return _mm_packs_epi32(a,b);
+	}
+
+	SPK_TARGET("sse2") static inline __m128i halfFloatsSSE2(__m128 values)
+	{
+		const __m128i absMask = _mm_set1_epi32(0x7fffffff);
+		__m128i bits = _mm_castps_si128(values);
+		__m128i sign = _mm_srli_epi32(_mm_andnot_si128(absMask,bits),16);
+		bits = _mm_and_si128(bits,absMask);
+
+		__m128i overflow = _mm_cmpgt_epi32(bits,_mm_set1_epi32(HALF_OVERFLOW_BITS - 1));
+		__m128i nan = _mm_cmpgt_epi32(bits,_mm_set1_epi32(FLOAT_INFINITY_BITS));
+		__m128i denormal = _mm_cmplt_epi32(bits,_mm_set1_epi32(HALF_MIN_NORMAL_BITS));
+
+		__m128i denormalHalf = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits),_mm_set1_ps(0.5f))),_mm_set1_epi32(HALF_DENORMAL_BITS));
+		__m128i odd = _mm_and_si128(_mm_srli_epi32(bits,13),_mm_set1_epi32(1));
+		__m128i normalHalf = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits,_mm_set1_epi32(static_cast<int>(HALF_REBIAS_BITS))),odd),13);
+		__m128i infiniteHalf = _mm_or_si128(_mm_set1_epi32(HALF_INFINITY),_mm_and_si128(nan,_mm_set1_epi32(HALF_NAN ^ HALF_INFINITY)));
+
+		__m128i half = selectSSE2(overflow,infiniteHalf,selectSSE2(denormal,denormalHalf,normalHalf));
+		return _mm_or_si128(half,sign);
+	}
+
+	SPK_TARGET("sse2") static inline __m128i loadQuantizedUnorm8SSE2(const float* values)
+	{
+		__m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(values),_mm_setzero_ps()),_mm_set1_ps(1.0f));
+		return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value,_mm_set1_ps(255.0f)),_mm_set1_ps(0.5f)));
+	}
+
+	SPK_TARGET("sse2") static inline __m128i loadQuantizedAnglesSSE2(const float* angles)
+	{
+		__m128 value = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(angles),_mm_set1_ps(ANGLE_QUANTIZATION_SCALE)),_mm_set1_ps(0.5f));
+		value = _mm_min_ps(_mm_max_ps(value,_mm_set1_ps(-MAX_QUANTIZED_ANGLE)),_mm_set1_ps(MAX_QUANTIZED_ANGLE));
+
+		// floor of the negative values (the mask is -1 where the truncation rounded up)
+		__m128i quantized = _mm_cvttps_epi32(value);
+		return _mm_add_epi32(quantized,_mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(quantized),value)));
+	}
+
+	SPK_TARGET("sse2") static inline __m128i loadQuantizedIndicesSSE2(const float* indices)
+	{
+		return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(indices),_mm_setzero_ps()),_mm_set1_ps(255.0f)));
+	}
+
+	SPK_TARGET("sse2") static void convertToHalfFloatsSSE2(unsigned short* halves,const float* values,size_t nb)
+	{
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 3;
+			__m128i low = halfFloatsSSE2(_mm_loadu_ps(values + offset));
+			__m128i high = halfFloatsSSE2(_mm_loadu_ps(values + offset + 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(halves + offset),packLow16SSE2(low,high));
+		}
+
+		size_t offset = nbBlocks << 3;
+		convertToHalfFloatsScalar(halves + offset,values + offset,nb - offset);
+	}
+
+	SPK_TARGET("sse2") static void quantizeColorsSSE2(unsigned char* colors,const float* const* components,size_t nb)
+	{
+		size_t nbBlocks = nb >> 2;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 2;
+			__m128i redGreen = _mm_or_si128(loadQuantizedUnorm8SSE2(components[0] + offset),_mm_slli_epi32(loadQuantizedUnorm8SSE2(components[1] + offset),8));
+			__m128i blueAlpha = _mm_or_si128(loadQuantizedUnorm8SSE2(components[2] + offset),_mm_slli_epi32(loadQuantizedUnorm8SSE2(components[3] + offset),8));
+
+			// x86 is little endian : the bytes are stored in the order red, green, blue and alpha
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(colors + (offset << 2)),_mm_or_si128(redGreen,_mm_slli_epi32(blueAlpha,16)));
+		}
+
+		size_t offset = nbBlocks << 2;
+		const float* componentOffsets[4] = {components[0] + offset,components[1] + offset,components[2] + offset,components[3] + offset};
+		quantizeColorsScalar(colors + (offset << 2),componentOffsets,nb - offset);
+	}
+
+	SPK_TARGET("sse2") static void quantizeAnglesSSE2(unsigned short* angles,const float* values,size_t nb)
+	{
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 3;
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(angles + offset),packLow16SSE2(loadQuantizedAnglesSSE2(values + offset),loadQuantizedAnglesSSE2(values + offset + 4)));
+		}
+
+		size_t offset = nbBlocks << 3;
+		quantizeAnglesScalar(angles + offset,values + offset,nb - offset);
+	}
+
+	SPK_TARGET("sse2") static void quantizeIndicesSSE2(unsigned char* indices,const float* values,size_t nb)
+	{
+		size_t nbBlocks = nb >> 4;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 4;
+			__m128i low = _mm_packs_epi32(loadQuantizedIndicesSSE2(values + offset),loadQuantizedIndicesSSE2(values + offset + 4));
+			__m128i high = _mm_packs_epi32(loadQuantizedIndicesSSE2(values + offset + 8),loadQuantizedIndicesSSE2(values + offset + 12));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + offset),_mm_packus_epi16(low,high));
+		}
+
+		size_t offset = nbBlocks << 4;
+		quantizeIndicesScalar(indices + offset,values + offset,nb - offset);
+	}
+
+	//////////////////
+	// AVX2 kernels //
+	//////////////////
+
+	// The wide kernels clear the upper part of the registers before processing the remaining elements with the scalar code :
+	// the compiler does not always do it before a tail call and the transitions between wide and legacy SSE code are very slow
+
+	SPK_TARGET("avx2") static void integrateAVX2(float* oldPositions,float* positions,float* velocities,size_t nb,const vec3& gravity,float deltaTime)
+	{
+		float pattern[24];
+		fillGravityPattern(pattern,8,gravity * deltaTime);
+		const __m256 gravityStep[3] = {_mm256_loadu_ps(pattern),_mm256_loadu_ps(pattern + 8),_mm256_loadu_ps(pattern + 16)};
+		const __m256 step = _mm256_set1_ps(deltaTime);
+
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks * 24; i += 24)
+			for (size_t j = 0; j < 3; ++j)
+			{
+				size_t offset = i + (j << 3);
+				__m256 position = _mm256_loadu_ps(positions + offset);
+				__m256 velocity = _mm256_loadu_ps(velocities + offset);
+				_mm256_storeu_ps(oldPositions + offset,position);
+				_mm256_storeu_ps(positions + offset,_mm256_add_ps(position,_mm256_mul_ps(velocity,step)));
+				_mm256_storeu_ps(velocities + offset,_mm256_add_ps(velocity,gravityStep[j]));
+			}
+
+		size_t offset = nbBlocks * 24;
+		_mm256_zeroupper();
+		integrateScalar(oldPositions + offset,positions + offset,velocities + offset,nb - (nbBlocks << 3),gravity,deltaTime);
+	}
+
+	SPK_TARGET("avx2") static void frictionAVX2(float* velocities,const float* masses,size_t nb,float frictionStep)
+	{
+		int pattern[24];
+		fillFrictionPattern(pattern,8);
+		const __m256i dispatch[3] = {
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern + 8)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern + 16))};
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 step = _mm256_set1_ps(frictionStep);
+
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m256 factor = _mm256_sub_ps(one,_mm256_min_ps(_mm256_div_ps(step,_mm256_loadu_ps(masses + (i << 3))),one));
+			float* velocityIt = velocities + i * 24;
+
+			for (size_t j = 0; j < 3; ++j)
+				_mm256_storeu_ps(velocityIt + (j << 3),_mm256_mul_ps(_mm256_loadu_ps(velocityIt + (j << 3)),_mm256_permutevar8x32_ps(factor,dispatch[j])));
+		}
+
+		_mm256_zeroupper();
+		frictionScalar(velocities + nbBlocks * 24,masses + (nbBlocks << 3),nb - (nbBlocks << 3),frictionStep);
+	}
+
+	SPK_TARGET("avx2") static void randomAVX2(float* values,size_t nb,unsigned int hashedCounter,float min,float range)
+	{
+		const __m256i multiplier0 = _mm256_set1_epi32(static_cast<int>(0x85EBCA6B));
+		const __m256i multiplier1 = _mm256_set1_epi32(static_cast<int>(0xC2B2AE35));
+		const __m256i step = _mm256_set1_epi32(static_cast<int>(RandomGenerator::COUNTER_STEP * 8));
+		const __m256 scale = _mm256_set1_ps(RANDOM_SCALE);
+		const __m256 ranges = _mm256_set1_ps(range);
+		const __m256 mins = _mm256_set1_ps(min);
+
+		__m256i counters = _mm256_add_epi32(
+			_mm256_set1_epi32(static_cast<int>(hashedCounter)),
+			_mm256_mullo_epi32(_mm256_setr_epi32(0,1,2,3,4,5,6,7),_mm256_set1_epi32(static_cast<int>(RandomGenerator::COUNTER_STEP))));
+
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m256i hash = _mm256_xor_si256(counters,_mm256_srli_epi32(counters,16));
+			hash = _mm256_mullo_epi32(hash,multiplier0);
+			hash = _mm256_xor_si256(hash,_mm256_srli_epi32(hash,13));
+			hash = _mm256_mullo_epi32(hash,multiplier1);
+			hash = _mm256_xor_si256(hash,_mm256_srli_epi32(hash,16));
+
+			__m256 value = _mm256_mul_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(hash,8)),scale),ranges);
+			_mm256_storeu_ps(values + (i << 3),_mm256_add_ps(mins,value));
+			counters = _mm256_add_epi32(counters,step);
+		}
+
+		size_t offset = nbBlocks << 3;
+		_mm256_zeroupper();
+		randomScalar(values + offset,nb - offset,hashedCounter + static_cast<unsigned int>(offset) * RandomGenerator::COUNTER_STEP,min,range);
+	}
+
+	SPK_TARGET("avx2") static void interpolateAVX2(float* values,const float* xs,const float* offsetsX,const float* scalesX,const float* ratiosY,size_t nb,const InterpolatorEntry* entries,size_t nbEntries,bool looping)
+	{
+		const InterpolatorEntry& firstEntry = entries[0];
+		const InterpolatorEntry& lastEntry = entries[nbEntries - 1];
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 beginX = _mm256_set1_ps(firstEntry.x);
+		const __m256 rangeX = _mm256_set1_ps(lastEntry.x - firstEntry.x);
+		const __m256i nbEntriesBlock = _mm256_set1_epi32(static_cast<int>(nbEntries));
+		__m256 masks[MAX_SIMD_INTERPOLATION_ENTRIES];
+
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 3;
+			__m256 x = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(xs + offset),_mm256_loadu_ps(offsetsX + offset)),_mm256_loadu_ps(scalesX + offset));
+			if (looping)
+			{
+				__m256 newX = _mm256_div_ps(_mm256_sub_ps(x,beginX),rangeX);
+				newX = _mm256_sub_ps(newX,_mm256_cvtepi32_ps(_mm256_cvttps_epi32(newX)));
+				newX = _mm256_blendv_ps(newX,_mm256_add_ps(one,newX),_mm256_cmp_ps(newX,zero,_CMP_LT_OQ));
+				x = _mm256_add_ps(beginX,_mm256_mul_ps(newX,rangeX));
+			}
+
+			__m256i count = _mm256_setzero_si256();
+			__m256 previousX = beginX;
+			__m256 previousY0 = _mm256_set1_ps(firstEntry.y0);
+			__m256 previousY1 = _mm256_set1_ps(firstEntry.y1);
+			for (size_t j = 0; j < nbEntries; ++j)
+			{
+				__m256 entryX = _mm256_set1_ps(entries[j].x);
+				__m256 mask = _mm256_cmp_ps(x,entryX,_CMP_NLT_UQ);
+				masks[j] = mask;
+				count = _mm256_sub_epi32(count,_mm256_castps_si256(mask));
+				previousX = _mm256_blendv_ps(previousX,entryX,mask);
+				previousY0 = _mm256_blendv_ps(previousY0,_mm256_set1_ps(entries[j].y0),mask);
+				previousY1 = _mm256_blendv_ps(previousY1,_mm256_set1_ps(entries[j].y1),mask);
+			}
+
+			__m256 nextX = _mm256_set1_ps(lastEntry.x);
+			__m256 nextY0 = _mm256_set1_ps(lastEntry.y0);
+			__m256 nextY1 = _mm256_set1_ps(lastEntry.y1);
+			for (size_t j = nbEntries; j > 0; --j)
+			{
+				__m256 mask = masks[j - 1];
+				nextX = _mm256_blendv_ps(_mm256_set1_ps(entries[j - 1].x),nextX,mask);
+				nextY0 = _mm256_blendv_ps(_mm256_set1_ps(entries[j - 1].y0),nextY0,mask);
+				nextY1 = _mm256_blendv_ps(_mm256_set1_ps(entries[j - 1].y1),nextY1,mask);
+			}
+
+			__m256 ratioY = _mm256_loadu_ps(ratiosY + offset);
+			__m256 y0 = _mm256_add_ps(previousY0,_mm256_mul_ps(_mm256_sub_ps(previousY1,previousY0),ratioY));
+			__m256 y1 = _mm256_add_ps(nextY0,_mm256_mul_ps(_mm256_sub_ps(nextY1,nextY0),ratioY));
+			__m256 ratioX = _mm256_div_ps(_mm256_sub_ps(x,previousX),_mm256_sub_ps(nextX,previousX));
+			__m256 y = _mm256_add_ps(y0,_mm256_mul_ps(ratioX,_mm256_sub_ps(y1,y0)));
+
+			// before the first entry and after the last one, the value of the entry is taken
+			y = _mm256_blendv_ps(y,y1,_mm256_castsi256_ps(_mm256_cmpeq_epi32(count,_mm256_setzero_si256())));
+			y = _mm256_blendv_ps(y,y0,_mm256_castsi256_ps(_mm256_cmpeq_epi32(count,nbEntriesBlock)));
+			_mm256_storeu_ps(values + offset,y);
+		}
+
+		size_t offset = nbBlocks << 3;
+		_mm256_zeroupper();
+		interpolateScalar(values + offset,xs + offset,offsetsX + offset,scalesX + offset,ratiosY + offset,nb - offset,entries,nbEntries,looping);
+	}
+
+	// Gathers the xyz components of 8 consecutive vec3 in 3 registers
+	SPK_TARGET("avx2") static inline void loadPointsAVX2(const float* points,__m256& x,__m256& y,__m256& z)
+	{
+		const __m256i indices = _mm256_setr_epi32(0,3,6,9,12,15,18,21);
+		x = _mm256_i32gather_ps(points,indices,4);
+		y = _mm256_i32gather_ps(points + 1,indices,4);
+		z = _mm256_i32gather_ps(points + 2,indices,4);
+	}
+
+	SPK_TARGET("avx2") static inline void storeResultsAVX2(__m256 mask,unsigned char* results)
+	{
+		int bits = _mm256_movemask_ps(mask);
+		for (size_t i = 0; i < 8; ++i)
+			results[i] = static_cast<unsigned char>((bits >> i) & 1);
+	}
+
+	SPK_TARGET("avx2") static void testSphereContainmentAVX2(const float* points,size_t nb,const vec3& center,float sqrRadius,unsigned char* results)
+	{
+		const __m256 centerX = _mm256_set1_ps(center.x);
+		const __m256 centerY = _mm256_set1_ps(center.y);
+		const __m256 centerZ = _mm256_set1_ps(center.z);
+		const __m256 sqrRadiusBlock = _mm256_set1_ps(sqrRadius);
+
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m256 x,y,z;
+			loadPointsAVX2(points + i * 24,x,y,z);
+			x = _mm256_sub_ps(centerX,x);
+			y = _mm256_sub_ps(centerY,y);
+			z = _mm256_sub_ps(centerZ,z);
+			__m256 sqrDist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x,x),_mm256_mul_ps(y,y)),_mm256_mul_ps(z,z));
+			storeResultsAVX2(_mm256_cmp_ps(sqrDist,sqrRadiusBlock,_CMP_LE_OQ),results + (i << 3));
+		}
+
+		size_t offset = nbBlocks << 3;
+		_mm256_zeroupper();
+		testSphereContainmentScalar(points + offset * 3,nb - offset,center,sqrRadius,results + offset);
+	}
+
+	SPK_TARGET("avx2") static void testHalfSpaceContainmentAVX2(const float* points,size_t nb,const vec3& position,const vec3& normal,unsigned char* results)
+	{
+		const __m256 positionX = _mm256_set1_ps(position.x);
+		const __m256 positionY = _mm256_set1_ps(position.y);
+		const __m256 positionZ = _mm256_set1_ps(position.z);
+		const __m256 normalX = _mm256_set1_ps(normal.x);
+		const __m256 normalY = _mm256_set1_ps(normal.y);
+		const __m256 normalZ = _mm256_set1_ps(normal.z);
+
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m256 x,y,z;
+			loadPointsAVX2(points + i * 24,x,y,z);
+			__m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normalX,_mm256_sub_ps(x,positionX)),_mm256_mul_ps(normalY,_mm256_sub_ps(y,positionY))),_mm256_mul_ps(normalZ,_mm256_sub_ps(z,positionZ)));
+			storeResultsAVX2(_mm256_cmp_ps(dist,_mm256_setzero_ps(),_CMP_LE_OQ),results + (i << 3));
+		}
+
+		size_t offset = nbBlocks << 3;
+		_mm256_zeroupper();
+		testHalfSpaceContainmentScalar(points + offset * 3,nb - offset,position,normal,results + offset);
+	}
+
+	SPK_TARGET("avx2") static void testBoxContainmentAVX2(const float* points,size_t nb,const vec3& min,const vec3& max,unsigned char* results)
+	{
+		const __m256 minX = _mm256_set1_ps(min.x);
+		const __m256 minY = _mm256_set1_ps(min.y);
+		const __m256 minZ = _mm256_set1_ps(min.z);
+		const __m256 maxX = _mm256_set1_ps(max.x);
+		const __m256 maxY = _mm256_set1_ps(max.y);
+		const __m256 maxZ = _mm256_set1_ps(max.z);
+
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m256 x,y,z;
+			loadPointsAVX2(points + i * 24,x,y,z);
+			__m256 inside = _mm256_and_ps(_mm256_cmp_ps(x,minX,_CMP_GE_OQ),_mm256_cmp_ps(x,maxX,_CMP_LE_OQ));
+			inside = _mm256_and_ps(inside,_mm256_and_ps(_mm256_cmp_ps(y,minY,_CMP_GE_OQ),_mm256_cmp_ps(y,maxY,_CMP_LE_OQ)));
+			inside = _mm256_and_ps(inside,_mm256_and_ps(_mm256_cmp_ps(z,minZ,_CMP_GE_OQ),_mm256_cmp_ps(z,maxZ,_CMP_LE_OQ)));
+			storeResultsAVX2(inside,results + (i << 3));
+		}
+
+		size_t offset = nbBlocks << 3;
+		_mm256_zeroupper();
+		testBoxContainmentScalar(points + offset * 3,nb - offset,min,max,results + offset);
+	}
+
+	SPK_TARGET("avx2") static void testCylinderContainmentAVX2(const float* points,size_t nb,const vec3& position,const vec3& direction,float halfLength,float radius,unsigned char* results)
+	{
+		const __m256 positionX = _mm256_set1_ps(position.x);
+		const __m256 positionY = _mm256_set1_ps(position.y);
+		const __m256 positionZ = _mm256_set1_ps(position.z);
+		const __m256 directionX = _mm256_set1_ps(direction.x);
+		const __m256 directionY = _mm256_set1_ps(direction.y);
+		const __m256 directionZ = _mm256_set1_ps(direction.z);
+		const __m256 maxDist = _mm256_set1_ps(halfLength);
+		const __m256 minDist = _mm256_set1_ps(-halfLength);
+		const __m256 radiusBlock = _mm256_set1_ps(radius);
+
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m256 x,y,z;
+			loadPointsAVX2(points + i * 24,x,y,z);
+			__m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(directionX,_mm256_sub_ps(x,positionX)),_mm256_mul_ps(directionY,_mm256_sub_ps(y,positionY))),_mm256_mul_ps(directionZ,_mm256_sub_ps(z,positionZ)));
+			x = _mm256_sub_ps(x,_mm256_add_ps(_mm256_mul_ps(directionX,dist),positionX));
+			y = _mm256_sub_ps(y,_mm256_add_ps(_mm256_mul_ps(directionY,dist),positionY));
+			z = _mm256_sub_ps(z,_mm256_add_ps(_mm256_mul_ps(directionZ,dist),positionZ));
+			__m256 r = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x,x),_mm256_mul_ps(y,y)),_mm256_mul_ps(z,z)));
+			__m256 inside = _mm256_and_ps(_mm256_cmp_ps(dist,maxDist,_CMP_LE_OQ),_mm256_cmp_ps(dist,minDist,_CMP_GE_OQ));
+			storeResultsAVX2(_mm256_and_ps(inside,_mm256_cmp_ps(r,radiusBlock,_CMP_LE_OQ)),results + (i << 3));
+		}
+
+		size_t offset = nbBlocks << 3;
+		_mm256_zeroupper();
+		testCylinderContainmentScalar(points + offset * 3,nb - offset,position,direction,halfLength,radius,results + offset);
+	}
+
+	SPK_TARGET("avx2") static void testBoxIntersectionAVX2(const float* starts,const float* ends,size_t nb,const vec3& min,const vec3& max,unsigned char* results)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 mins[3] = {_mm256_set1_ps(min.x),_mm256_set1_ps(min.y),_mm256_set1_ps(min.z)};
+		const __m256 maxs[3] = {_mm256_set1_ps(max.x),_mm256_set1_ps(max.y),_mm256_set1_ps(max.z)};
+
+		size_t nbBlocks = nb >> 3;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m256 p0[3],p1[3];
+			loadPointsAVX2(starts + i * 24,p0[0],p0[1],p0[2]);
+			loadPointsAVX2(ends + i * 24,p1[0],p1[1],p1[2]);
+
+			__m256 tEnter = zero;
+			__m256 tExit = one;
+			__m256 intersects = _mm256_cmp_ps(zero,zero,_CMP_EQ_OQ);
+
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				__m256 dir = _mm256_sub_ps(p1[axis],p0[axis]);
+				__m256 flat = _mm256_cmp_ps(dir,zero,_CMP_EQ_OQ);
+				__m256 outside = _mm256_or_ps(_mm256_cmp_ps(p0[axis],mins[axis],_CMP_LT_OQ),_mm256_cmp_ps(p0[axis],maxs[axis],_CMP_GT_OQ));
+
+				__m256 t0 = _mm256_div_ps(_mm256_sub_ps(mins[axis],p0[axis]),dir);
+				__m256 t1 = _mm256_div_ps(_mm256_sub_ps(maxs[axis],p0[axis]),dir);
+				__m256 swap = _mm256_cmp_ps(t0,t1,_CMP_GT_OQ);
+				__m256 tMin = _mm256_blendv_ps(t0,t1,swap);
+				__m256 tMax = _mm256_blendv_ps(t1,t0,swap);
+
+				__m256 missed = _mm256_or_ps(_mm256_cmp_ps(tMax,tEnter,_CMP_LT_OQ),_mm256_cmp_ps(tMin,tExit,_CMP_GT_OQ));
+				intersects = _mm256_andnot_ps(_mm256_blendv_ps(missed,outside,flat),intersects);
+
+				tEnter = _mm256_blendv_ps(tEnter,tMin,_mm256_andnot_ps(flat,_mm256_cmp_ps(tMin,tEnter,_CMP_GT_OQ)));
+				tExit = _mm256_blendv_ps(tExit,tMax,_mm256_andnot_ps(flat,_mm256_cmp_ps(tMax,tExit,_CMP_LT_OQ)));
+			}
+
+			__m256 inside = _mm256_and_ps(_mm256_cmp_ps(tEnter,zero,_CMP_LE_OQ),_mm256_cmp_ps(tExit,one,_CMP_GE_OQ));
+			storeResultsAVX2(_mm256_andnot_ps(inside,intersects),results + (i << 3));
+		}
+
+		size_t offset = nbBlocks << 3;
+		_mm256_zeroupper();
+		testBoxIntersectionScalar(starts + offset * 3,ends + offset * 3,nb - offset,min,max,results + offset);
+	}
+
+	/////////////////////
+	// AVX-512 kernels //
+	/////////////////////
+
+	// The unmasked forms of some AVX-512 intrinsics merge their result in an undefined register that GCC reports as maybe uninitialized :
+	// their zero-masked forms selecting all the lanes are used instead
+	static const __mmask16 AVX512_ALL_LANES = 0xFFFF;
+
+	SPK_TARGET("avx512f") static void integrateAVX512(float* oldPositions,float* positions,float* velocities,size_t nb,const vec3& gravity,float deltaTime)
+	{
+		float pattern[48];
+		fillGravityPattern(pattern,16,gravity * deltaTime);
+		const __m512 gravityStep[3] = {_mm512_loadu_ps(pattern),_mm512_loadu_ps(pattern + 16),_mm512_loadu_ps(pattern + 32)};
+		const __m512 step = _mm512_set1_ps(deltaTime);
+
+		size_t nbBlocks = nb >> 4;
+		for (size_t i = 0; i < nbBlocks * 48; i += 48)
+			for (size_t j = 0; j < 3; ++j)
+			{
+				size_t offset = i + (j << 4);
+				__m512 position = _mm512_loadu_ps(positions + offset);
+				__m512 velocity = _mm512_loadu_ps(velocities + offset);
+				_mm512_storeu_ps(oldPositions + offset,position);
+				// the rounding variant of the multiplication prevents the compiler from fusing it with the addition
+				_mm512_storeu_ps(positions + offset,_mm512_add_ps(position,_mm512_maskz_mul_round_ps(AVX512_ALL_LANES,velocity,step,_MM_FROUND_CUR_DIRECTION)));
+				_mm512_storeu_ps(velocities + offset,_mm512_add_ps(velocity,gravityStep[j]));
+			}
+
+		size_t offset = nbBlocks * 48;
+		_mm256_zeroupper();
+		integrateScalar(oldPositions + offset,positions + offset,velocities + offset,nb - (nbBlocks << 4),gravity,deltaTime);
+	}
+
+	SPK_TARGET("avx512f") static void frictionAVX512(float* velocities,const float* masses,size_t nb,float frictionStep)
+	{
+		int pattern[48];
+		fillFrictionPattern(pattern,16);
+		const __m512i dispatch[3] = {_mm512_loadu_si512(pattern),_mm512_loadu_si512(pattern + 16),_mm512_loadu_si512(pattern + 32)};
+		const __m512 one = _mm512_set1_ps(1.0f);
+		const __m512 step = _mm512_set1_ps(frictionStep);
+
+		size_t nbBlocks = nb >> 4;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m512 factor = _mm512_sub_ps(one,_mm512_maskz_min_ps(AVX512_ALL_LANES,_mm512_div_ps(step,_mm512_loadu_ps(masses + (i << 4))),one));
+			float* velocityIt = velocities + i * 48;
+
+			for (size_t j = 0; j < 3; ++j)
+				_mm512_storeu_ps(velocityIt + (j << 4),_mm512_mul_ps(_mm512_loadu_ps(velocityIt + (j << 4)),_mm512_maskz_permutexvar_ps(AVX512_ALL_LANES,dispatch[j],factor)));
+		}
+
+		_mm256_zeroupper();
+		frictionScalar(velocities + nbBlocks * 48,masses + (nbBlocks << 4),nb - (nbBlocks << 4),frictionStep);
+	}
+
+	SPK_TARGET("avx512f") static void randomAVX512(float* values,size_t nb,unsigned int hashedCounter,float min,float range)
+	{
+		const __m512i multiplier0 = _mm512_set1_epi32(static_cast<int>(0x85EBCA6B));
+		const __m512i multiplier1 = _mm512_set1_epi32(static_cast<int>(0xC2B2AE35));
+		const __m512i step = _mm512_set1_epi32(static_cast<int>(RandomGenerator::COUNTER_STEP * 16));
+		const __m512 scale = _mm512_set1_ps(RANDOM_SCALE);
+		const __m512 ranges = _mm512_set1_ps(range);
+		const __m512 mins = _mm512_set1_ps(min);
+
+		__m512i counters = _mm512_add_epi32(
+			_mm512_set1_epi32(static_cast<int>(hashedCounter)),
+			_mm512_mullo_epi32(_mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15),_mm512_set1_epi32(static_cast<int>(RandomGenerator::COUNTER_STEP))));
+
+		size_t nbBlocks = nb >> 4;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			__m512i hash = _mm512_xor_si512(counters,_mm512_maskz_srli_epi32(AVX512_ALL_LANES,counters,16));
+			hash = _mm512_mullo_epi32(hash,multiplier0);
+			hash = _mm512_xor_si512(hash,_mm512_maskz_srli_epi32(AVX512_ALL_LANES,hash,13));
+			hash = _mm512_mullo_epi32(hash,multiplier1);
+			hash = _mm512_xor_si512(hash,_mm512_maskz_srli_epi32(AVX512_ALL_LANES,hash,16));
+
+			// the rounding variant of the multiplication prevents the compiler from fusing it with the addition
+			__m512i bits = _mm512_maskz_srli_epi32(AVX512_ALL_LANES,hash,8);
+			__m512 value = _mm512_maskz_mul_round_ps(AVX512_ALL_LANES,_mm512_mul_ps(_mm512_maskz_cvtepi32_ps(AVX512_ALL_LANES,bits),scale),ranges,_MM_FROUND_CUR_DIRECTION);
+			_mm512_storeu_ps(values + (i << 4),_mm512_add_ps(mins,value));
+			counters = _mm512_add_epi32(counters,step);
+		}
+
+		size_t offset = nbBlocks << 4;
+		_mm256_zeroupper();
+		randomScalar(values + offset,nb - offset,hashedCounter + static_cast<unsigned int>(offset) * RandomGenerator::COUNTER_STEP,min,range);
+	}
+
+	SPK_TARGET("avx512f") static void interpolateAVX512(float* values,const float* xs,const float* offsetsX,const float* scalesX,const float* ratiosY,size_t nb,const InterpolatorEntry* entries,size_t nbEntries,bool looping)
+	{
+		const InterpolatorEntry& firstEntry = entries[0];
+		const InterpolatorEntry& lastEntry = entries[nbEntries - 1];
+		const __m512 zero = _mm512_setzero_ps();
+		const __m512 one = _mm512_set1_ps(1.0f);
+		const __m512 beginX = _mm512_set1_ps(firstEntry.x);
+		const __m512 rangeX = _mm512_set1_ps(lastEntry.x - firstEntry.x);
+		const __m512i oneBlock = _mm512_set1_epi32(1);
+		const __m512i nbEntriesBlock = _mm512_set1_epi32(static_cast<int>(nbEntries));
+		__mmask16 masks[MAX_SIMD_INTERPOLATION_ENTRIES];
+
+		// the rounding variant of the multiplication prevents the compiler from fusing it with the addition
+		size_t nbBlocks = nb >> 4;
+		for (size_t i = 0; i < nbBlocks; ++i)
+		{
+			size_t offset = i << 4;
+			__m512 x = _mm512_mul_ps(_mm512_add_ps(_mm512_loadu_ps(xs + offset),_mm512_loadu_ps(offsetsX + offset)),_mm512_loadu_ps(scalesX + offset));
+			if (looping)
+			{
+				__m512 newX = _mm512_div_ps(_mm512_sub_ps(x,beginX),rangeX);
+				newX = _mm512_sub_ps(newX,_mm512_maskz_cvtepi32_ps(AVX512_ALL_LANES,_mm512_maskz_cvttps_epi32(AVX512_ALL_LANES,newX)));
+				newX = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(newX,zero,_CMP_LT_OQ),newX,_mm512_add_ps(one,newX));
+				x = _mm512_add_ps(beginX,_mm512_maskz_mul_round_ps(AVX512_ALL_LANES,newX,rangeX,_MM_FROUND_CUR_DIRECTION));
+			}
+
+			__m512i count = _mm512_setzero_si512();
+			__m512 previousX = beginX;
+			__m512 previousY0 = _mm512_set1_ps(firstEntry.y0);
+			__m512 previousY1 = _mm512_set1_ps(firstEntry.y1);
+			for (size_t j = 0; j < nbEntries; ++j)
+			{
+				__m512 entryX = _mm512_set1_ps(entries[j].x);
+				__mmask16 mask = _mm512_cmp_ps_mask(x,entryX,_CMP_NLT_UQ);
+				masks[j] = mask;
+				count = _mm512_mask_add_epi32(count,mask,count,oneBlock);
+				previousX = _mm512_mask_blend_ps(mask,previousX,entryX);
+				previousY0 = _mm512_mask_blend_ps(mask,previousY0,_mm512_set1_ps(entries[j].y0));
+				previousY1 = _mm512_mask_blend_ps(mask,previousY1,_mm512_set1_ps(entries[j].y1));
+			}
+
+			__m512 nextX = _mm512_set1_ps(lastEntry.x);
+			__m512 nextY0 = _mm512_set1_ps(lastEntry.y0);
+			__m512 nextY1 = _mm512_set1_ps(lastEntry.y1);
+			for (size_t j = nbEntries; j > 0; --j)
+			{
+				__mmask16 mask = masks[j - 1];
+				nextX = _mm512_mask_blend_ps(mask,_mm512_set1_ps(entries[j - 1].x),nextX);
+				nextY0 = _mm512_mask_blend_ps(mask,_mm512_set1_ps(entries[j - 1].y0),nextY0);
+				nextY1 = _mm512_mask_blend_ps(mask,_mm512_set1_ps(entries[j - 1].y1),nextY1);
+			}
+
+			__m512 ratioY = _mm512_loadu_ps(ratiosY + offset);
+			__m512 y0 = _mm512_add_ps(previousY0,_mm512_maskz_mul_round_ps(AVX512_ALL_LANES,_mm512_sub_ps(previousY1,previousY0),ratioY,_MM_FROUND_CUR_DIRECTION));
+			__m512 y1 = _mm512_add_ps(nextY0,_mm512_maskz_mul_round_ps(AVX512_ALL_LANES,_mm512_sub_ps(nextY1,nextY0),ratioY,_MM_FROUND_CUR_DIRECTION));
+			__m512 ratioX = _mm512_div_ps(_mm512_sub_ps(x,previousX),_mm512_sub_ps(nextX,previousX));
+			__m512 y = _mm512_add_ps(y0,_mm512_maskz_mul_round_ps(AVX512_ALL_LANES,ratioX,_mm512_sub_ps(y1,y0),_MM_FROUND_CUR_DIRECTION));
+
+			// before the first entry and after the last one, the value of the entry is taken
+			y = _mm512_mask_blend_ps(_mm512_cmpeq_epi32_mask(count,_mm512_setzero_si512()),y,y1);
+			y = _mm512_mask_blend_ps(_mm512_cmpeq_epi32_mask(count,nbEntriesBlock),y,y0);
+			_mm512_storeu_ps(values + offset,y);
+		}
+
+		size_t offset = nbBlocks << 4;
+		_mm256_zeroupper();
+		interpolateScalar(values + offset,xs + offset,offsetsX + offset,scalesX + offset,ratiosY + offset,nb - offset,entries,nbEntries,looping);
+	}
+
+#endif
+
+	//////////////
+	// Dispatch //
+	//////////////
+
+	static InstructionSet detectInstructionSet()
+	{
+#ifdef SPK_X86_KERNELS
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+			return INSTRUCTION_SET_AVX512;
+		if (__builtin_cpu_supports("avx2"))
+			return INSTRUCTION_SET_AVX2;
+		if (__builtin_cpu_supports("sse2"))
+			return INSTRUCTION_SET_SSE2;
+#elif defined(_MSC_VER)
+		int info[4];
+		__cpuid(info,0);
+		int nbIds = info[0];
+
+		__cpuid(info,1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+
+		bool avx2 = false;
+		bool avx512 = false;
+		if (nbIds >= 7)
+		{
+			__cpuidex(info,7,0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+			avx512 = (info[1] & (1 << 16)) != 0;
+		}
+
+		// the operating system must save the wide registers
+		unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+		if ((avx512)&&((xcr0 & 0xE6) == 0xE6))
+			return INSTRUCTION_SET_AVX512;
+		if ((avx)&&(avx2)&&((xcr0 & 0x6) == 0x6))
+			return INSTRUCTION_SET_AVX2;
+		if (sse2)
+			return INSTRUCTION_SET_SSE2;
+#endif
+#endif
+		return INSTRUCTION_SET_SCALAR;
+	}
+
+	static const InstructionSet supportedInstructionSet = detectInstructionSet();
+	static InstructionSet currentInstructionSet = supportedInstructionSet;
+
+	static IntegrationKernel getIntegrationKernel()
+	{
+		switch(currentInstructionSet)
+		{
+#ifdef SPK_X86_KERNELS
+		case INSTRUCTION_SET_AVX512 : return &integrateAVX512;
+		case INSTRUCTION_SET_AVX2 : return &integrateAVX2;
+		case INSTRUCTION_SET_SSE2 : return &integrateSSE2;
+#endif
+		default : return &integrateScalar;
+		}
+	}
+
+	static FrictionKernel getFrictionKernel()
+	{
+		switch(currentInstructionSet)
+		{
+#ifdef SPK_X86_KERNELS
+		case INSTRUCTION_SET_AVX512 : return &frictionAVX512;
+		case INSTRUCTION_SET_AVX2 : return &frictionAVX2;
+		case INSTRUCTION_SET_SSE2 : return &frictionSSE2;
+#endif
+		default : return &frictionScalar;
+		}
+	}
+
+	static RandomKernel getRandomKernel()
+	{
+		switch(currentInstructionSet)
+		{
+#ifdef SPK_X86_KERNELS
+		case INSTRUCTION_SET_AVX512 : return &randomAVX512;
+		case INSTRUCTION_SET_AVX2 : return &randomAVX2;
+		case INSTRUCTION_SET_SSE2 : return &randomSSE2;
+#endif
+		default : return &randomScalar;
+		}
+	}
+
+	static InterpolationKernel getInterpolationKernel()
+	{
+		switch(currentInstructionSet)
+		{
+#ifdef SPK_X86_KERNELS
+		case INSTRUCTION_SET_AVX512 : return &interpolateAVX512;
+		case INSTRUCTION_SET_AVX2 : return &interpolateAVX2;
+		case INSTRUCTION_SET_SSE2 : return &interpolateSSE2;
+#endif
+		default : return &interpolateScalar;
+		}
+	}
+
+	// The zone kernels are bound by the loads of the points, the AVX2 kernels are also used with AVX-512
+	static SphereContainmentKernel getSphereContainmentKernel()
+	{
+		switch(currentInstructionSet)
+		{
+#ifdef SPK_X86_KERNELS
+		case INSTRUCTION_SET_AVX512 :
+		case INSTRUCTION_SET_AVX2 : return &testSphereContainmentAVX2;
+		case INSTRUCTION_SET_SSE2 : return &testSphereContainmentSSE2;
+#endif
+		default : return &testSphereContainmentScalar;
+		}
+	}
+
+	static HalfSpaceContainmentKernel getHalfSpaceContainmentKernel()
+	{
+		switch(currentInstructionSet)
+		{
+#ifdef SPK_X86_KERNELS
+		case INSTRUCTION_SET_AVX512 :
+		case INSTRUCTION_SET_AVX2 : return &testHalfSpaceContainmentAVX2;
+		case INSTRUCTION_SET_SSE2 : return &testHalfSpaceContainmentSSE2;
+#endif
+		default : return &testHalfSpaceContainmentScalar;
+		}
+	}
+
+	static BoxContainmentKernel getBoxContainmentKernel()
+	{
+		switch(currentInstructionSet)
+		{
+#ifdef SPK_X86_KERNELS
+		case INSTRUCTION_SET_AVX512 :
+		case INSTRUCTION_SET_AVX2 : return &testBoxContainmentAVX2;
+		case INSTRUCTION_SET_SSE2 : return &testBoxContainmentSSE2;
+#endif
+		default : return &testBoxContainmentScalar;
+		}
+	}
+
+	static CylinderContainmentKernel getCylinderContainmentKernel()
+	{
+		switch(currentInstructionSet)
+		{
+#ifdef SPK_X86_KERNELS
+		case INSTRUCTION_SET_AVX512 :
+		case INSTRUCTION_SET_AVX2 : return &testCylinderContainmentAVX2;
+		case INSTRUCTION_SET_SSE2 : return &testCylinderContainmentSSE2;
+#endif
+		default : return &testCylinderContainmentScalar;
+		}
+	}
+
+	static BoxIntersectionKernel getBoxIntersectionKernel()
+	{
+		switch(currentInstructionSet)
+		{
+#ifdef SPK_X86_KERNELS
+		case INSTRUCTION_SET_AVX512 :
+		case INSTRUCTION_SET_AVX2 : return &testBoxIntersectionAVX2;
+		case INSTRUCTION_SET_SSE2 : return &testBoxIntersectionSSE2;
+#endif
+		default : return &testBoxIntersectionScalar;
+		}
+	}
+
+	// The geometry and quantization kernels are bound by the stores of the vertices and instances, the SSE2 kernels are also used with AVX2 and AVX-512
+	static QuadExpansionKernel getQuadExpansionKernel()
+	{
+#ifdef SPK_X86_KERNELS
+		if (currentInstructionSet != INSTRUCTION_SET_SCALAR)
+			return &expandQuadsSSE2;
+#endif
+		return &expandQuadsScalar;
+	}
+
+	static LineExpansionKernel getLineExpansionKernel()
+	{
+#ifdef SPK_X86_KERNELS
+		if (currentInstructionSet != INSTRUCTION_SET_SCALAR)
+			return &expandLinesSSE2;
+#endif
+		return &expandLinesScalar;
+	}
+
+	static PointPackingKernel getPointPackingKernel()
+	{
+#ifdef SPK_X86_KERNELS
+		if (currentInstructionSet != INSTRUCTION_SET_SCALAR)
+			return &packPointsSSE2;
+#endif
+		return &packPointsScalar;
+	}
+
+	static HalfConversionKernel getHalfConversionKernel()
+	{
+#ifdef SPK_X86_KERNELS
+		if (currentInstructionSet != INSTRUCTION_SET_SCALAR)
+			return &convertToHalfFloatsSSE2;
+#endif
+		return &convertToHalfFloatsScalar;
+	}
+
+	static ColorQuantizationKernel getColorQuantizationKernel()
+	{
+#ifdef SPK_X86_KERNELS
+		if (currentInstructionSet != INSTRUCTION_SET_SCALAR)
+			return &quantizeColorsSSE2;
+#endif
+		return &quantizeColorsScalar;
+	}
+
+	static AngleQuantizationKernel getAngleQuantizationKernel()
+	{
+#ifdef SPK_X86_KERNELS
+		if (currentInstructionSet != INSTRUCTION_SET_SCALAR)
+			return &quantizeAnglesSSE2;
+#endif
+		return &quantizeAnglesScalar;
+	}
+
+	static IndexQuantizationKernel getIndexQuantizationKernel()
+	{
+#ifdef SPK_X86_KERNELS
+		if (currentInstructionSet != INSTRUCTION_SET_SCALAR)
+			return &quantizeIndicesSSE2;
+#endif
+		return &quantizeIndicesScalar;
+	}
+
+	static IntegrationKernel integrationKernel = getIntegrationKernel();
+	static FrictionKernel frictionKernel = getFrictionKernel();
+	static RandomKernel randomKernel = getRandomKernel();
+	static InterpolationKernel interpolationKernel = getInterpolationKernel();
+	static SphereContainmentKernel sphereContainmentKernel = getSphereContainmentKernel();
+	static HalfSpaceContainmentKernel halfSpaceContainmentKernel = getHalfSpaceContainmentKernel();
+	static BoxContainmentKernel boxContainmentKernel = getBoxContainmentKernel();
+	static CylinderContainmentKernel cylinderContainmentKernel = getCylinderContainmentKernel();
+	static BoxIntersectionKernel boxIntersectionKernel = getBoxIntersectionKernel();
+	static QuadExpansionKernel quadExpansionKernel = getQuadExpansionKernel();
+	static LineExpansionKernel lineExpansionKernel = getLineExpansionKernel();
+	static PointPackingKernel pointPackingKernel = getPointPackingKernel();
+	static HalfConversionKernel halfConversionKernel = getHalfConversionKernel();
+	static ColorQuantizationKernel colorQuantizationKernel = getColorQuantizationKernel();
+	static AngleQuantizationKernel angleQuantizationKernel = getAngleQuantizationKernel();
+	static IndexQuantizationKernel indexQuantizationKernel = getIndexQuantizationKernel();
+
+	InstructionSet getSupportedInstructionSet()
+	{
+		return supportedInstructionSet;
+	}
+
+	InstructionSet getInstructionSet()
+	{
+		return currentInstructionSet;
+	}
+
+	bool setInstructionSet(InstructionSet instructionSet)
+	{
+		if (instructionSet > supportedInstructionSet)
+			return false;
+
+		currentInstructionSet = instructionSet;
+		integrationKernel = getIntegrationKernel();
+		frictionKernel = getFrictionKernel();
+		randomKernel = getRandomKernel();
+		interpolationKernel = getInterpolationKernel();
+		sphereContainmentKernel = getSphereContainmentKernel();
+		halfSpaceContainmentKernel = getHalfSpaceContainmentKernel();
+		boxContainmentKernel = getBoxContainmentKernel();
+		cylinderContainmentKernel = getCylinderContainmentKernel();
+		boxIntersectionKernel = getBoxIntersectionKernel();
+		quadExpansionKernel = getQuadExpansionKernel();
+		lineExpansionKernel = getLineExpansionKernel();
+		pointPackingKernel = getPointPackingKernel();
+		halfConversionKernel = getHalfConversionKernel();
+		colorQuantizationKernel = getColorQuantizationKernel();
+		angleQuantizationKernel = getAngleQuantizationKernel();
+		indexQuantizationKernel = getIndexQuantizationKernel();
+		return true;
+	}
+
+	void integrateParticles(vec3* oldPositions,vec3* positions,vec3* velocities,size_t nb,const vec3& gravity,float deltaTime)
+	{
+		(*integrationKernel)(&oldPositions->x,&positions->x,&velocities->x,nb,gravity,deltaTime);
+	}
+
+	void applyFriction(vec3* velocities,const float* masses,size_t nb,float friction,float deltaTime)
+	{
+		float frictionStep = friction * deltaTime;
+
+		if (masses != NULL)
+			(*frictionKernel)(&velocities->x,masses,nb,frictionStep);
+		else
+		{
+			// all the particles share the same factor
+			float factor = 1.0f - std::min(1.0f,frictionStep / Model::getDefaultValue(PARAM_MASS));
+			for (size_t i = 0; i < nb; ++i)
+				velocities[i] *= factor;
+		}
+	}
+
+	void generateRandomValues(float* values,size_t nb,unsigned int key,unsigned int counter,float min,float max)
+	{
+		(*randomKernel)(values,nb,key + counter * RandomGenerator::COUNTER_STEP,min,max - min);
+	}
+
+	void interpolateValues(float* values,const float* xs,const float* offsetsX,const float* scalesX,const float* ratiosY,size_t nb,const InterpolatorEntry* entries,size_t nbEntries,bool looping)
+	{
+		// a binary search is faster than parsing large graphs
+		if (nbEntries <= MAX_SIMD_INTERPOLATION_ENTRIES)
+			(*interpolationKernel)(values,xs,offsetsX,scalesX,ratiosY,nb,entries,nbEntries,looping);
+		else
+			interpolateScalar(values,xs,offsetsX,scalesX,ratiosY,nb,entries,nbEntries,looping);
+	}
+
+	void testSphereContainment(const vec3* points,size_t nb,const vec3& center,float radius,unsigned char* results)
+	{
+		(*sphereContainmentKernel)(&points->x,nb,center,radius * radius,results);
+	}
+
+	void testHalfSpaceContainment(const vec3* points,size_t nb,const vec3& position,const vec3& normal,unsigned char* results)
+	{
+		(*halfSpaceContainmentKernel)(&points->x,nb,position,normal,results);
+	}
+
+	void testBoxContainment(const vec3* points,size_t nb,const vec3& min,const vec3& max,unsigned char* results)
+	{
+		(*boxContainmentKernel)(&points->x,nb,min,max,results);
+	}
+
+	void testCylinderContainment(const vec3* points,size_t nb,const vec3& position,const vec3& direction,float length,float radius,unsigned char* results)
+	{
+		(*cylinderContainmentKernel)(&points->x,nb,position,direction,length * 0.5f,radius,results);
+	}
+
+	void testBoxIntersection(const vec3* starts,const vec3* ends,size_t nb,const vec3& min,const vec3& max,unsigned char* results)
+	{
+		(*boxIntersectionKernel)(&starts->x,&ends->x,nb,min,max,results);
+	}
+
+	void expandQuads(float* vertices,const vec3* positions,const vec3* sides,const vec3* ups,const float* const* colors,const float* const* textureCoords,size_t nb)
+	{
+		(*quadExpansionKernel)(vertices,&positions->x,&sides->x,&ups->x,colors,textureCoords,nb);
+	}
+
+	void expandLines(float* vertices,const vec3* positions,const vec3* velocities,const float* const* colors,float length,size_t nb)
+	{
+		(*lineExpansionKernel)(vertices,&positions->x,&velocities->x,colors,length,nb);
+	}
+
+	void packPoints(float* vertices,const vec3* positions,const float* const* colors,const float* sizes,size_t nb)
+	{
+		(*pointPackingKernel)(vertices,&positions->x,colors,sizes,nb);
+	}
+
+	void convertToHalfFloats(unsigned short* halves,const float* values,size_t nb)
+	{
+		(*halfConversionKernel)(halves,values,nb);
+	}
+
+	void quantizeColors(unsigned char* colors,const float* const* components,size_t nb)
+	{
+		(*colorQuantizationKernel)(colors,components,nb);
+	}
+
+	void quantizeAngles(unsigned short* angles,const float* values,size_t nb)
+	{
+		(*angleQuantizationKernel)(angles,values,nb);
+	}
+
+	void quantizeIndices(unsigned char* indices,const float* values,size_t nb)
+	{
+		(*indexQuantizationKernel)(indices,values,nb);
+	}
+
+	void generateDirections(vec3* directions,size_t nb,RandomGenerator& randomGenerator)
+	{
+		// A uniform z and a uniform angle give a uniform distribution on the sphere (Archimedes' hat-box theorem)
+		float zs[RANDOM_BLOCK_SIZE];
+		float angles[RANDOM_BLOCK_SIZE];
+		for (size_t i = 0; i < nb; i += RANDOM_BLOCK_SIZE)
+		{
+			size_t nbDirections = std::min(nb - i,RANDOM_BLOCK_SIZE);
+			randomGenerator.generate(zs,nbDirections,-1.0f,1.0f);
+			randomGenerator.generate(angles,nbDirections,0.0f,TWO_PI);
+			for (size_t j = 0; j < nbDirections; ++j)
+			{
+				float radius = std::sqrt(std::max(0.0f,1.0f - zs[j] * zs[j]));
+				directions[i + j] = vec3(radius * std::cos(angles[j]),radius * std::sin(angles[j]),zs[j]);
+			}
+		}
+	}
+}
+
+#if defined(__clang__) || defined(_MSC_VER)
+#pragma float_control(pop)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
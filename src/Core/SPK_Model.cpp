@@ -22,6 +22,7 @@
 
 #include "Core/SPK_Model.h"
 #include "Core/SPK_Interpolator.h"
+#include "Core/SPK_Particle.h"
 
 namespace SPK
 {
@@ -50,7 +51,9 @@ namespace SPK
 		nbEnableParams(0),
 		nbMutableParams(0),
 		nbRandomParams(0),
-		nbInterpolatedParams(0)
+		nbInterpolatedParams(0),
+		initTemplates(NULL),
+		nbInitTemplates(0)
 	{
 		enableFlag |= FLAG_RED | FLAG_GREEN | FLAG_BLUE; // Adds the color parameters to the enable flag
 		this->enableFlag = enableFlag & ((1 << (NB_PARAMS + 1)) - 1); // masks the enable flag with the existing parameters
@@ -153,6 +156,8 @@ namespace SPK
 		}
 		else
 			interpolatedParams = NULL;
+
+		Particle::selectKernels(*this);
 	}
 
 	Model::Model(const Model& model) :
@@ -172,7 +177,11 @@ namespace SPK
 		params(NULL),
 		enableParams(NULL),
 		mutableParams(NULL),
-		interpolatedParams(NULL)
+		interpolatedParams(NULL),
+		initKernel(model.initKernel),
+		updateKernel(model.updateKernel),
+		initTemplates(NULL),
+		nbInitTemplates(model.nbInitTemplates)
 	{
 		if (paramsSize > 0)
 		{
@@ -197,7 +206,7 @@ namespace SPK
 
 		if (nbInterpolatedParams > 0)
 		{
-			interpolatedParams = new int[nbMutableParams];
+			interpolatedParams = new int[nbInterpolatedParams];
 			for (size_t i = 0; i < nbInterpolatedParams; ++i)
 				interpolatedParams[i] = model.interpolatedParams[i];
 		}
@@ -212,6 +221,13 @@ namespace SPK
 			else
 				interpolators[i] = NULL;
 		}
+
+		if (nbInitTemplates > 0)
+		{
+			size_t templatesSize = (nbEnableParams + getSizeOfParticleExtendedArray()) * nbInitTemplates;
+			initTemplates = new float[templatesSize];
+			std::copy(model.initTemplates,model.initTemplates + templatesSize,initTemplates);
+		}
 	}
 
 	Model::~Model()
@@ -220,6 +236,7 @@ namespace SPK
 		delete[] mutableParams;
 		delete[] interpolatedParams;
 		delete[] params;
+		delete[] initTemplates;
 
 		for (size_t i = 0; i < NB_PARAMS; ++i)
 			delete interpolators[i];
@@ -238,6 +255,9 @@ namespace SPK
 		*ptr++ = endMin;
 		*ptr = endMax;
 
+		if (nbInitTemplates > 0)
+			bakeInitTemplates(nbInitTemplates);
+
 		return true;
 	}
 
@@ -252,6 +272,9 @@ namespace SPK
 		*ptr++ = value0;
 		*ptr = value1;
 
+		if (nbInitTemplates > 0)
+			bakeInitTemplates(nbInitTemplates);
+
 		return true;
 	}
 
@@ -264,9 +287,32 @@ namespace SPK
 		// Sets the value at the right position in params
 		params[indices[type]] = value;
 
+		if (nbInitTemplates > 0)
+			bakeInitTemplates(nbInitTemplates);
+
 		return true;
 	}
 
+	void Model::bakeInitTemplates(size_t nbTemplates)
+	{
+		if (nbTemplates != nbInitTemplates)
+		{
+			delete[] initTemplates;
+			initTemplates = NULL;
+			nbInitTemplates = nbTemplates;
+
+			if (nbTemplates > 0)
+				initTemplates = new float[(nbEnableParams + getSizeOfParticleExtendedArray()) * nbTemplates];
+		}
+
+		if (nbTemplates > 0)
+		{
+			// the templates are generated from their own stream of random numbers
+			RandomGenerator randomGenerator(random(0u,0xFFFFFFFFu));
+			Particle::bakeTemplates(*this,randomGenerator);
+		}
+	}
+
 	float Model::getParamValue(ModelParam type,size_t index) const
 	{
 		unsigned int nbValues = getNbValues(type);
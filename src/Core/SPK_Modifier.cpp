@@ -20,11 +20,151 @@
 //////////////////////////////////////////////////////////////////////////////////
 
 #include "Core/SPK_Modifier.h"
+#include "Core/SPK_Group.h"
+#include "Core/SPK_Buffer.h"
+
+#include <sstream>
+#include <cstring>
 
 namespace SPK
 {
-	vec3 Modifier::intersection;
-	vec3 Modifier::normal;
+	// The side of the Zone of each particle, 64 particles per word
+	// As chunks of particles are multiple of 64, two chunks never write the same word
+	class Modifier::ContainmentBuffer : public Buffer
+	{
+	public :
+
+		ContainmentBuffer(size_t nbParticles) :
+			Buffer(),
+			insideBits((nbParticles + 63) >> 6,0),
+			validBits((nbParticles + 63) >> 6,0),
+			version(0),
+			position(0.0f,0.0f,0.0f)
+		{
+			std::memcpy(transform,Transformable::IDENTITY,sizeof(transform));
+		}
+
+		// The sides are only valid for the Zone they were tested with :
+		// they are all invalidated when the version of the cache, the position or the transform of the Zone changes
+		void checkZone(const Zone& zone,unsigned int version)
+		{
+			if ((version == this->version)
+				&&(zone.getTransformedPosition() == position)
+				&&(std::memcmp(zone.getWorldTransform(),transform,sizeof(transform)) == 0))
+				return;
+
+			std::fill(validBits.begin(),validBits.end(),0ULL);
+			this->version = version;
+			position = zone.getTransformedPosition();
+			std::memcpy(transform,zone.getWorldTransform(),sizeof(transform));
+		}
+
+		bool isValid(size_t index) const	{return ((validBits[index >> 6] >> (index & 63)) & 1) != 0;}
+		bool isInside(size_t index) const	{return ((insideBits[index >> 6] >> (index & 63)) & 1) != 0;}
+
+		void set(size_t index,bool inside)
+		{
+			unsigned long long mask = 1ULL << (index & 63);
+			validBits[index >> 6] |= mask;
+			if (inside)
+				insideBits[index >> 6] |= mask;
+			else
+				insideBits[index >> 6] &= ~mask;
+		}
+
+		void invalidate(size_t index)
+		{
+			validBits[index >> 6] &= ~(1ULL << (index & 63));
+		}
+
+	private :
+
+		std::vector<unsigned long long> insideBits;
+		std::vector<unsigned long long> validBits;
+		std::vector<unsigned long long> gatheredBits;
+
+		unsigned int version;
+		vec3 position;
+		float transform[Transformable::TRANSFORM_LENGTH];
+
+		static void swapBits(std::vector<unsigned long long>& bits,size_t index0,size_t index1)
+		{
+			unsigned long long bit0 = (bits[index0 >> 6] >> (index0 & 63)) & 1;
+			unsigned long long bit1 = (bits[index1 >> 6] >> (index1 & 63)) & 1;
+			if (bit0 != bit1)
+			{
+				bits[index0 >> 6] ^= 1ULL << (index0 & 63);
+				bits[index1 >> 6] ^= 1ULL << (index1 & 63);
+			}
+		}
+
+		void permuteBits(std::vector<unsigned long long>& bits,const unsigned int* permutation,size_t begin,size_t end)
+		{
+			gatheredBits = bits;
+			for (size_t i = begin; i < end; ++i)
+			{
+				unsigned long long bit = (gatheredBits[permutation[i] >> 6] >> (permutation[i] & 63)) & 1;
+				bits[i >> 6] = (bits[i >> 6] & ~(1ULL << (i & 63))) | (bit << (i & 63));
+			}
+		}
+
+		// The bits of the particles alive are packed in a word which is written once full
+		// The word written is never read again as the particles are only moved backwards
+		static void compactBits(std::vector<unsigned long long>& bits,const unsigned long long* aliveMask,size_t nbParticles)
+		{
+			size_t src = 0;
+			while ((src + 64 <= nbParticles)&&(aliveMask[src >> 6] == ~0ULL))
+				src += 64;
+
+			size_t dst = src;
+			unsigned long long word = 0;
+			for (; src < nbParticles; ++src)
+			{
+				unsigned long long alive = (aliveMask[src >> 6] >> (src & 63)) & 1;
+				word |= ((bits[src >> 6] >> (src & 63)) & alive) << (dst & 63);
+				dst += static_cast<size_t>(alive);
+				if ((alive != 0)&&((dst & 63) == 0))
+				{
+					bits[(dst - 1) >> 6] = word;
+					word = 0;
+				}
+			}
+
+			if ((dst & 63) != 0)
+				bits[dst >> 6] = word;
+		}
+
+		virtual void swap(size_t index0,size_t index1)
+		{
+			swapBits(insideBits,index0,index1);
+			swapBits(validBits,index0,index1);
+		}
+
+		virtual void applyPermutation(const unsigned int* permutation,size_t begin,size_t end)
+		{
+			permuteBits(insideBits,permutation,begin,end);
+			permuteBits(validBits,permutation,begin,end);
+		}
+
+		virtual void compact(const unsigned long long* aliveMask,size_t nbParticles)
+		{
+			compactBits(insideBits,aliveMask,nbParticles);
+			compactBits(validBits,aliveMask,nbParticles);
+		}
+
+		virtual void reset(size_t index)
+		{
+			invalidate(index);
+		}
+	};
+
+	class Modifier::ContainmentBufferCreator : public BufferCreator
+	{
+		virtual Buffer* createBuffer(size_t nbParticles,const Group& group) const
+		{
+			return new ContainmentBuffer(nbParticles);
+		}
+	};
 
 	Modifier::Modifier(int availableTriggers,ModifierTrigger trigger,bool needsIntersection,bool needsNormal,Zone* zone) :
 		Registerable(),
@@ -37,7 +177,11 @@ namespace SPK
 		needsNormal(needsNormal),
 		full(false),
 		active(true),
-		local(false)
+		savedTrigger(trigger),
+		local(false),
+		containmentCacheEnabled(false),
+		containmentBuffer(NULL),
+		containmentCacheVersion(0)
 	{}
 
 	void Modifier::registerChildren(bool registerAll)
@@ -75,6 +219,8 @@ namespace SPK
 
 		this->zone = zone;
 		this->full = full;
+
+		invalidateContainmentCache(); // the sides of the previous zone are no longer valid
 	}
 
 	bool Modifier::setTrigger(ModifierTrigger trigger)
@@ -91,11 +237,194 @@ namespace SPK
 	void Modifier::beginProcess(Group& group)
 	{
 		savedActive = active;
+		savedTrigger = trigger;
 		
 		if (!active)
 			return;
 		
 		if (!prepareBuffers(group))
 			active = false; // if buffers of the modifier in the group are not ready, the modifier is made incative for the frame
+		else
+		{
+			if ((containmentCacheEnabled)&&(zone != NULL)&&((trigger == ENTER_ZONE)||(trigger == EXIT_ZONE)))
+			{
+				containmentBuffer = static_cast<ContainmentBuffer*>(group.getBuffer(getContainmentBufferID()));
+				containmentBuffer->checkZone(*zone,containmentCacheVersion);
+			}
+			prepareProcess(group);
+		}
+	}
+
+	bool Modifier::cullProcess(const vec3& reachMin,const vec3& reachMax)
+	{
+		if ((trigger == ALWAYS)||(zone == NULL))
+			return !movesParticlesAway();
+
+		vec3 AABBMin,AABBMax;
+		if ((!zone->getAABB(AABBMin,AABBMax))
+			||((AABBMin.x <= reachMax.x)&&(AABBMax.x >= reachMin.x)
+			&&(AABBMin.y <= reachMax.y)&&(AABBMax.y >= reachMin.y)
+			&&(AABBMin.z <= reachMax.z)&&(AABBMax.z >= reachMin.z)))
+			return !movesParticlesAway();
+
+		// No particle can be within the zone or cross it during this update
+		switch(trigger)
+		{
+		case OUTSIDE_ZONE :
+			trigger = ALWAYS; // all the particles are outside (restored in endProcess)
+			return !movesParticlesAway();
+
+		case INSIDE_ZONE :
+		case EXIT_ZONE :
+			if (movesParticlesAway())
+				return false; // all the particles are on the wrong side
+			break;
+
+		default :
+			break;
+		}
+
+		active = false; // no particle can trigger the modifier (restored in endProcess)
+		return true;
+	}
+
+	void Modifier::createBuffers(const Group& group)
+	{
+		if (containmentCacheEnabled)
+			group.createBuffer(getContainmentBufferID(),ContainmentBufferCreator(),0,true);
+	}
+
+	void Modifier::destroyBuffers(const Group& group)
+	{
+		group.destroyBuffer(getContainmentBufferID());
+	}
+
+	bool Modifier::checkBuffers(const Group& group)
+	{
+		return (!containmentCacheEnabled)||(group.getBuffer(getContainmentBufferID()) != NULL);
+	}
+
+	std::string Modifier::getContainmentBufferID() const
+	{
+		// The buffer is specific to this modifier within the group
+		std::ostringstream ID;
+		ID << "SPK_Modifier_Containment_" << this;
+		return ID.str();
+	}
+
+	bool Modifier::checkCachedTrigger(Particle& particle,ZoneIntersection& intersection) const
+	{
+		size_t index = particle.getIndex();
+		bool inside = containmentBuffer->isValid(index) ? containmentBuffer->isInside(index) : zone->contains(particle.oldPosition());
+
+		// The particle may be moved by modifyWrongSide or modify, its side is tested again on next frame
+		if (inside == (trigger == ENTER_ZONE))
+		{
+			containmentBuffer->invalidate(index);
+			modifyWrongSide(particle,inside);
+			return false;
+		}
+
+		if (zone->intersects(particle.oldPosition(),
+			particle.position(),
+			needsIntersection ? &intersection.position : NULL,
+			needsNormal ? &intersection.normal : NULL))
+		{
+			containmentBuffer->invalidate(index);
+			return true;
+		}
+
+		// The particle did not cross the zone and remains on the same side
+		containmentBuffer->set(index,inside);
+		return false;
+	}
+
+	void Modifier::modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const
+	{
+		for (size_t i = begin; i < end; ++i)
+			process(group.getParticle(i),deltaTime);
+	}
+
+	void Modifier::checkTriggers(Group& group,size_t begin,size_t end,unsigned char* triggers) const
+	{
+		size_t nb = end - begin;
+
+		switch(trigger)
+		{
+		case ALWAYS :
+			std::memset(triggers,1,nb);
+			return;
+
+		case INSIDE_ZONE :
+			if (zone == NULL)
+			{
+				std::memset(triggers,1,nb);
+				return;
+			}
+			zone->containsBatch(group.getPositionArray() + begin,nb,triggers);
+			for (size_t i = 0; i < nb; ++i)
+				if (triggers[i] == 0)
+					modifyWrongSide(group.getParticle(begin + i),true);
+			return;
+
+		case OUTSIDE_ZONE :
+			if (zone == NULL)
+			{
+				std::memset(triggers,0,nb);
+				return;
+			}
+			zone->containsBatch(group.getPositionArray() + begin,nb,triggers);
+			for (size_t i = 0; i < nb; ++i)
+			{
+				if (triggers[i] != 0)
+					modifyWrongSide(group.getParticle(begin + i),false);
+				triggers[i] ^= 1;
+			}
+			return;
+
+		case INTERSECT_ZONE :
+			if (zone == NULL)
+			{
+				std::memset(triggers,0,nb);
+				return;
+			}
+			zone->intersectsBatch(group.getOldPositionArray() + begin,group.getPositionArray() + begin,nb,triggers);
+			return;
+
+		case ENTER_ZONE :
+		case EXIT_ZONE :
+			if (zone == NULL)
+			{
+				std::memset(triggers,0,nb);
+				return;
+			}
+			if (containmentBuffer != NULL)
+			{
+				ZoneIntersection intersection;
+				for (size_t i = 0; i < nb; ++i)
+					triggers[i] = checkCachedTrigger(group.getParticle(begin + i),intersection) ? 1 : 0;
+				return;
+			}
+
+			// Both tests are performed on the whole range before the wrong sides are handled
+			unsigned char wrongSides[Zone::BATCH_SIZE];
+			const unsigned char wrongSide = trigger == ENTER_ZONE ? 1 : 0;
+			for (size_t blockBegin = 0; blockBegin < nb; blockBegin += Zone::BATCH_SIZE)
+			{
+				size_t blockSize = std::min(nb - blockBegin,Zone::BATCH_SIZE);
+				size_t index = begin + blockBegin;
+				zone->containsBatch(group.getOldPositionArray() + index,blockSize,wrongSides);
+				zone->intersectsBatch(group.getOldPositionArray() + index,group.getPositionArray() + index,blockSize,triggers + blockBegin);
+				for (size_t i = 0; i < blockSize; ++i)
+					if (wrongSides[i] == wrongSide)
+					{
+						triggers[blockBegin + i] = 0;
+						modifyWrongSide(group.getParticle(index + i),wrongSide == 1);
+					}
+			}
+			return;
+		}
+
+		std::memset(triggers,0,nb);
 	}
 }
@@ -22,7 +22,6 @@
 
 #include "Core/SPK_Particle.h"
 #include "Core/SPK_Group.h"
-#include "Core/SPK_Modifier.h"
 #include "Core/SPK_System.h"
 #include "Core/SPK_Buffer.h"
 #include "Core/SPK_Interpolator.h"
@@ -30,57 +29,340 @@
 
 namespace SPK
 {
+	// Layout of a parameter in the arrays of a model whose flags are known at compile time
+	// The indices are computed from the layout of the previous parameter
+	template<int ENABLE,int MUTABLE,int RANDOM,int INTERPOLATED,int PARAM>
+	struct ParamLayout
+	{
+		typedef ParamLayout<ENABLE,MUTABLE,RANDOM,INTERPOLATED,PARAM - 1> Previous;
+
+		enum
+		{
+			IS_ENABLED = (ENABLE >> PARAM) & 1,
+			IS_MUTABLE = (MUTABLE >> PARAM) & 1,
+			IS_RANDOM = (RANDOM >> PARAM) & 1,
+			IS_INTERPOLATED = (INTERPOLATED >> PARAM) & 1,
+			ENABLE_INDEX = Previous::ENABLE_INDEX + Previous::IS_ENABLED, // index in the current params
+			MUTABLE_INDEX = Previous::MUTABLE_INDEX + Previous::IS_MUTABLE, // index in the extended params
+			INTERPOLATED_INDEX = Previous::INTERPOLATED_INDEX + Previous::IS_INTERPOLATED,
+			MODEL_INDEX = Previous::MODEL_INDEX + Previous::MODEL_SIZE, // index in the params of the model
+			MODEL_SIZE = ((IS_ENABLED)&&(!IS_INTERPOLATED)) ? (1 + IS_MUTABLE) << IS_RANDOM : 0,
+		};
+	};
+
+	template<int ENABLE,int MUTABLE,int RANDOM,int INTERPOLATED>
+	struct ParamLayout<ENABLE,MUTABLE,RANDOM,INTERPOLATED,-1>
+	{
+		enum
+		{
+			IS_ENABLED = 0,
+			IS_MUTABLE = 0,
+			IS_RANDOM = 0,
+			IS_INTERPOLATED = 0,
+			ENABLE_INDEX = 0,
+			MUTABLE_INDEX = 0,
+			INTERPOLATED_INDEX = 0,
+			MODEL_INDEX = 0,
+			MODEL_SIZE = 0,
+		};
+	};
+
+	// Initializes and updates the parameters of a particle from PARAM to the last one
+	// All the tests on the flags are resolved at compile time
+	template<int ENABLE,int MUTABLE,int RANDOM,int INTERPOLATED,int PARAM>
+	struct LayoutKernel
+	{
+		typedef ParamLayout<ENABLE,MUTABLE,RANDOM,INTERPOLATED,PARAM> Layout;
+		typedef LayoutKernel<ENABLE,MUTABLE,RANDOM,INTERPOLATED,PARAM + 1> Next;
+
+		// number of mutable parameters, the extended params of the interpolated parameters come after them
+		static const size_t NB_MUTABLE = ParamLayout<ENABLE,MUTABLE,RANDOM,INTERPOLATED,PARAM_CUSTOM_2 + 1>::MUTABLE_INDEX;
+
+		static void init(float* currentParams,float* extendedParams,size_t pitch,const float* modelParams,Interpolator* const* interpolators,RandomGenerator& randomGenerator)
+		{
+			const float* templateIt = modelParams + Layout::MODEL_INDEX;
+			float& currentParam = currentParams[Layout::ENABLE_INDEX * pitch];
+
+			if (Layout::IS_INTERPOLATED)
+			{
+				float* interpolatedIt = extendedParams + (NB_MUTABLE + Layout::INTERPOLATED_INDEX * 3) * pitch;
+				currentParam = Model::getDefaultValue(static_cast<ModelParam>(PARAM));
+				interpolatedIt[0] = randomGenerator.random(0.0f,1.0f); // ratioY
+
+				const Interpolator* interpolator = interpolators[PARAM];
+				float offsetVariation = interpolator->getOffsetXVariation();
+				float scaleVariation = interpolator->getScaleXVariation();
+
+				interpolatedIt[pitch] = randomGenerator.random(-offsetVariation,offsetVariation); // offsetX
+				interpolatedIt[pitch << 1] = 1.0f + randomGenerator.random(-scaleVariation,scaleVariation); // scaleX
+			}
+			else if (Layout::IS_RANDOM)
+			{
+				currentParam = randomGenerator.random(*templateIt,*(templateIt + 1));
+				if (Layout::IS_MUTABLE)
+					extendedParams[Layout::MUTABLE_INDEX * pitch] = randomGenerator.random(*(templateIt + 2),*(templateIt + 3));
+			}
+			else if (Layout::IS_ENABLED)
+			{
+				currentParam = *templateIt;
+				if (Layout::IS_MUTABLE)
+					extendedParams[Layout::MUTABLE_INDEX * pitch] = *(templateIt + 1);
+			}
+
+			Next::init(currentParams,extendedParams,pitch,modelParams,interpolators,randomGenerator);
+		}
+
+		static void update(float* currentParams,const float* extendedParams,size_t pitch,float ratio)
+		{
+			if (Layout::IS_MUTABLE)
+			{
+				float& currentParam = currentParams[Layout::ENABLE_INDEX * pitch];
+				currentParam += (extendedParams[Layout::MUTABLE_INDEX * pitch] - currentParam) * ratio;
+			}
+
+			Next::update(currentParams,extendedParams,pitch,ratio);
+		}
+	};
+
+	template<int ENABLE,int MUTABLE,int RANDOM,int INTERPOLATED>
+	struct LayoutKernel<ENABLE,MUTABLE,RANDOM,INTERPOLATED,PARAM_CUSTOM_2 + 1>
+	{
+		static void init(float*,float*,size_t,const float*,Interpolator* const*,RandomGenerator&) {}
+		static void update(float*,const float*,size_t,float) {}
+	};
+
 	Particle::Particle(Group* group,size_t index) :
-		group(group),
-		index(index),
-		data(group->particleData + index),
-		currentParams(group->particleCurrentParams + index * group->model->getSizeOfParticleCurrentArray()),
-		extendedParams(group->particleExtendedParams + index * group->model->getSizeOfParticleExtendedArray())
+		data(&group->particleData),
+		index(index)
+	{}
+
+	Particle::Particle(ParticleData* data,size_t index) :
+		data(data),
+		index(index)
+	{}
+
+	void Particle::init()
 	{
-		init();
+		const Model* model = data->group->getModel();
+		RandomGenerator& randomGenerator = getRandomGenerator();
+		data->ages[index] = 0.0f;
+		data->lives[index] = randomGenerator.random(model->lifeTimeMin,model->lifeTimeMax);
+
+		if (model->nbInitTemplates > 0)
+			copyTemplate(*model,randomGenerator.random<size_t>(0,model->nbInitTemplates));
+		else
+			(*model->initKernel)(*model,*this);
 	}
 
-	void Particle::init()
+	void Particle::copyTemplate(const Model& model,size_t templateIndex)
 	{
-		const Model* model = group->getModel();
-		data->age = 0.0f;
-		data->life = random(model->lifeTimeMin,model->lifeTimeMax);
+		// The templates are stored as the parameters of the particles : the current arrays followed by the extended ones
+		size_t nbParams = model.nbEnableParams;
+		for (size_t i = 0; i < nbParams; ++i)
+			currentParam(i) = model.initTemplates[i * model.nbInitTemplates + templateIndex];
+
+		const float* extendedTemplates = model.initTemplates + nbParams * model.nbInitTemplates;
+		nbParams = model.getSizeOfParticleExtendedArray();
+		for (size_t i = 0; i < nbParams; ++i)
+			extendedParam(i) = extendedTemplates[i * model.nbInitTemplates + templateIndex];
+	}
+
+	void Particle::initParticles(Group& group,size_t begin,size_t end)
+	{
+		ParticleData& data = group.particleData;
+		const Model* model = group.getModel();
+
+		if (model->nbInitTemplates == 0)
+		{
+			for (size_t i = begin; i < end; ++i)
+				group.pool[i].init();
+			return;
+		}
+
+		// The life times are still drawn for each particle so that the particles cloned from the same template do not die together
+		std::fill(data.ages + begin,data.ages + end,0.0f);
+		data.randomGenerator->generate(data.lives + begin,end - begin,model->lifeTimeMin,model->lifeTimeMax);
+
+		// The parameters are copied from consecutive templates, starting from a random one
+		const size_t nbTemplates = model->nbInitTemplates;
+		const size_t nbCurrentParams = model->nbEnableParams;
+		const size_t nbExtendedParams = model->getSizeOfParticleExtendedArray();
+		const float* extendedTemplates = model->initTemplates + nbCurrentParams * nbTemplates;
+
+		size_t templateIndex = data.randomGenerator->random<size_t>(0,nbTemplates);
+		while (begin < end)
+		{
+			size_t nb = std::min(end - begin,nbTemplates - templateIndex);
+
+			for (size_t i = 0; i < nbCurrentParams; ++i)
+			{
+				const float* templateIt = model->initTemplates + i * nbTemplates + templateIndex;
+				std::copy(templateIt,templateIt + nb,data.currentParams + i * data.pitch + begin);
+			}
+
+			for (size_t i = 0; i < nbExtendedParams; ++i)
+			{
+				const float* templateIt = extendedTemplates + i * nbTemplates + templateIndex;
+				std::copy(templateIt,templateIt + nb,data.extendedParams + i * data.pitch + begin);
+			}
+
+			begin += nb;
+			templateIndex = 0;
+		}
+	}
+
+	void Particle::bakeTemplates(Model& model,RandomGenerator& randomGenerator)
+	{
+		// The templates are generated by the kernels of the model as if they were the parameters of particles of a group
+		ParticleData data;
+		data.group = NULL;
+		data.randomGenerator = &randomGenerator;
+		data.pitch = model.nbInitTemplates;
+		data.oldPositions = data.positions = data.velocities = NULL;
+		data.ages = data.lives = data.sqrDists = NULL;
+		data.currentParams = model.initTemplates;
+		data.extendedParams = model.initTemplates + model.nbEnableParams * model.nbInitTemplates;
+
+		for (size_t i = 0; i < model.nbInitTemplates; ++i)
+		{
+			Particle particle(&data,i);
+			(*model.initKernel)(model,particle);
+		}
+	}
+
+	template<int ENABLE,int MUTABLE,int RANDOM,int INTERPOLATED>
+	void Particle::initLayout(const Model& model,Particle& particle)
+	{
+		ParticleData& data = *particle.data;
+		LayoutKernel<ENABLE,MUTABLE,RANDOM,INTERPOLATED,0>::init(data.currentParams + particle.index,data.extendedParams + particle.index,data.pitch,model.params,model.interpolators,*data.randomGenerator);
+	}
+
+	template<int ENABLE,int MUTABLE,int RANDOM,int INTERPOLATED>
+	void Particle::updateLayout(Group& group,size_t begin,size_t end,float deltaTime)
+	{
+		ParticleData& data = group.particleData;
+		for (size_t i = begin; i < end; ++i)
+			data.ages[i] += deltaTime;
+
+		if (group.getModel()->immortal)
+			return;
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			// computes the ratio between the life of the particle and its lifetime
+			float ratio = std::min(1.0f,deltaTime / data.lives[i]);
+			data.lives[i] -= deltaTime;
+
+			LayoutKernel<ENABLE,MUTABLE,RANDOM,INTERPOLATED,0>::update(data.currentParams + i,data.extendedParams + i,data.pitch,ratio);
+		}
+	}
+
+	void Particle::initGeneric(const Model& model,Particle& particle)
+	{
+		particle.initParameters(model);
+	}
+
+	void Particle::updateGeneric(Group& group,size_t begin,size_t end,float deltaTime)
+	{
+		for (size_t i = begin; i < end; ++i)
+			group.pool[i].update(deltaTime);
+	}
+
+	void Particle::selectKernels(Model& model)
+	{
+		struct KernelLayout
+		{
+			int enableFlag;
+			int mutableFlag;
+			int randomFlag;
+			int interpolatedFlag;
+			void (*initKernel)(const Model&,Particle&);
+			void (*updateKernel)(Group&,size_t,size_t,float);
+		};
+
+		// The flags are given as they are stored in a model : the color is always enabled and the other flags are subsets of the enable flag
+#define SPK_KERNEL_LAYOUT(enableFlag,mutableFlag,randomFlag,interpolatedFlag) \
+		{enableFlag,mutableFlag,randomFlag,interpolatedFlag,&initLayout<enableFlag,mutableFlag,randomFlag,interpolatedFlag>,&updateLayout<enableFlag,mutableFlag,randomFlag,interpolatedFlag>}
+
+		static const int RGB = FLAG_RED | FLAG_GREEN | FLAG_BLUE;
+		static const int RGBA = RGB | FLAG_ALPHA;
+		static const KernelLayout LAYOUTS[] =
+		{
+			SPK_KERNEL_LAYOUT(RGB,FLAG_NONE,FLAG_NONE,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA,FLAG_NONE,FLAG_NONE,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA,FLAG_ALPHA,FLAG_NONE,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA,FLAG_ALPHA,RGB,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA,RGBA,FLAG_NONE,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA,RGBA,RGB,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA | FLAG_SIZE,FLAG_ALPHA,RGB | FLAG_SIZE,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA | FLAG_SIZE,FLAG_ALPHA | FLAG_SIZE,FLAG_NONE,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA | FLAG_SIZE,FLAG_ALPHA | FLAG_SIZE,RGB,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA | FLAG_SIZE,RGBA | FLAG_SIZE,RGB,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA | FLAG_SIZE | FLAG_ANGLE,FLAG_ALPHA | FLAG_SIZE,RGB | FLAG_ANGLE,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA | FLAG_SIZE | FLAG_ANGLE | FLAG_TEXTURE_INDEX,FLAG_ALPHA | FLAG_SIZE,RGB | FLAG_ANGLE | FLAG_TEXTURE_INDEX,FLAG_NONE),
+			SPK_KERNEL_LAYOUT(RGBA | FLAG_SIZE,FLAG_NONE,FLAG_NONE,FLAG_ALPHA | FLAG_SIZE),
+			SPK_KERNEL_LAYOUT(RGBA | FLAG_SIZE,FLAG_NONE,RGB,FLAG_ALPHA | FLAG_SIZE),
+		};
+
+#undef SPK_KERNEL_LAYOUT
+
+		for (size_t i = 0; i < sizeof(LAYOUTS) / sizeof(KernelLayout); ++i)
+		{
+			const KernelLayout& layout = LAYOUTS[i];
+			if ((layout.enableFlag == model.enableFlag)
+				&&(layout.mutableFlag == model.mutableFlag)
+				&&(layout.randomFlag == model.randomFlag)
+				&&(layout.interpolatedFlag == model.interpolatedFlag))
+			{
+				model.initKernel = layout.initKernel;
+				model.updateKernel = layout.updateKernel;
+				return;
+			}
+		}
+
+		model.initKernel = &initGeneric;
+		model.updateKernel = &updateGeneric;
+	}
+
+	void Particle::initParameters(const Model& model)
+	{
+		RandomGenerator& randomGenerator = getRandomGenerator();
 
 		// creates pseudo-iterators to parse arrays
-		float* particleCurrentIt = currentParams;
-		float* particleMutableIt = extendedParams;
-		float* particleInterpolatedIt = extendedParams + model->nbMutableParams;
-		const int* paramIt = model->enableParams;
+		size_t particleCurrentIt = 0;
+		size_t particleMutableIt = 0;
+		size_t particleInterpolatedIt = model.nbMutableParams;
+		const int* paramIt = model.enableParams;
 
 		// initializes params
-		for (size_t i = model->nbEnableParams; i != 0; --i)
+		for (size_t i = model.nbEnableParams; i != 0; --i)
 		{
 			ModelParam param = static_cast<ModelParam>(*paramIt);
-			const float* templateIt = &model->params[model->indices[param]];
+			const float* templateIt = &model.params[model.indices[param]];
 
-			if (model->isInterpolated(param))
+			if (model.isInterpolated(param))
 			{
-				*particleCurrentIt++ = Model::DEFAULT_VALUES[param];
-				*particleInterpolatedIt++ = random(0.0f,1.0f); // ratioY
+				currentParam(particleCurrentIt++) = Model::DEFAULT_VALUES[param];
+				extendedParam(particleInterpolatedIt++) = randomGenerator.random(0.0f,1.0f); // ratioY
 
-				Interpolator* interpolator = model->interpolators[param];
+				Interpolator* interpolator = model.interpolators[param];
 				float offsetVariation = interpolator->getOffsetXVariation();
 				float scaleVariation = interpolator->getScaleXVariation();
 
-				*particleInterpolatedIt++ = random(-offsetVariation,offsetVariation); // offsetX
-				*particleInterpolatedIt++ = 1.0f + random(-scaleVariation,scaleVariation); // scaleX
+				extendedParam(particleInterpolatedIt++) = randomGenerator.random(-offsetVariation,offsetVariation); // offsetX
+				extendedParam(particleInterpolatedIt++) = 1.0f + randomGenerator.random(-scaleVariation,scaleVariation); // scaleX
 			}
-			else if (model->isRandom(param))
+			else if (model.isRandom(param))
 			{
-				*particleCurrentIt++ = random(*templateIt,*(templateIt + 1));
-				if (model->isMutable(param))
-					*particleMutableIt++ = random(*(templateIt + 2),*(templateIt + 3));
+				currentParam(particleCurrentIt++) = randomGenerator.random(*templateIt,*(templateIt + 1));
+				if (model.isMutable(param))
+					extendedParam(particleMutableIt++) = randomGenerator.random(*(templateIt + 2),*(templateIt + 3));
 			}
 			else 
 			{
-					*particleCurrentIt++ = *templateIt;
-				if (model->isMutable(param))
-					*particleMutableIt++ = *(templateIt + 1);
+				currentParam(particleCurrentIt++) = *templateIt;
+				if (model.isMutable(param))
+					extendedParam(particleMutableIt++) = *(templateIt + 1);
 			}
 
 			++paramIt;
@@ -89,64 +371,47 @@ namespace SPK
 
 	void Particle::interpolateParameters()
 	{
-		const Model* model = group->getModel();
+		const Model* model = data->group->getModel();
 
-		float* interpolatedIt = extendedParams + model->nbMutableParams;
+		size_t interpolatedIt = model->nbMutableParams;
 		for (size_t i = 0; i < model->nbInterpolatedParams; ++i)
 		{
 			size_t index = model->interpolatedParams[i];
 			size_t enableIndex = model->particleEnableIndices[index];
-			currentParams[enableIndex] = model->interpolators[index]->interpolate(*this,static_cast<ModelParam>(index),interpolatedIt[0],interpolatedIt[1],interpolatedIt[2]);
+			currentParam(enableIndex) = model->interpolators[index]->interpolate(*this,static_cast<ModelParam>(index),extendedParam(interpolatedIt),extendedParam(interpolatedIt + 1),extendedParam(interpolatedIt + 2));
 			interpolatedIt += 3;
 		}
 	}
 
-	bool Particle::update(float deltaTime)
+	void Particle::update(float deltaTime)
 	{
+		const Group* group = data->group;
 		const Model* model = group->getModel();
-		data->age += deltaTime;
+		data->ages[index] += deltaTime;
 
 		if (!model->immortal)
 		{
 			// computes the ratio between the life of the particle and its lifetime
-			float ratio = std::min(1.0f,deltaTime / data->life);
-			data->life -= deltaTime;
+			float ratio = std::min(1.0f,deltaTime / data->lives[index]);
+			data->lives[index] -= deltaTime;
 			
 			// updates mutable parameters
 			for (size_t i = 0; i < model->nbMutableParams; ++i)
 			{
-				size_t index = model->mutableParams[i];
-				size_t enableIndex = model->particleEnableIndices[index];
-				currentParams[enableIndex] += (extendedParams[i] - currentParams[enableIndex]) * ratio;
+				size_t enableIndex = model->particleEnableIndices[model->mutableParams[i]];
+				currentParam(enableIndex) += (extendedParam(i) - currentParam(enableIndex)) * ratio;
 			}
 		}
 
-		// updates interpolated parameters
-		interpolateParameters();
-
-		// updates position
-		oldPosition() = position();
-		position() += velocity() * deltaTime;
-
-		// updates velocity
-		velocity() += group->getGravity() * deltaTime;
-
-		std::vector<Modifier*>::const_iterator end = group->activeModifiers.end();
-		for (std::vector<Modifier*>::const_iterator it = group->activeModifiers.begin(); it != end; ++it)
-			(*it)->process(*this,deltaTime);
-
-		if (group->getFriction() != 0.0f)
-			velocity() *= 1.0f - std::min(1.0f,group->getFriction() * deltaTime / getParamCurrentValue(PARAM_MASS));
-
-		return data->life <= 0.0f;
+		// interpolated parameters, position, velocity, modifiers and friction are then updated by the group on a range of particles
 	}
 
 	bool Particle::setParamCurrentValue(ModelParam type,float value)
 	{
-		const Model* const model = group->getModel();
+		const Model* const model = data->group->getModel();
 		if (model->isEnabled(type))
 		{
-			currentParams[model->particleEnableIndices[type]] = value;
+			currentParam(model->particleEnableIndices[type]) = value;
 			return true;
 		}
 
@@ -155,10 +420,10 @@ namespace SPK
 
 	bool Particle::setParamFinalValue(ModelParam type,float value)
 	{
-		const Model* const model = group->getModel();
+		const Model* const model = data->group->getModel();
 		if (model->isMutable(type))
 		{
-			extendedParams[model->particleMutableIndices[type]] = value;
+			extendedParam(model->particleMutableIndices[type]) = value;
 			return true;
 		}
 
@@ -167,10 +432,10 @@ namespace SPK
 
 	bool Particle::changeParamCurrentValue(ModelParam type,float delta)
 	{
-		const Model* const model = group->getModel();
+		const Model* const model = data->group->getModel();
 		if (model->isEnabled(type))
 		{
-			currentParams[model->particleEnableIndices[type]] += delta;
+			currentParam(model->particleEnableIndices[type]) += delta;
 			return true;
 		}
 
@@ -179,10 +444,10 @@ namespace SPK
 
 	bool Particle::changeParamFinalValue(ModelParam type,float delta)
 	{
-		const Model* const model = group->getModel();
+		const Model* const model = data->group->getModel();
 		if (model->isMutable(type))
 		{
-			extendedParams[model->particleMutableIndices[type]] += delta;
+			extendedParam(model->particleMutableIndices[type]) += delta;
 			return true;
 		}
 
@@ -191,21 +456,21 @@ namespace SPK
 
 	float Particle::getParamCurrentValue(ModelParam type) const
 	{
-		const Model* const model = group->getModel();
+		const Model* const model = data->group->getModel();
 		if (model->isEnabled(type))
-			return currentParams[model->particleEnableIndices[type]];
+			return currentParam(model->particleEnableIndices[type]);
 
 		return Model::DEFAULT_VALUES[type];
 	}
 
 	float Particle::getParamFinalValue(ModelParam type) const
 	{
-		const Model* const model = group->getModel();
+		const Model* const model = data->group->getModel();
 		if (model->isEnabled(type))
 		{
 			if (model->isMutable(type))
-				return extendedParams[model->particleMutableIndices[type] + 1];
-			return currentParams[model->particleEnableIndices[type]];
+				return extendedParam(model->particleMutableIndices[type]);
+			return currentParam(model->particleEnableIndices[type]);
 		}
 
 		return Model::DEFAULT_VALUES[type];
@@ -213,25 +478,36 @@ namespace SPK
 
 	Model* Particle::getModel() const
 	{
-		return group->getModel();
+		return data->group->getModel();
 	}
 
 	void Particle::computeSqrDist()
 	{
-		data->sqrDist = getSqrDist(position(),System::getCameraPosition());
+		data->sqrDists[index] = getSqrDist(position(),System::getCameraPosition());
 	}
 
 	extern void swapParticles(Particle& a,Particle& b)
 	{
-		//std::swap(a.index,b.index);
-		std::swap(*a.data,*b.data);
-		for (size_t i = 0; i < a.getModel()->getSizeOfParticleCurrentArray(); ++i)
-			std::swap(a.currentParams[i],b.currentParams[i]);
-		for (size_t i = 0; i < a.getModel()->getSizeOfParticleExtendedArray(); ++i)
-			std::swap(a.extendedParams[i],b.extendedParams[i]);
+		// swaps particle data (particles are assumed to be from the same group)
+		Particle::ParticleData& data = *a.data;
+		size_t i0 = a.index;
+		size_t i1 = b.index;
+
+		std::swap(data.oldPositions[i0],data.oldPositions[i1]);
+		std::swap(data.positions[i0],data.positions[i1]);
+		std::swap(data.velocities[i0],data.velocities[i1]);
+		std::swap(data.ages[i0],data.ages[i1]);
+		std::swap(data.lives[i0],data.lives[i1]);
+		std::swap(data.sqrDists[i0],data.sqrDists[i1]);
+
+		const Model* model = data.group->getModel();
+		for (size_t i = 0; i < model->getSizeOfParticleCurrentArray(); ++i)
+			std::swap(a.currentParam(i),b.currentParam(i));
+		for (size_t i = 0; i < model->getSizeOfParticleExtendedArray(); ++i)
+			std::swap(a.extendedParam(i),b.extendedParam(i));
 		
-		// swap additional data (groups are assumed to be the same)
-		for (std::set<Buffer*>::iterator it = a.group->swappableBuffers.begin(); it != a.group->swappableBuffers.end(); ++it)
-			(*it)->swap(a.index,b.index);
+		// swap additional data
+		for (std::vector<Buffer*>::const_iterator it = data.group->swappableBuffers.begin(); it != data.group->swappableBuffers.end(); ++it)
+			(*it)->swap(i0,i1);
 	}
 }
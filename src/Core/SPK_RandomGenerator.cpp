@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Core/SPK_RandomGenerator.h"
+#include "Core/SPK_Kernel.h"
+
+#include <mutex>
+
+namespace SPK
+{
+	void RandomGenerator::generate(float* values,size_t nb,float min,float max)
+	{
+		while (nb > 0)
+		{
+			// the numbers are generated in runs that stop when the counter wraps around (2^32 - counter numbers are left with the current key)
+			size_t nbInRun = nb;
+			if (nb > static_cast<size_t>(~counter))
+				nbInRun = static_cast<size_t>(~counter) + 1;
+
+			generateRandomValues(values,nbInRun,key,counter,min,max);
+
+			counter += static_cast<unsigned int>(nbInRun);
+			if (counter == 0)
+				key = hash(key + COUNTER_STEP);
+
+			values += nbInRun;
+			nb -= nbInRun;
+		}
+	}
+
+	// Gives a distinct seed to the RandomGenerator of each thread, the first thread getting the default seed
+	static unsigned int getThreadSeed()
+	{
+		static std::mutex seedMutex;
+		static unsigned int nbSeeds = 0;
+
+		std::lock_guard<std::mutex> lock(seedMutex);
+		return ++nbSeeds;
+	}
+
+	RandomGenerator& getThreadRandomGenerator()
+	{
+		static thread_local RandomGenerator randomGenerator(getThreadSeed());
+		return randomGenerator;
+	}
+}
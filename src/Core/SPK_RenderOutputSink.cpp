@@ -0,0 +1,196 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "Core/SPK_RenderOutputSink.h"
+
+namespace SPK
+{
+	const size_t RenderOutputSink::NO_REGION;
+	const size_t RenderOutputSink::STATE_BITS;
+	const size_t RenderOutputSink::STATE_MASK;
+
+	RenderOutputSink::RenderOutputSink(size_t nbRegions) :
+		regions(new Region[nbRegions]),
+		nbRegions(nbRegions),
+		fenceCallback(NULL),
+		fenceData(NULL),
+		producer(NULL),
+		nextSequence(1),
+		nextRegion(0),
+		nbDroppedOutputs(0)
+	{
+		for (size_t i = 0; i < nbRegions; ++i)
+		{
+			regions[i].memory = NULL;
+			regions[i].size = 0;
+			regions[i].nbParticles = 0;
+			regions[i].nbBytes = 0;
+			regions[i].state = getWord(0,REGION_FREE);
+		}
+	}
+
+	RenderOutputSink::~RenderOutputSink()
+	{
+		delete[] regions;
+	}
+
+	void RenderOutputSink::setRegion(size_t index,void* memory,size_t size)
+	{
+		Region& region = regions[index];
+		region.memory = memory;
+		region.size = size;
+		region.nbParticles = 0;
+		region.nbBytes = 0;
+		region.state = changeState(region.state,REGION_FREE);
+	}
+
+	void RenderOutputSink::setFenceCallback(FenceCallback callback,void* data)
+	{
+		fenceCallback = callback;
+		fenceData = data;
+	}
+
+	bool RenderOutputSink::write(const Group& group)
+	{
+		if ((producer != NULL)&&(producer != &group))
+			return false;
+
+		recycleRegions();
+
+		size_t sequence = nextSequence++;
+		size_t index = acquireRegion(sequence);
+		if (index == NO_REGION)
+		{
+			++nbDroppedOutputs;
+			return false;
+		}
+
+		Region& region = regions[index];
+		region.nbParticles = writeOutput(group,region.memory,region.size,region.nbBytes);
+		region.state = getWord(sequence,REGION_READY); // publishes the output
+		return true;
+	}
+
+	size_t RenderOutputSink::acquireOutput()
+	{
+		size_t latest;
+		size_t latestWord;
+		do
+		{
+			latest = NO_REGION;
+			latestWord = 0;
+			for (size_t i = 0; i < nbRegions; ++i)
+			{
+				size_t word = regions[i].state;
+				if ((getState(word) == REGION_READY)&&((latest == NO_REGION)||(isOlder(latestWord,word))))
+				{
+					latest = i;
+					latestWord = word;
+				}
+			}
+
+			if (latest == NO_REGION)
+				return NO_REGION;
+		}
+		while (!regions[latest].state.compare_exchange_strong(latestWord,changeState(latestWord,REGION_READING)));
+
+		// The older outputs will never be acquired
+		for (size_t i = 0; i < nbRegions; ++i)
+		{
+			size_t word = regions[i].state;
+			if ((getState(word) == REGION_READY)&&(isOlder(word,latestWord)))
+				regions[i].state.compare_exchange_strong(word,changeState(word,REGION_FREE));
+		}
+
+		return latest;
+	}
+
+	void RenderOutputSink::releaseOutput(size_t index)
+	{
+		// Only the consumer changes the state of a region being read
+		Region& region = regions[index];
+		region.state = changeState(region.state,fenceCallback != NULL ? REGION_FENCED : REGION_FREE);
+	}
+
+	size_t RenderOutputSink::acquireRegion(size_t sequence)
+	{
+		// A free region is searched from the one following the last region written,
+		// otherwise the oldest output not acquired yet is overwritten.
+		// Both are searched in a single pass : when the consumer releases a region and acquires another one during the pass,
+		// the region it acquires was holding an output and the older outputs it drops become free, so one of them is still found
+		size_t first = nextRegion++;
+		size_t index;
+		size_t word;
+		do
+		{
+			size_t free = NO_REGION;
+			size_t freeWord = 0;
+			size_t oldest = NO_REGION;
+			size_t oldestWord = 0;
+			for (size_t i = 0; (i < nbRegions)&&(free == NO_REGION); ++i)
+			{
+				size_t current = (first + i) % nbRegions;
+				size_t currentWord = regions[current].state;
+				if ((getState(currentWord) == REGION_FREE)&&(regions[current].memory != NULL))
+				{
+					free = current;
+					freeWord = currentWord;
+				}
+				else if ((getState(currentWord) == REGION_READY)&&((oldest == NO_REGION)||(isOlder(currentWord,oldestWord))))
+				{
+					oldest = current;
+					oldestWord = currentWord;
+				}
+			}
+
+			if (free != NO_REGION)
+			{
+				index = free;
+				word = freeWord;
+			}
+			else if (oldest != NO_REGION)
+			{
+				index = oldest;
+				word = oldestWord;
+			}
+			else
+				return NO_REGION;
+		}
+		while (!regions[index].state.compare_exchange_strong(word,getWord(sequence,REGION_WRITING)));
+
+		return index;
+	}
+
+	void RenderOutputSink::recycleRegions()
+	{
+		if (fenceCallback == NULL)
+			return;
+
+		for (size_t i = 0; i < nbRegions; ++i)
+		{
+			size_t word = regions[i].state;
+			if ((getState(word) == REGION_FENCED)&&((*fenceCallback)(i,fenceData)))
+				regions[i].state.compare_exchange_strong(word,changeState(word,REGION_FREE));
+		}
+	}
+}
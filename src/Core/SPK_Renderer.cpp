@@ -22,6 +22,7 @@
 
 #include "Core/SPK_Renderer.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_GroupSnapshot.h"
 
 namespace SPK
 {
@@ -34,4 +35,14 @@ namespace SPK
 	{}
 
 	Renderer::~Renderer(){}
+
+	int Renderer::getSnapshotChannels() const
+	{
+		return SNAPSHOT_POSITIONS | SNAPSHOT_SORTED_INDICES | SNAPSHOT_AABB;
+	}
+
+	int Renderer::getSnapshotParams() const
+	{
+		return FLAG_RED | FLAG_GREEN | FLAG_BLUE | FLAG_ALPHA | FLAG_SIZE | FLAG_ANGLE | FLAG_TEXTURE_INDEX;
+	}
 }
@@ -25,6 +25,7 @@
 #include "Core/SPK_Vector3D.h"
 #include "Core/SPK_Emitter.h"
 #include "Core/SPK_Modifier.h"
+#include "Core/SPK_ThreadPool.h"
 
 namespace SPK
 {
@@ -46,7 +47,9 @@ namespace SPK
 		boundingBoxEnabled(false),
 		AABBMin(),
 		AABBMax(),
-		deltaStep(0.0f)
+		deltaStep(0.0f),
+		parallelUpdateEnabled(false),
+		aliveGroups()
 	{}
 
 	void System::registerChildren(bool registerAll)
@@ -115,9 +118,22 @@ namespace SPK
 			AABBMax = vec3(-maxFloat,-maxFloat,-maxFloat);
 		}
 
-		for (std::vector<Group*>::iterator it = groups.begin(); it != groups.end(); ++it)
+		bool parallel = (parallelUpdateEnabled)&&(groups.size() > 1)&&(canUpdateGroupsInParallel());
+		if (parallel)
+		{
+			aliveGroups.resize(groups.size());
+			UpdateTaskData taskData = {this,deltaTime};
+			ThreadPool::getInstance().run(&System::updateGroupTask,&taskData,groups.size());
+		}
+
+		for (size_t i = 0; i < groups.size(); ++i)
 		{
-			isAlive |= (*it)->update(deltaTime);
+			std::vector<Group*>::iterator it = groups.begin() + i;
+
+			if (parallel)
+				isAlive |= aliveGroups[i] != 0;
+			else
+				isAlive |= (*it)->update(deltaTime);
 			nbParticles += (*it)->getNbParticles();
 
 			if ((boundingBoxEnabled)&&((*it)->isAABBComputingEnabled()))
@@ -149,6 +165,37 @@ namespace SPK
 		return isAlive;
 	}
 
+	void System::updateGroupTask(void* data,size_t index)
+	{
+		UpdateTaskData* taskData = static_cast<UpdateTaskData*>(data);
+		System* system = taskData->system;
+		system->aliveGroups[index] = system->groups[index]->update(taskData->deltaTime);
+	}
+
+	bool System::canUpdateGroupsInParallel() const
+	{
+		// The objects modified by the update of a Group must not be shared with another Group
+		// The modifiers held by other modifiers (within a ModifierGroup for instance) are checked as well
+		std::vector<const Registerable*> updatedObjects;
+		std::vector<const Modifier*> groupModifiers;
+		for (std::vector<Group*>::const_iterator it = groups.begin(); it != groups.end(); ++it)
+		{
+			updatedObjects.push_back(*it);
+			updatedObjects.insert(updatedObjects.end(),(*it)->getEmitters().begin(),(*it)->getEmitters().end());
+
+			// A Modifier held several times by the same Group is only updated by that Group
+			groupModifiers.clear();
+			for (std::vector<Modifier*>::const_iterator modifierIt = (*it)->getModifiers().begin(); modifierIt != (*it)->getModifiers().end(); ++modifierIt)
+				(*modifierIt)->getProcessingModifiers(groupModifiers);
+			std::sort(groupModifiers.begin(),groupModifiers.end());
+			groupModifiers.erase(std::unique(groupModifiers.begin(),groupModifiers.end()),groupModifiers.end());
+			updatedObjects.insert(updatedObjects.end(),groupModifiers.begin(),groupModifiers.end());
+		}
+
+		std::sort(updatedObjects.begin(),updatedObjects.end());
+		return std::adjacent_find(updatedObjects.begin(),updatedObjects.end()) == updatedObjects.end();
+	}
+
 	bool System::update(float deltaTime)
 	{
 		if ((clampStepEnabled)&&(deltaTime > clampStep))
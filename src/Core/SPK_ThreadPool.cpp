@@ -0,0 +1,154 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Core/SPK_ThreadPool.h"
+
+namespace SPK
+{
+	ThreadPool* ThreadPool::instance = NULL;
+
+	ThreadPool::ThreadPool() :
+		nbWorkers(0),
+		workers(),
+		stopping(false),
+		batches()
+	{
+		// the calling thread also processes tasks
+		unsigned int nbHardwareThreads = std::thread::hardware_concurrency();
+		if (nbHardwareThreads > 1)
+			nbWorkers = nbHardwareThreads - 1;
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		stopWorkers();
+	}
+
+	ThreadPool& ThreadPool::getInstance()
+	{
+		if (instance == NULL)
+			instance = new ThreadPool;
+		return *instance;
+	}
+
+	void ThreadPool::destroyInstance()
+	{
+		if (instance != NULL)
+		{
+			delete instance;
+			instance = NULL;
+		}
+	}
+
+	void ThreadPool::setNbWorkers(size_t nbWorkers)
+	{
+		stopWorkers();
+		this->nbWorkers = nbWorkers;
+	}
+
+	void ThreadPool::run(Task task,void* data,size_t nbTasks)
+	{
+		if (nbTasks == 0)
+			return;
+
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if ((nbWorkers == 0)||(nbTasks == 1))
+		{
+			lock.unlock();
+			for (size_t i = 0; i < nbTasks; ++i)
+				(*task)(data,i);
+			return;
+		}
+
+		if (workers.empty())
+			startWorkers();
+
+		Batch batch = {task,data,nbTasks,0,0};
+		batches.push_back(&batch);
+		taskCondition.notify_all();
+
+		// The calling thread processes tasks as well until all of them are started
+		while (processTask(batch,lock)) {}
+
+		while (batch.nbDone < batch.nbTasks)
+			doneCondition.wait(lock);
+	}
+
+	void ThreadPool::startWorkers()
+	{
+		workers.reserve(nbWorkers);
+		for (size_t i = 0; i < nbWorkers; ++i)
+			workers.push_back(std::thread(&ThreadPool::work,this));
+	}
+
+	void ThreadPool::stopWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		taskCondition.notify_all();
+
+		for (std::vector<std::thread>::iterator it = workers.begin(); it != workers.end(); ++it)
+			it->join();
+		workers.clear();
+
+		stopping = false;
+	}
+
+	void ThreadPool::work()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true)
+		{
+			while ((!stopping)&&(batches.empty()))
+				taskCondition.wait(lock);
+
+			if (stopping)
+				return;
+
+			processTask(*batches.front(),lock);
+		}
+	}
+
+	bool ThreadPool::processTask(Batch& batch,std::unique_lock<std::mutex>& lock)
+	{
+		if (batch.nextTask >= batch.nbTasks)
+			return false;
+
+		size_t index = batch.nextTask++;
+
+		// A batch stays in the queue only while it has tasks to start
+		if (batch.nextTask == batch.nbTasks)
+			batches.erase(std::find(batches.begin(),batches.end(),&batch));
+
+		lock.unlock();
+		(*batch.task)(batch.data,index);
+		lock.lock();
+
+		if (++batch.nbDone == batch.nbTasks)
+			doneCondition.notify_all();
+
+		return true;
+	}
+}
@@ -21,10 +21,13 @@
 
 
 #include "Core/SPK_Zone.h"
+#include "Core/SPK_Group.h"
 
 namespace SPK
 {
 	const float Zone::APPROXIMATION_VALUE = 0.01f;
+	const float Zone::PI = 3.1415926535897932384626433832795f;
+	const size_t Zone::BATCH_SIZE;
 
 	Zone::Zone(const vec3& position) :
 		Registerable(),
@@ -32,4 +35,27 @@ namespace SPK
 	{
 		setPosition(position);
 	}
+
+	void Zone::generatePositions(Group& group,size_t begin,size_t end,bool full) const
+	{
+		for (size_t i = begin; i < end; ++i)
+			generatePosition(group.getParticle(i),full);
+	}
+
+	void Zone::containsBatch(const vec3* points,size_t nb,unsigned char* results) const
+	{
+		for (size_t i = 0; i < nb; ++i)
+			results[i] = contains(points[i]) ? 1 : 0;
+	}
+
+	void Zone::intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const
+	{
+		for (size_t i = 0; i < nb; ++i)
+			results[i] = intersects(starts[i],ends[i],NULL,NULL) ? 1 : 0;
+	}
+
+	bool Zone::getAABB(vec3& AABBMin,vec3& AABBMax) const
+	{
+		return false;
+	}
 }
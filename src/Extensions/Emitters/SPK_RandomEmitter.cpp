@@ -22,19 +22,22 @@
 
 #include "Extensions/Emitters/SPK_RandomEmitter.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
+#include "Core/SPK_Kernel.h"
 
 namespace SPK
 {
 	void RandomEmitter::generateVelocity(Particle& particle,float speed) const
 	{
-		float norm;
-		do 
-		{
-			particle.velocity() = vec3(random(-1.0f,1.0f),random(-1.0f,1.0f),random(-1.0f,1.0f));
-//			norm = particle.velocity().getNorm();
-			norm = glm::length(particle.velocity());
-		}
-		while((norm > 1.0f) || (norm == 0.0f));
-		particle.velocity() *= speed / norm;
+		generateDirections(&particle.velocity(),1,particle.getRandomGenerator());
+		particle.velocity() *= speed;
+	}
+
+	void RandomEmitter::generateVelocities(Group& group,size_t begin,size_t end,const float* speeds) const
+	{
+		vec3* velocities = group.getVelocityArray();
+		generateDirections(velocities + begin,end - begin,group.getRandomGenerator());
+		for (size_t i = begin; i < end; ++i)
+			velocities[i] *= speeds[i - begin];
 	}
 }
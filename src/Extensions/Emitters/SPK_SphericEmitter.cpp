@@ -22,6 +22,7 @@
 
 #include "Extensions/Emitters/SPK_SphericEmitter.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
 
 namespace SPK
 {
@@ -102,9 +103,10 @@ namespace SPK
 
 	void SphericEmitter::generateVelocity(Particle& particle,float speed) const
 	{
-		float a = random(cosAngleMax,cosAngleMin);
+		RandomGenerator& randomGenerator = particle.getRandomGenerator();
+		float a = randomGenerator.random(cosAngleMax,cosAngleMin);
 		float theta = std::acos(a);
-		float phi = random(0.0f,2.0f * PI);
+		float phi = randomGenerator.random(0.0f,2.0f * PI);
 
 		float sinTheta = std::sin(theta);
 		float x = sinTheta * std::cos(phi);
@@ -116,6 +118,31 @@ namespace SPK
 		particle.velocity().z = speed * (matrix[6] * x + matrix[7] * y + matrix[8] * z);
 	}
 
+	void SphericEmitter::generateVelocities(Group& group,size_t begin,size_t end,const float* speeds) const
+	{
+		RandomGenerator& randomGenerator = group.getRandomGenerator();
+		vec3* velocities = group.getVelocityArray();
+		size_t nb = end - begin;
+
+		// The speeds come by blocks of Zone::BATCH_SIZE at most
+		float cosThetas[Zone::BATCH_SIZE];
+		float phis[Zone::BATCH_SIZE];
+		randomGenerator.generate(cosThetas,nb,cosAngleMax,cosAngleMin);
+		randomGenerator.generate(phis,nb,0.0f,2.0f * PI);
+
+		for (size_t i = 0; i < nb; ++i)
+		{
+			float sinTheta = std::sqrt(std::max(0.0f,1.0f - cosThetas[i] * cosThetas[i]));
+			float x = sinTheta * std::cos(phis[i]);
+			float y = sinTheta * std::sin(phis[i]);
+			float z = cosThetas[i];
+
+			velocities[begin + i] = vec3(matrix[0] * x + matrix[1] * y + matrix[2] * z,
+				matrix[3] * x + matrix[4] * y + matrix[5] * z,
+				matrix[6] * x + matrix[7] * y + matrix[8] * z) * speeds[i];
+		}
+	}
+
 	void SphericEmitter::innerUpdateTransform()
 	{
 		Emitter::innerUpdateTransform();
@@ -21,6 +21,7 @@
 
 
 #include "Extensions/Emitters/SPK_StraightEmitter.h"
+#include "Core/SPK_Group.h"
 
 
 namespace SPK
@@ -47,4 +48,11 @@ namespace SPK
 //		tDirection.normalize();
 		tDirection = glm::normalize(tDirection);
 	}
+
+	void StraightEmitter::generateVelocities(Group& group,size_t begin,size_t end,const float* speeds) const
+	{
+		vec3* velocities = group.getVelocityArray();
+		for (size_t i = begin; i < end; ++i)
+			velocities[i] = tDirection * speeds[i - begin];
+	}
 }
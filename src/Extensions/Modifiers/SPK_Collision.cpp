@@ -22,13 +22,19 @@
 
 #include "Extensions/Modifiers/SPK_Collision.h"
 #include "Core/SPK_Group.h"
+#include "Core/SPK_ThreadPool.h"
 
 
 namespace SPK
 {
 	Collision::Collision(float scale,float elasticity) :
 		Modifier(),
-		scale(scale)
+		scale(scale),
+		parallelNarrowPhaseEnabled(false),
+		preparedGroup(NULL),
+		cellSize(1.0f),
+		nbInsertedParticles(0),
+		nbSyncedParticles(0)
 	{
 		setElasticity(elasticity);
 	}
@@ -36,89 +42,390 @@ namespace SPK
 	void Collision::modify(Particle& particle,float deltaTime) const
 	{
 		size_t index = particle.getIndex();
-		float radius1 = particle.getParamCurrentValue(PARAM_SIZE) * scale * 0.5f;
-		float m1 = particle.getParamCurrentValue(PARAM_MASS);
 		Group& group = *particle.getGroup();
+		ParamAccessor sizes = group.getParamAccessor(PARAM_SIZE);
+		ParamAccessor masses = group.getParamAccessor(PARAM_MASS);
+		float radius1 = getRadius(sizes,index);
 
 		// Tests collisions with all the particles that are stored before in the pool
 		for (size_t i = 0; i < index; ++i)
+			resolveCollision(particle,group.getParticle(i),radius1,getRadius(sizes,i),masses);
+	}
+
+	bool Collision::resolveCollision(Particle& particle,Particle& particle2,float radius1,float radius2,const ParamAccessor& masses) const
+	{
+		bool moved = false;
+
+		float sqrRadius = radius1 + radius2;
+		sqrRadius *= sqrRadius;
+
+		// Gets the normal of the collision plane
+		vec3 normal = particle.position();
+		normal -= particle2.position();
+		float sqrDist = glm::length2(normal);
+
+		if (sqrDist < sqrRadius) // particles are intersecting each other
 		{
-			Particle& particle2 = group.getParticle(i);
-			float radius2 = particle2.getParamCurrentValue(PARAM_SIZE) * scale * 0.5f;				
-			
-			float sqrRadius = radius1 + radius2;
-			sqrRadius *= sqrRadius;
-
-			// Gets the normal of the collision plane
-			vec3 normal = particle.position();
-			normal -= particle2.position();
-//			float sqrDist = normal.getSqrNorm();
-			float sqrDist = glm::length2(normal);
-
-			if (sqrDist < sqrRadius) // particles are intersecting each other
-			{
-				vec3 delta = particle.velocity();
-				delta -= particle2.velocity();
+			vec3 delta = particle.velocity();
+			delta -= particle2.velocity();
 
-				if (dotProduct(normal,delta) < 0.0f) // particles are moving towards each other
+			if (dotProduct(normal,delta) < 0.0f) // particles are moving towards each other
+			{
+				float oldSqrDist = getSqrDist(particle.oldPosition(),particle2.oldPosition());
+				if (oldSqrDist > sqrDist)
 				{
-					float oldSqrDist = getSqrDist(particle.oldPosition(),particle2.oldPosition());
-					if (oldSqrDist > sqrDist)
-					{
-						// Disables the move from this frame
-						particle.position() = particle.oldPosition();
-						particle2.position() = particle2.oldPosition();
+					// Disables the move from this frame
+					particle.position() = particle.oldPosition();
+					particle2.position() = particle2.oldPosition();
+					moved = true;
 
-						normal = particle.position();
-						normal -= particle2.position();
+					normal = particle.position();
+					normal -= particle2.position();
 
-						if (dotProduct(normal,delta) >= 0.0f)
-							continue;
-					}
+					if (dotProduct(normal,delta) >= 0.0f)
+						return moved;
+				}
 
-//					normal.normalize();
-					normal = glm::normalize(normal);
+				normal = glm::normalize(normal);
 
-					// Gets the normal components of the velocities
-					vec3 normal1(normal);
-					vec3 normal2(normal);
-					normal1 *= dotProduct(normal,particle.velocity());
-					normal2 *= dotProduct(normal,particle2.velocity());
+				// Gets the normal components of the velocities
+				vec3 normal1(normal);
+				vec3 normal2(normal);
+				normal1 *= dotProduct(normal,particle.velocity());
+				normal2 *= dotProduct(normal,particle2.velocity());
 
-					// Resolves collision
-					float m2 = particle2.getParamCurrentValue(PARAM_MASS);
+				// Resolves collision
+				float m1 = masses[particle.getIndex()];
+				float m2 = masses[particle2.getIndex()];
 
-					if (oldSqrDist < sqrRadius && sqrDist < sqrRadius)
+				if (oldSqrDist < sqrRadius && sqrDist < sqrRadius)
+				{
+					// Tweak to separate particles that intersects at both t - deltaTime and t
+					// In that case the collision is no more considered as punctual
+					if (dotProduct(normal,normal1) < 0.0f)
 					{
-						// Tweak to separate particles that intersects at both t - deltaTime and t
-						// In that case the collision is no more considered as punctual
-						if (dotProduct(normal,normal1) < 0.0f)
-						{
-							particle.velocity() -= normal1;
-							particle2.velocity() += normal1;
-						}
-
-						if (dotProduct(normal,normal2) > 0.0f)
-						{
-							particle2.velocity() -= normal2;
-							particle.velocity() += normal2;
-						}
+						particle.velocity() -= normal1;
+						particle2.velocity() += normal1;
 					}
-					else
-					{
-						// Else classic collision equations are applied
-						// Tangent components of the velocities are left untouched
-						particle.velocity() -= (1.0f + (elasticity * m2 - m1) / (m1 + m2)) * normal1;
-						particle2.velocity() -= (1.0f + (elasticity * m1 - m2) / (m1 + m2)) * normal2;
-
-						normal1 *= ((1.0f + elasticity) * m1) / (m1 + m2);
-						normal2 *= ((1.0f + elasticity) * m2) / (m1 + m2);
 
+					if (dotProduct(normal,normal2) > 0.0f)
+					{
+						particle2.velocity() -= normal2;
 						particle.velocity() += normal2;
-						particle2.velocity() += normal1;
 					}
 				}
+				else
+				{
+					// Else classic collision equations are applied
+					// Tangent components of the velocities are left untouched
+					particle.velocity() -= (1.0f + (elasticity * m2 - m1) / (m1 + m2)) * normal1;
+					particle2.velocity() -= (1.0f + (elasticity * m1 - m2) / (m1 + m2)) * normal2;
+
+					normal1 *= ((1.0f + elasticity) * m1) / (m1 + m2);
+					normal2 *= ((1.0f + elasticity) * m2) / (m1 + m2);
+
+					particle.velocity() += normal2;
+					particle2.velocity() += normal1;
+				}
 			}
 		}
+
+		return moved;
+	}
+
+	float Collision::getRadius(const ParamAccessor& sizes,size_t index) const
+	{
+		return sizes[index] * scale * 0.5f;
+	}
+
+	void Collision::updateCellSize(const Group& group) const
+	{
+		float maxDiameter = std::abs(Model::getDefaultValue(PARAM_SIZE) * scale);
+
+		ParamAccessor sizes = group.getParamAccessor(PARAM_SIZE);
+		if (sizes.isEnabled())
+		{
+			maxDiameter = 0.0f;
+			for (size_t i = 0; i < group.getNbParticles(); ++i)
+				maxDiameter = std::max(maxDiameter,std::abs(sizes[i] * scale));
+		}
+
+		if ((maxDiameter > 0.0f)&&(maxDiameter <= std::numeric_limits<float>::max()))
+			cellSize = maxDiameter;
+		else
+			cellSize = 1.0f;
+	}
+
+	void Collision::prepareProcess(Group& group)
+	{
+		size_t nb = group.getNbParticles();
+		preparedGroup = &group;
+
+		// The cells are as large as the largest particle at the beginning of the frame
+		// A particle that grows larger during the frame is kept apart and tested against all the others
+		updateCellSize(group);
+
+		size_t nbBuckets = 16;
+		while (nbBuckets < nb * 2)
+			nbBuckets <<= 1;
+
+		buckets.assign(nbBuckets,static_cast<unsigned int>(NO_PARTICLE));
+		nextParticles.resize(nb);
+		particleBuckets.resize(nb);
+		largeParticles.clear();
+		nbInsertedParticles = 0;
+		nbSyncedParticles = 0;
+	}
+
+	void Collision::modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const
+	{
+		// The only trigger of a Collision is ALWAYS so all the particles of the range are processed
+		if ((parallelNarrowPhaseEnabled)&&(begin == 0)&&(end == group.getNbParticles()))
+		{
+			modifyCells(group);
+			return;
+		}
+
+		// Safety check in case the processing was not prepared for this group or this range
+		if ((&group != preparedGroup)||(end > nextParticles.size()))
+		{
+			Modifier::modifyBatch(group,begin,end,deltaTime);
+			return;
+		}
+
+		// The parameters are resolved for the processed group as a Collision can be shared by several groups
+		ParamAccessor sizes = group.getParamAccessor(PARAM_SIZE);
+		ParamAccessor masses = group.getParamAccessor(PARAM_MASS);
+
+		// The particles of the previous range may have been moved since by the modifiers following this Collision
+		for (; nbSyncedParticles < nbInsertedParticles; ++nbSyncedParticles)
+			moveParticle(nbSyncedParticles,group.getParticle(nbSyncedParticles).position());
+
+		// The particles skipped since the last range (not triggered within a ModifierGroup) are inserted first
+		for (; nbInsertedParticles < begin; ++nbInsertedParticles)
+			insertParticle(nbInsertedParticles,group.getParticle(nbInsertedParticles).position(),getRadius(sizes,nbInsertedParticles));
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			Particle& particle = group.getParticle(i);
+			float radius = getRadius(sizes,i);
+
+			// Tests collisions with the particles that are stored before in the pool and lie in the neighbouring cells
+			// They are tested in the order of the pool so that the results are the same as with the brute force algorithm
+			findCandidates(group,i,radius);
+			for (std::vector<unsigned int>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+			{
+				Particle& particle2 = group.getParticle(*it);
+				if (resolveCollision(particle,particle2,radius,getRadius(sizes,*it),masses))
+					moveParticle(*it,particle2.position());
+			}
+
+			insertParticle(i,particle.position(),radius);
+		}
+
+		nbInsertedParticles = std::max(nbInsertedParticles,end);
+	}
+
+	void Collision::findCandidates(Group& group,size_t index,float radius) const
+	{
+		candidates.clear();
+
+		// The searched cells cover both positions of the particle as it may be moved back to its old position
+		const Particle& particle = group.getParticle(index);
+		const vec3& position = particle.position();
+		const vec3& oldPosition = particle.oldPosition();
+		float reach = (cellSize * 0.5f + std::abs(radius)) * 1.001f; // a margin is kept for rounding errors
+
+		int minX = getCellCoordinate(std::min(position.x,oldPosition.x) - reach);
+		int minY = getCellCoordinate(std::min(position.y,oldPosition.y) - reach);
+		int minZ = getCellCoordinate(std::min(position.z,oldPosition.z) - reach);
+		int maxX = getCellCoordinate(std::max(position.x,oldPosition.x) + reach);
+		int maxY = getCellCoordinate(std::max(position.y,oldPosition.y) + reach);
+		int maxZ = getCellCoordinate(std::max(position.z,oldPosition.z) + reach);
+
+		// If there are more cells to search than buckets, the particle is tested against all the previous ones
+		double nbCells = (static_cast<double>(maxX) - minX + 1.0) * (static_cast<double>(maxY) - minY + 1.0) * (static_cast<double>(maxZ) - minZ + 1.0);
+		if (!(nbCells <= buckets.size()))
+		{
+			for (size_t i = 0; i < index; ++i)
+				candidates.push_back(static_cast<unsigned int>(i));
+			return;
+		}
+
+		// Several cells can share a bucket so the buckets are only parsed once
+		visitedBuckets.clear();
+		for (int x = minX; x <= maxX; ++x)
+			for (int y = minY; y <= maxY; ++y)
+				for (int z = minZ; z <= maxZ; ++z)
+					visitedBuckets.push_back(getBucket(x,y,z));
+
+		std::sort(visitedBuckets.begin(),visitedBuckets.end());
+		visitedBuckets.erase(std::unique(visitedBuckets.begin(),visitedBuckets.end()),visitedBuckets.end());
+
+		for (std::vector<unsigned int>::const_iterator it = visitedBuckets.begin(); it != visitedBuckets.end(); ++it)
+			for (unsigned int i = buckets[*it]; i != NO_PARTICLE; i = nextParticles[i])
+				candidates.push_back(i);
+
+		candidates.insert(candidates.end(),largeParticles.begin(),largeParticles.end());
+		std::sort(candidates.begin(),candidates.end());
+	}
+
+	void Collision::insertParticle(size_t index,const vec3& position,float radius) const
+	{
+		if (!(std::abs(radius) * 2.0f <= cellSize))
+		{
+			largeParticles.push_back(static_cast<unsigned int>(index));
+			particleBuckets[index] = NO_PARTICLE;
+			return;
+		}
+
+		unsigned int bucket = getBucket(getCellCoordinate(position.x),getCellCoordinate(position.y),getCellCoordinate(position.z));
+		nextParticles[index] = buckets[bucket];
+		buckets[bucket] = static_cast<unsigned int>(index);
+		particleBuckets[index] = bucket;
+	}
+
+	void Collision::moveParticle(size_t index,const vec3& position) const
+	{
+		unsigned int bucket = particleBuckets[index];
+		if (bucket == NO_PARTICLE) // large particles are not in the buckets
+			return;
+
+		unsigned int newBucket = getBucket(getCellCoordinate(position.x),getCellCoordinate(position.y),getCellCoordinate(position.z));
+		if (newBucket == bucket)
+			return;
+
+		unsigned int* link = &buckets[bucket];
+		while (*link != index)
+			link = &nextParticles[*link];
+		*link = nextParticles[index];
+
+		nextParticles[index] = buckets[newBucket];
+		buckets[newBucket] = static_cast<unsigned int>(index);
+		particleBuckets[index] = newBucket;
+	}
+
+	unsigned int Collision::getBucket(int x,int y,int z) const
+	{
+		unsigned int hash = (static_cast<unsigned int>(x) * 73856093u) ^ (static_cast<unsigned int>(y) * 19349663u) ^ (static_cast<unsigned int>(z) * 83492791u);
+		return hash & static_cast<unsigned int>(buckets.size() - 1);
+	}
+
+	int Collision::getCellCoordinate(float coordinate) const
+	{
+		// The coordinates are clamped so that they fit in an int
+		const int limit = 1 << 30;
+		float cell = std::floor(coordinate / cellSize);
+
+		if (!(cell > -limit))
+			return -limit;
+		if (cell > limit)
+			return limit;
+		return static_cast<int>(cell);
+	}
+
+	void Collision::modifyCells(Group& group) const
+	{
+		size_t nb = group.getNbParticles();
+		if (nb == 0)
+			return;
+
+		// The cells are as large as the largest particle so that colliding particles are in neighbouring cells
+		updateCellSize(group);
+
+		cellEntries.resize(nb);
+		for (size_t i = 0; i < nb; ++i)
+		{
+			const vec3& position = group.getParticle(i).position();
+			CellEntry entry = {getCellCoordinate(position.x),getCellCoordinate(position.y),getCellCoordinate(position.z),static_cast<unsigned int>(i)};
+			cellEntries[i] = entry;
+		}
+		std::sort(cellEntries.begin(),cellEntries.end());
+
+		cells.clear();
+		for (size_t i = 0; i < nb; ++i)
+		{
+			const CellEntry& entry = cellEntries[i];
+			if ((cells.empty())||(entry.x != cells.back().x)||(entry.y != cells.back().y)||(entry.z != cells.back().z))
+			{
+				Cell cell = {entry.x,entry.y,entry.z,i,i};
+				cells.push_back(cell);
+			}
+			cells.back().end = i + 1;
+		}
+
+		// The cells are split into 27 sets depending on their coordinates modulo 3
+		// 2 cells of a set are at least 3 cells apart so that the particles they modify are distinct
+		size_t offsets[28] = {0};
+		for (std::vector<Cell>::const_iterator it = cells.begin(); it != cells.end(); ++it)
+			++offsets[getCellSet(*it) + 1];
+		for (size_t i = 1; i < 28; ++i)
+			offsets[i] += offsets[i - 1];
+
+		size_t positions[27];
+		std::copy(offsets,offsets + 27,positions);
+		coloredCells.resize(cells.size());
+		for (size_t i = 0; i < cells.size(); ++i)
+			coloredCells[positions[getCellSet(cells[i])]++] = static_cast<unsigned int>(i);
+
+		// The sets are processed one after the other and the cells of a set in parallel
+		for (size_t i = 0; i < 27; ++i)
+		{
+			size_t nbCells = offsets[i + 1] - offsets[i];
+			if (nbCells == 0)
+				continue;
+
+			CellTaskData taskData = {this,&group,&coloredCells[offsets[i]],nbCells};
+			ThreadPool::getInstance().run(&Collision::modifyCellsTask,&taskData,(nbCells + CELLS_PER_TASK - 1) / CELLS_PER_TASK);
+		}
+	}
+
+	void Collision::modifyCellsTask(void* data,size_t index)
+	{
+		CellTaskData* taskData = static_cast<CellTaskData*>(data);
+		size_t begin = index * CELLS_PER_TASK;
+		size_t end = std::min(begin + CELLS_PER_TASK,taskData->nbCells);
+
+		std::vector<unsigned int> cellCandidates;
+		for (size_t i = begin; i < end; ++i)
+			taskData->collision->modifyCell(*taskData->group,taskData->collision->cells[taskData->cellIndices[i]],cellCandidates);
+	}
+
+	void Collision::modifyCell(Group& group,const Cell& cell,std::vector<unsigned int>& cellCandidates) const
+	{
+		ParamAccessor sizes = group.getParamAccessor(PARAM_SIZE);
+		ParamAccessor masses = group.getParamAccessor(PARAM_MASS);
+
+		// Finds the neighbouring cells (including this one)
+		// The cells are sorted so that the 3 neighbours along z of a column are consecutive
+		const Cell* neighbours[27];
+		size_t nbNeighbours = 0;
+		for (int x = -1; x <= 1; ++x)
+			for (int y = -1; y <= 1; ++y)
+			{
+				Cell key = {cell.x + x,cell.y + y,cell.z - 1,0,0};
+				for (std::vector<Cell>::const_iterator it = std::lower_bound(cells.begin(),cells.end(),key);
+					(it != cells.end())&&(it->x == key.x)&&(it->y == key.y)&&(it->z <= cell.z + 1);
+					++it)
+					neighbours[nbNeighbours++] = &*it;
+			}
+
+		for (size_t i = cell.begin; i < cell.end; ++i)
+		{
+			unsigned int index = cellEntries[i].index;
+			Particle& particle = group.getParticle(index);
+			float radius = getRadius(sizes,index);
+
+			// A pair of particles is resolved by the cell of the particle with the greatest index
+			cellCandidates.clear();
+			for (size_t j = 0; j < nbNeighbours; ++j)
+				for (size_t k = neighbours[j]->begin; k < neighbours[j]->end; ++k)
+					if (cellEntries[k].index < index)
+						cellCandidates.push_back(cellEntries[k].index);
+
+			std::sort(cellCandidates.begin(),cellCandidates.end());
+			for (std::vector<unsigned int>::const_iterator it = cellCandidates.begin(); it != cellCandidates.end(); ++it)
+				resolveCollision(particle,group.getParticle(*it),radius,getRadius(sizes,*it),masses);
+		}
 	}
 }
@@ -23,6 +23,7 @@
 #include "Extensions/Modifiers/SPK_Destroyer.h"
 #include "Core/SPK_Particle.h"
 #include "Core/SPK_Zone.h"
+#include "Core/SPK_Group.h"
 
 
 namespace SPK
@@ -36,8 +37,51 @@ namespace SPK
 	void Destroyer::modify(Particle& particle,float deltaTime) const
 	{
 		particle.kill();
-		if ((trigger != INSIDE_ZONE)||(trigger != OUTSIDE_ZONE))
-			particle.position() = intersection;
+	}
+
+	void Destroyer::modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection) const
+	{
+		particle.kill();
+		if ((trigger != INSIDE_ZONE)&&(trigger != OUTSIDE_ZONE))
+			particle.position() = intersection.position;
+	}
+
+	void Destroyer::modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const
+	{
+		if (isAlwaysTriggered())
+		{
+			float* lives = group.getLifeArray();
+			for (size_t i = begin; i < end; ++i)
+				lives[i] = 0.0f;
+			return;
+		}
+
+		if (getZone() == NULL)
+			return;
+
+		// The particles are moved at the intersection with the other triggers
+		if ((trigger == INSIDE_ZONE)||(trigger == OUTSIDE_ZONE))
+		{
+			unsigned char triggers[Zone::BATCH_SIZE];
+			float* lives = group.getLifeArray();
+			for (size_t blockBegin = begin; blockBegin < end; blockBegin += Zone::BATCH_SIZE)
+			{
+				size_t blockEnd = std::min(blockBegin + Zone::BATCH_SIZE,end);
+				checkTriggers(group,blockBegin,blockEnd,triggers);
+				for (size_t i = blockBegin; i < blockEnd; ++i)
+					if (triggers[i - blockBegin] != 0)
+						lives[i] = 0.0f;
+			}
+			return;
+		}
+
+		ZoneIntersection intersection;
+		for (size_t i = begin; i < end; ++i)
+		{
+			Particle& particle = group.getParticle(i);
+			if (checkTrigger(particle,intersection))
+				Destroyer::modify(particle,deltaTime,intersection);
+		}
 	}
 
 	void Destroyer::modifyWrongSide(Particle& particle,bool inside) const
@@ -48,4 +92,13 @@ namespace SPK
 			particle.kill();
 		}
 	}
+
+	void Destroyer::modifyWrongSide(Particle& particle,bool inside,const ModifierContext& context) const
+	{
+		if (context.full)
+		{
+			context.zone->moveAtBorder(particle.position(),inside);
+			particle.kill();
+		}
+	}
 }
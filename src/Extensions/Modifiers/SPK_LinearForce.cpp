@@ -22,6 +22,7 @@
 
 #include "Extensions/Modifiers/SPK_LinearForce.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
 
 namespace SPK
 {
@@ -47,4 +48,41 @@ namespace SPK
 
 		particle.velocity() += tForce * factor;
 	}
+
+	void LinearForce::modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const
+	{
+		if (!isAlwaysTriggered())
+		{
+			unsigned char triggers[Zone::BATCH_SIZE];
+			for (size_t blockBegin = begin; blockBegin < end; blockBegin += Zone::BATCH_SIZE)
+			{
+				size_t blockEnd = std::min(blockBegin + Zone::BATCH_SIZE,end);
+				checkTriggers(group,blockBegin,blockEnd,triggers);
+				for (size_t i = blockBegin; i < blockEnd; ++i)
+					if (triggers[i - blockBegin] != 0)
+						LinearForce::modify(group.getParticle(i),deltaTime);
+			}
+			return;
+		}
+
+		// The accessors are resolved for the processed group as a LinearForce can be shared by several groups
+		ParamAccessor masses = group.getParamAccessor(PARAM_MASS);
+		ParamAccessor factorParams = group.getParamAccessor(factorParam);
+
+		vec3* velocities = group.getVelocityArray();
+		for (size_t i = begin; i < end; ++i)
+		{
+			float factor = deltaTime / masses[i];
+
+			if (factorType != FACTOR_NONE)
+			{
+				float param = factorParams[i];
+				factor *= param;
+				if (factorType == FACTOR_SQUARE)
+					factor *= param;
+			}
+
+			velocities[i] += tForce * factor;
+		}
+	}
 }
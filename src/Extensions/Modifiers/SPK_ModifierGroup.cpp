@@ -21,6 +21,7 @@
 
 
 #include "Extensions/Modifiers/SPK_ModifierGroup.h"
+#include "Core/SPK_Group.h"
 
 namespace SPK
 {
@@ -75,6 +76,36 @@ namespace SPK
 		return NULL;
 	}
 
+	bool ModifierGroup::isThreadSafe() const
+	{
+		// The children process the particles of the range with or without the global zone
+		for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != modifiers.end(); ++it)
+			if (!(*it)->isThreadSafe())
+				return false;
+
+		return true;
+	}
+
+	bool ModifierGroup::needsWholeRange() const
+	{
+		if (globalZone)
+			return false;
+
+		for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != modifiers.end(); ++it)
+			if ((*it)->needsWholeRange())
+				return true;
+
+		return false;
+	}
+
+	void ModifierGroup::getProcessingModifiers(std::vector<const Modifier*>& modifiers) const
+	{
+		Modifier::getProcessingModifiers(modifiers);
+
+		for (std::vector<Modifier*>::const_iterator it = this->modifiers.begin(); it != this->modifiers.end(); ++it)
+			(*it)->getProcessingModifiers(modifiers);
+	}
+
 	void ModifierGroup::addModifier(Modifier* modifier)
 	{
 		if (modifier == NULL)
@@ -106,46 +137,123 @@ namespace SPK
 	}
 
 	void ModifierGroup::modify(Particle& particle,float deltaTime) const
+	{
+		ZoneIntersection intersection;
+		modify(particle,deltaTime,intersection);
+	}
+
+	void ModifierGroup::modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection) const
+	{
+		ModifierContext context = {getZone(),isFullZone()};
+		modify(particle,deltaTime,intersection,context);
+	}
+
+	void ModifierGroup::modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection,const ModifierContext& context) const
 	{
 		std::vector<Modifier*>::const_iterator end = modifiers.end();
 
 		if (globalZone)
 			for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != end; ++it)
-			{
-				Zone* oldZone = (*it)->getZone();
-				(*it)->setZone(getZone());
-				(*it)->modify(particle,deltaTime);
-				(*it)->setZone(oldZone);
-			}
+				(*it)->modify(particle,deltaTime,intersection,context);
 		else
 			for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != end; ++it)
 				(*it)->process(particle,deltaTime);
 	}
 
+	void ModifierGroup::modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const
+	{
+		std::vector<Modifier*>::const_iterator endIt = modifiers.end();
+
+		if (globalZone)
+		{
+			// The zone of this group is tested once per particle for all the children
+			ModifierContext context = {getZone(),isFullZone()};
+			ZoneIntersection intersection;
+
+			if ((needsIntersection)||(needsNormal))
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					Particle& particle = group.getParticle(i);
+					if (checkTrigger(particle,intersection))
+						for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != endIt; ++it)
+							(*it)->modify(particle,deltaTime,intersection,context);
+				}
+				return;
+			}
+
+			unsigned char triggers[Zone::BATCH_SIZE];
+			for (size_t blockBegin = begin; blockBegin < end; blockBegin += Zone::BATCH_SIZE)
+			{
+				size_t blockEnd = std::min(blockBegin + Zone::BATCH_SIZE,end);
+				checkTriggers(group,blockBegin,blockEnd,triggers);
+				for (size_t i = blockBegin; i < blockEnd; ++i)
+					if (triggers[i - blockBegin] != 0)
+						for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != endIt; ++it)
+							(*it)->modify(group.getParticle(i),deltaTime,intersection,context);
+			}
+			return;
+		}
+
+		if (isAlwaysTriggered())
+		{
+			for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != endIt; ++it)
+				(*it)->modifyBatch(group,begin,end,deltaTime);
+			return;
+		}
+
+		// Each run of consecutive particles triggering this group is passed at once to the children
+		ZoneIntersection intersection;
+		size_t runBegin = begin;
+		for (size_t i = begin; i <= end; ++i)
+		{
+			if ((i < end)&&(checkTrigger(group.getParticle(i),intersection)))
+				continue;
+
+			if (runBegin < i)
+				for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != endIt; ++it)
+					(*it)->modifyBatch(group,runBegin,i,deltaTime);
+
+			runBegin = i + 1;
+		}
+	}
+
 	void ModifierGroup::modifyWrongSide(Particle& particle,bool inside) const
+	{
+		ModifierContext context = {getZone(),isFullZone()};
+		modifyWrongSide(particle,inside,context);
+	}
+
+	void ModifierGroup::modifyWrongSide(Particle& particle,bool inside,const ModifierContext& context) const
 	{
 		if (globalZone)
 		{
 			std::vector<Modifier*>::const_iterator end = modifiers.end();
 			for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != end; ++it)
-			{
-				Zone* oldZone = (*it)->getZone();
-				(*it)->setZone(getZone());
-				(*it)->modifyWrongSide(particle,inside);
-				(*it)->setZone(oldZone);
-			}
+				(*it)->modifyWrongSide(particle,inside,context);
 		}
 		else if (handleWrongSide)
 		{
+			// Each child handles the particle if it is on the wrong side of its own zone
+			ZoneIntersection intersection;
 			std::vector<Modifier*>::const_iterator end = modifiers.end();
 			for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != end; ++it)
 				if (((*it)->getZone() != NULL)&&((*it)->getTrigger() != INTERSECT_ZONE))
-					modifyWrongSide(particle,true);
+					(*it)->checkTrigger(particle,intersection);
 		}
 	}
 
+	void ModifierGroup::prepareProcess(Group& group)
+	{
+		std::vector<Modifier*>::iterator end = modifiers.end();
+		for (std::vector<Modifier*>::iterator it = modifiers.begin(); it != end; ++it)
+			(*it)->prepareProcess(group);
+	}
+
 	void ModifierGroup::createBuffers(const Group& group)
 	{
+		Modifier::createBuffers(group);
+
 		std::vector<Modifier*>::iterator end = modifiers.end();
 		for (std::vector<Modifier*>::iterator it = modifiers.begin(); it != end; ++it)
 			(*it)->createBuffers(group);
@@ -153,6 +261,8 @@ namespace SPK
 
 	void ModifierGroup::destroyBuffers(const Group& group)
 	{
+		Modifier::destroyBuffers(group);
+
 		std::vector<Modifier*>::iterator end = modifiers.end();
 		for (std::vector<Modifier*>::iterator it = modifiers.begin(); it != end; ++it)
 			(*it)->destroyBuffers(group);
@@ -160,6 +270,9 @@ namespace SPK
 
 	bool ModifierGroup::checkBuffers(const Group& group)
 	{
+		if (!Modifier::checkBuffers(group))
+			return false;
+
 		std::vector<Modifier*>::iterator end = modifiers.end();
 		for (std::vector<Modifier*>::iterator it = modifiers.begin(); it != end; ++it)
 			if (!(*it)->checkBuffers(group))
@@ -167,4 +280,15 @@ namespace SPK
 
 		return true;
 	}
+
+	bool ModifierGroup::movesParticlesAway() const
+	{
+		// The children may move the particles they process
+		std::vector<Modifier*>::const_iterator end = modifiers.end();
+		for (std::vector<Modifier*>::const_iterator it = modifiers.begin(); it != end; ++it)
+			if ((*it)->movesParticlesAway())
+				return true;
+
+		return Modifier::movesParticlesAway();
+	}
 }
@@ -21,6 +21,7 @@
 
 
 #include "Extensions/Modifiers/SPK_Obstacle.h"
+#include "Core/SPK_Group.h"
 
 
 namespace SPK
@@ -35,6 +36,15 @@ namespace SPK
 
 	void Obstacle::modify(Particle& particle,float deltaTime) const
 	{
+		// Without the result of the trigger, the intersection with the zone is computed
+		ZoneIntersection intersection;
+		if ((getZone() != NULL)&&(getZone()->intersects(particle.oldPosition(),particle.position(),&intersection.position,&intersection.normal)))
+			Obstacle::modify(particle,deltaTime,intersection);
+	}
+
+	void Obstacle::modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection) const
+	{
+		vec3 normal = intersection.normal;
 		vec3& velocity = particle.velocity();
 		velocity = particle.position();
 		velocity -= particle.oldPosition();
@@ -52,6 +62,20 @@ namespace SPK
 		normal *= bouncingRatio;	// normal component
 		velocity -= normal;
 
-		particle.position() = intersection;
+		particle.position() = intersection.position;
+	}
+
+	void Obstacle::modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const
+	{
+		if (getZone() == NULL)
+			return;
+
+		ZoneIntersection intersection;
+		for (size_t i = begin; i < end; ++i)
+		{
+			Particle& particle = group.getParticle(i);
+			if (checkTrigger(particle,intersection))
+				Obstacle::modify(particle,deltaTime,intersection);
+		}
 	}
 }
@@ -23,6 +23,7 @@
 #include "Extensions/Modifiers/SPK_PointMass.h"
 #include "Core/SPK_Particle.h"
 #include "Core/SPK_Zone.h"
+#include "Core/SPK_Group.h"
 
 namespace SPK
 {
@@ -36,15 +37,58 @@ namespace SPK
 		setMinDistance(minDistance);
 	}
 
-	void PointMass::modify(Particle& particle,float deltaTime) const
+	void PointMass::attract(Particle& particle,const Zone* zone,float deltaTime) const
 	{
+		// The position of the point mass is relative to the given zone
 		vec3 force = tPosition;
-		if (getZone() != NULL)
-			force += getZone()->getTransformedPosition();
+		if (zone != NULL)
+			force += zone->getTransformedPosition();
 
 		force -= particle.position();
 //		force *= mass * deltaTime / std::max(sqrMinDistance,force.getSqrNorm());
 		force *= mass * deltaTime / std::max(sqrMinDistance,glm::length2(force));
 		particle.velocity() += force;
 	}
+
+	void PointMass::modify(Particle& particle,float deltaTime) const
+	{
+		attract(particle,getZone(),deltaTime);
+	}
+
+	void PointMass::modify(Particle& particle,float deltaTime,const ZoneIntersection& intersection,const ModifierContext& context) const
+	{
+		attract(particle,context.zone,deltaTime);
+	}
+
+	void PointMass::modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const
+	{
+		if (!isAlwaysTriggered())
+		{
+			unsigned char triggers[Zone::BATCH_SIZE];
+			for (size_t blockBegin = begin; blockBegin < end; blockBegin += Zone::BATCH_SIZE)
+			{
+				size_t blockEnd = std::min(blockBegin + Zone::BATCH_SIZE,end);
+				checkTriggers(group,blockBegin,blockEnd,triggers);
+				for (size_t i = blockBegin; i < blockEnd; ++i)
+					if (triggers[i - blockBegin] != 0)
+						PointMass::modify(group.getParticle(i),deltaTime);
+			}
+			return;
+		}
+
+		vec3 center = tPosition;
+		if (getZone() != NULL)
+			center += getZone()->getTransformedPosition();
+
+		const vec3* positions = group.getPositionArray();
+		vec3* velocities = group.getVelocityArray();
+		const float factor = mass * deltaTime;
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			vec3 force = center - positions[i];
+			force *= factor / std::max(sqrMinDistance,glm::length2(force));
+			velocities[i] += force;
+		}
+	}
 }
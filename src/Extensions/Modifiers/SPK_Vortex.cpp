@@ -21,6 +21,7 @@
 
 #include "Extensions/Modifiers/SPK_Vortex.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
 
 namespace SPK
 {
@@ -37,10 +38,10 @@ namespace SPK
 		setDirection(direction);
 	}
 
-	void Vortex::modify(Particle& particle,float deltaTime) const
+	bool Vortex::rotate(vec3& position,float deltaTime) const
 	{
 		// Distance of the projection point from the position of the vortex
-		float dist = dotProduct(tDirection,particle.position() - tPosition);
+		float dist = dotProduct(tDirection,position - tPosition);
 		
 		// Position of the rotation center (orthogonal projection of the particle)
 		vec3 rotationCenter = tDirection;
@@ -48,30 +49,57 @@ namespace SPK
 		rotationCenter += tPosition;
 
 		// Distance of the particle from the eye of the vortex
-		dist = getDist(rotationCenter,particle.position());
+		dist = getDist(rotationCenter,position);
 
 		if (dist <= eyeRadius)
-		{
-			if (killingParticleEnabled)
-				particle.kill();
-			return;
-		}
+			return !killingParticleEnabled;
 
 		float angle = angularSpeedEnabled ? rotationSpeed * deltaTime : rotationSpeed * deltaTime / dist;
 
 		// Computes ortho base
-		vec3 normal = (particle.position() - rotationCenter) / dist;
+		vec3 normal = (position - rotationCenter) / dist;
         vec3 tangent = crossProduct(tDirection,normal);
 
+		bool alive = true;
         float endRadius = linearSpeedEnabled ? dist * (1.0f - attractionSpeed * deltaTime) : dist - attractionSpeed * deltaTime;
         if (endRadius <= eyeRadius)
 		{
 		    endRadius = eyeRadius;
-		    if (killingParticleEnabled)
-                particle.kill();
+		    alive = !killingParticleEnabled;
+		}
+
+        position = rotationCenter + normal * endRadius * std::cos(angle) + tangent * endRadius * std::sin(angle);
+		return alive;
+	}
+
+	void Vortex::modify(Particle& particle,float deltaTime) const
+	{
+		if (!rotate(particle.position(),deltaTime))
+			particle.kill();
+	}
+
+	void Vortex::modifyBatch(Group& group,size_t begin,size_t end,float deltaTime) const
+	{
+		if (!isAlwaysTriggered())
+		{
+			unsigned char triggers[Zone::BATCH_SIZE];
+			for (size_t blockBegin = begin; blockBegin < end; blockBegin += Zone::BATCH_SIZE)
+			{
+				size_t blockEnd = std::min(blockBegin + Zone::BATCH_SIZE,end);
+				checkTriggers(group,blockBegin,blockEnd,triggers);
+				for (size_t i = blockBegin; i < blockEnd; ++i)
+					if (triggers[i - blockBegin] != 0)
+						Vortex::modify(group.getParticle(i),deltaTime);
+			}
+			return;
 		}
 
-        particle.position() = rotationCenter + normal * endRadius * std::cos(angle) + tangent * endRadius * std::sin(angle);
+		vec3* positions = group.getPositionArray();
+		float* lives = group.getLifeArray();
+
+		for (size_t i = begin; i < end; ++i)
+			if (!rotate(positions[i],deltaTime))
+				lives[i] = 0.0f;
 	}
 
 	void Vortex::innerUpdateTransform()
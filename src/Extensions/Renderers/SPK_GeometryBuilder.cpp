@@ -0,0 +1,435 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "Extensions/Renderers/SPK_GeometryBuilder.h"
+#include "Core/SPK_Group.h"
+#include "Core/SPK_Kernel.h"
+#include "Core/SPK_ThreadPool.h"
+
+namespace SPK
+{
+	const size_t GeometryBuilder::BLOCK_SIZE;
+	const size_t GeometryBuilder::CHUNK_SIZE;
+
+	// The colors of the particles are read in this order by the kernels
+	static const ModelParam COLOR_PARAMS[4] = {PARAM_RED,PARAM_GREEN,PARAM_BLUE,PARAM_ALPHA};
+
+	// Fills the blocks of the colors which are not enabled with their default values
+	static void fillDefaultColors(const ParamAccessor* colors,float* defaultColors,size_t blockSize)
+	{
+		for (size_t i = 0; i < 4; ++i)
+			if (!colors[i].isEnabled())
+				std::fill(defaultColors + i * blockSize,defaultColors + (i + 1) * blockSize,colors[i][0]);
+	}
+
+	// Gets the index of the particle at the given position of the built order
+	static inline size_t getParticleIndex(const unsigned int* indices,size_t index)
+	{
+		return indices != NULL ? indices[index] : index;
+	}
+
+	// Gets the values of the nb particles of a block starting at the given index
+	// With sorted indices, the values are gathered in the sorted order in sortedValues
+	template<typename T>
+	static const T* getBlockValues(const T* values,const unsigned int* indices,size_t index,size_t nb,T* sortedValues)
+	{
+		if (indices == NULL)
+			return values + index;
+
+		for (size_t i = 0; i < nb; ++i)
+			sortedValues[i] = values[indices[index + i]];
+		return sortedValues;
+	}
+
+	// Gets the arrays of colors of the nb particles of a block starting at the given index
+	static void getColorArrays(const ParamAccessor* colors,const float* defaultColors,size_t blockSize,const unsigned int* indices,size_t index,size_t nb,float* sortedColors,const float** arrays)
+	{
+		for (size_t i = 0; i < 4; ++i)
+			arrays[i] = colors[i].isEnabled() ? getBlockValues(colors[i].values,indices,index,nb,sortedColors + i * blockSize) : defaultColors + i * blockSize;
+	}
+
+	struct GeometryBuilder::QuadJob
+	{
+		QuadVertex* vertices;
+		size_t nbParticles;
+		const unsigned int* indices; // sorted indices of the particles or NULL to build them in the order of the Group
+
+		const vec3* positions;
+		const vec3* velocities;
+		ParamAccessor colors[4];
+		ParamAccessor sizes;
+		ParamAccessor angles;
+		ParamAccessor textureIndices;
+
+		const QuadRendererInterface* quadInterface;
+		float scaleX;
+		float scaleY;
+		bool atlas;
+		bool texture3D;
+
+		// Orientation in a 2D world
+		bool oriented2D;
+		Orientation2D orientation2D;
+		vec3 orientationVector;
+
+		// Orientation in a 3D world
+		LookOrientation lookOrientation;
+		UpOrientation upOrientation;
+		LockedAxis lockedAxis;
+		vec3 lookVector;
+		vec3 upVector;
+		vec3 cameraPosition;
+		vec3 globalLook;
+		vec3 globalUp;
+
+		// Vectors shared by all the particles when the orientation is global
+		bool globalOrientation;
+		vec3 look;
+		vec3 up;
+		vec3 side;
+
+		void build(size_t begin,size_t end) const;
+		void computeVectors(size_t begin,size_t nb,vec3* sides,vec3* ups) const;
+	};
+
+	struct GeometryBuilder::LineJob
+	{
+		LineVertex* vertices;
+		size_t nbParticles;
+		const unsigned int* indices;
+
+		const vec3* positions;
+		const vec3* velocities;
+		ParamAccessor colors[4];
+		float length;
+
+		void build(size_t begin,size_t end) const;
+	};
+
+	struct GeometryBuilder::PointJob
+	{
+		PointVertex* vertices;
+		size_t nbParticles;
+		const unsigned int* indices;
+
+		const vec3* positions;
+		ParamAccessor colors[4];
+		ParamAccessor sizes;
+		float size;
+
+		void build(size_t begin,size_t end) const;
+	};
+
+	template<class Job>
+	void GeometryBuilder::run(const Job& job) const
+	{
+		size_t nbChunks = (job.nbParticles + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		if ((parallelBuildEnabled)&&(nbChunks > 1))
+			ThreadPool::getInstance().run(&GeometryBuilder::runChunk<Job>,const_cast<Job*>(&job),nbChunks);
+		else
+			job.build(0,job.nbParticles);
+	}
+
+	template<class Job>
+	void GeometryBuilder::runChunk(void* data,size_t index)
+	{
+		const Job* job = static_cast<const Job*>(data);
+		size_t begin = index * CHUNK_SIZE;
+		job->build(begin,std::min(begin + CHUNK_SIZE,job->nbParticles));
+	}
+
+	size_t GeometryBuilder::buildQuads(const Group& group,const QuadRendererInterface& quadInterface,const Oriented3DRendererInterface& orientationInterface,QuadVertex* vertices,size_t nbMaxVertices) const
+	{
+		QuadJob job;
+		job.oriented2D = false;
+		job.lookOrientation = orientationInterface.getLookOrientation();
+		job.upOrientation = orientationInterface.getUpOrientation();
+		job.lockedAxis = orientationInterface.getLockedAxis();
+		job.lookVector = orientationInterface.lookVector;
+		job.upVector = orientationInterface.upVector;
+		job.cameraPosition = cameraPosition;
+
+		// Same as Oriented3DRendererInterface::precomputeOrientation3D(const Group&,const vec3&,const vec3&,const vec3&)
+		job.globalOrientation = true;
+
+		if (job.lookOrientation == LOOK_CAMERA_PLANE)
+			job.globalLook = -cameraLook;
+		else if (job.lookOrientation == LOOK_AXIS)
+			job.globalLook = job.lookVector;
+		else
+			job.globalOrientation = false;
+
+		if (job.upOrientation == UP_CAMERA)
+			job.globalUp = cameraUp;
+		else if (job.upOrientation == UP_AXIS)
+			job.globalUp = job.upVector;
+		else
+			job.globalOrientation = false;
+
+		if (job.globalOrientation)
+		{
+			job.look = job.globalLook;
+			job.up = job.globalUp;
+			Oriented3DRendererInterface::orientQuadVectors(job.lockedAxis,group.getModel()->isEnabled(PARAM_ANGLE),job.look,job.up,job.side);
+		}
+
+		return buildQuads(job,group,quadInterface,vertices,nbMaxVertices);
+	}
+
+	size_t GeometryBuilder::buildQuads(const Group& group,const QuadRendererInterface& quadInterface,const Oriented2DRendererInterface& orientationInterface,QuadVertex* vertices,size_t nbMaxVertices) const
+	{
+		QuadJob job;
+		job.oriented2D = true;
+		job.orientation2D = orientationInterface.getOrientation();
+		job.orientationVector = orientationInterface.orientationVector;
+
+		// Same as Oriented2DRendererInterface::computeGlobalOrientation2D()
+		job.globalOrientation = true;
+
+		if (job.orientation2D == ORIENTATION2D_UP)
+			job.up = vec3(0.0f,-0.5f,0.0f);
+		else if (job.orientation2D == ORIENTATION2D_AXIS)
+		{
+			job.up = job.orientationVector;
+			Oriented2DRendererInterface::normalizeQuadUp(job.up);
+		}
+		else
+			job.globalOrientation = false;
+
+		return buildQuads(job,group,quadInterface,vertices,nbMaxVertices);
+	}
+
+	size_t GeometryBuilder::buildQuads(QuadJob& job,const Group& group,const QuadRendererInterface& quadInterface,QuadVertex* vertices,size_t nbMaxVertices) const
+	{
+		job.vertices = vertices;
+		job.nbParticles = std::min(group.getNbParticles(),nbMaxVertices >> 2);
+		job.indices = group.getSortedIndices();
+
+		job.positions = group.getPositionArray();
+		job.velocities = group.getVelocityArray();
+		for (size_t i = 0; i < 4; ++i)
+			job.colors[i] = group.getParamAccessor(COLOR_PARAMS[i]);
+		job.sizes = group.getParamAccessor(PARAM_SIZE);
+		job.angles = group.getParamAccessor(PARAM_ANGLE);
+		job.textureIndices = group.getParamAccessor(PARAM_TEXTURE_INDEX);
+
+		job.quadInterface = &quadInterface;
+		job.scaleX = quadInterface.getScaleX();
+		job.scaleY = quadInterface.getScaleY();
+		job.atlas = (quadInterface.getTexturingMode() == TEXTURE_2D)&&(job.textureIndices.isEnabled());
+		job.texture3D = quadInterface.getTexturingMode() == TEXTURE_3D;
+
+		run(job);
+		return job.nbParticles;
+	}
+
+	size_t GeometryBuilder::buildLines(const Group& group,const LineRendererInterface& lineInterface,LineVertex* vertices,size_t nbMaxVertices) const
+	{
+		LineJob job;
+		job.vertices = vertices;
+		job.nbParticles = std::min(group.getNbParticles(),nbMaxVertices >> 1);
+		job.indices = group.getSortedIndices();
+
+		job.positions = group.getPositionArray();
+		job.velocities = group.getVelocityArray();
+		for (size_t i = 0; i < 4; ++i)
+			job.colors[i] = group.getParamAccessor(COLOR_PARAMS[i]);
+		job.length = lineInterface.getLength();
+
+		run(job);
+		return job.nbParticles;
+	}
+
+	size_t GeometryBuilder::buildPoints(const Group& group,const PointRendererInterface& pointInterface,PointVertex* vertices,size_t nbMaxVertices) const
+	{
+		PointJob job;
+		job.vertices = vertices;
+		job.nbParticles = std::min(group.getNbParticles(),nbMaxVertices);
+		job.indices = group.getSortedIndices();
+
+		job.positions = group.getPositionArray();
+		for (size_t i = 0; i < 4; ++i)
+			job.colors[i] = group.getParamAccessor(COLOR_PARAMS[i]);
+		job.sizes = group.getParamAccessor(PARAM_SIZE);
+		job.size = pointInterface.getSize();
+
+		run(job);
+		return job.nbParticles;
+	}
+
+	void GeometryBuilder::buildQuadIndices(unsigned int* indices,size_t nbQuads)
+	{
+		for (size_t i = 0; i < nbQuads; ++i)
+		{
+			unsigned int vertex = static_cast<unsigned int>(i << 2);
+			*(indices++) = vertex;
+			*(indices++) = vertex + 1;
+			*(indices++) = vertex + 2;
+			*(indices++) = vertex;
+			*(indices++) = vertex + 2;
+			*(indices++) = vertex + 3;
+		}
+	}
+
+	void GeometryBuilder::QuadJob::build(size_t begin,size_t end) const
+	{
+		vec3 sides[BLOCK_SIZE];
+		vec3 ups[BLOCK_SIZE];
+		vec3 sortedPositions[BLOCK_SIZE];
+		float defaultColors[4 * BLOCK_SIZE];
+		float sortedColors[4 * BLOCK_SIZE];
+		float textureCoords[5][BLOCK_SIZE];
+		fillDefaultColors(colors,defaultColors,BLOCK_SIZE);
+
+		// Without atlas, the whole texture is mapped on the quads
+		const float defaultTextureCoords[5] = {0.0f,1.0f,0.0f,1.0f,texture3D ? textureIndices[0] : 0.0f};
+		for (size_t i = 0; i < 5; ++i)
+			std::fill(textureCoords[i],textureCoords[i] + BLOCK_SIZE,defaultTextureCoords[i]);
+
+		const float* colorArrays[4];
+		const float* textureCoordArrays[5] = {textureCoords[0],textureCoords[1],textureCoords[2],textureCoords[3],textureCoords[4]};
+
+		for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+		{
+			size_t nb = std::min(end - blockBegin,BLOCK_SIZE);
+			computeVectors(blockBegin,nb,sides,ups);
+
+			if (atlas)
+				for (size_t i = 0; i < nb; ++i)
+					quadInterface->getAtlasCoordinates(textureIndices[getParticleIndex(indices,blockBegin + i)],textureCoords[0][i],textureCoords[1][i],textureCoords[2][i],textureCoords[3][i]);
+			else if ((texture3D)&&(textureIndices.isEnabled()))
+				textureCoordArrays[4] = getBlockValues(textureIndices.values,indices,blockBegin,nb,textureCoords[4]);
+
+			getColorArrays(colors,defaultColors,BLOCK_SIZE,indices,blockBegin,nb,sortedColors,colorArrays);
+			expandQuads(&vertices[blockBegin << 2].position.x,getBlockValues(positions,indices,blockBegin,nb,sortedPositions),sides,ups,colorArrays,textureCoordArrays,nb);
+		}
+	}
+
+	void GeometryBuilder::QuadJob::computeVectors(size_t begin,size_t nb,vec3* sides,vec3* ups) const
+	{
+		const bool rotated = angles.isEnabled();
+
+		for (size_t i = 0; i < nb; ++i)
+		{
+			size_t index = getParticleIndex(indices,begin + i);
+			vec3 quadUp = up;
+			vec3 quadSide = side;
+
+			if (oriented2D)
+			{
+				// Same as Oriented2DRendererInterface::computeSingleOrientation2D(const Particle&)
+				vec3 up2D = up;
+				if (!globalOrientation)
+				{
+					if (orientation2D == ORIENTATION2D_DIRECTION)
+						up2D = velocities[index];
+					else
+						up2D = orientationVector - positions[index];
+					Oriented2DRendererInterface::normalizeQuadUp(up2D);
+				}
+
+				if (rotated)
+					Oriented2DRendererInterface::rotateQuadVectors(up2D,angles[index],quadUp,quadSide);
+				else
+				{
+					quadUp = vec3(up2D.x,up2D.y,0.0f);
+					quadSide = vec3(-up2D.y,up2D.x,0.0f);
+				}
+			}
+			else
+			{
+				// Same as Oriented3DRendererInterface::computeSingleOrientation3D(const Particle&)
+				vec3 quadLook = look;
+				if (!globalOrientation)
+				{
+					if (lookOrientation == LOOK_CAMERA_POINT)
+						quadLook = cameraPosition - positions[index];
+					else if (lookOrientation == LOOK_POINT)
+						quadLook = lookVector - positions[index];
+					else
+						quadLook = globalLook;
+
+					if (upOrientation == UP_DIRECTION)
+						quadUp = velocities[index];
+					else if (upOrientation == UP_POINT)
+						quadUp = upVector - positions[index];
+					else
+						quadUp = globalUp;
+
+					Oriented3DRendererInterface::orientQuadVectors(lockedAxis,rotated,quadLook,quadUp,quadSide);
+				}
+
+				if (rotated)
+				{
+					vec3 rotatedUp;
+					Oriented3DRendererInterface::rotateQuadVectors(quadLook,quadUp,angles[index],rotatedUp,quadSide);
+					quadUp = rotatedUp;
+				}
+			}
+
+			float size = sizes[index];
+			sides[i] = quadSide * (size * scaleX);
+			ups[i] = quadUp * (size * scaleY);
+		}
+	}
+
+	void GeometryBuilder::LineJob::build(size_t begin,size_t end) const
+	{
+		vec3 sortedPositions[BLOCK_SIZE];
+		vec3 sortedVelocities[BLOCK_SIZE];
+		float defaultColors[4 * BLOCK_SIZE];
+		float sortedColors[4 * BLOCK_SIZE];
+		fillDefaultColors(colors,defaultColors,BLOCK_SIZE);
+
+		const float* colorArrays[4];
+		for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+		{
+			size_t nb = std::min(end - blockBegin,BLOCK_SIZE);
+			getColorArrays(colors,defaultColors,BLOCK_SIZE,indices,blockBegin,nb,sortedColors,colorArrays);
+			expandLines(&vertices[blockBegin << 1].position.x,
+				getBlockValues(positions,indices,blockBegin,nb,sortedPositions),
+				getBlockValues(velocities,indices,blockBegin,nb,sortedVelocities),
+				colorArrays,length,nb);
+		}
+	}
+
+	void GeometryBuilder::PointJob::build(size_t begin,size_t end) const
+	{
+		vec3 sortedPositions[BLOCK_SIZE];
+		float defaultColors[4 * BLOCK_SIZE];
+		float sortedColors[4 * BLOCK_SIZE];
+		float pointSizes[BLOCK_SIZE];
+		fillDefaultColors(colors,defaultColors,BLOCK_SIZE);
+
+		const float* colorArrays[4];
+		for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+		{
+			size_t nb = std::min(end - blockBegin,BLOCK_SIZE);
+			for (size_t i = 0; i < nb; ++i)
+				pointSizes[i] = size * sizes[getParticleIndex(indices,blockBegin + i)];
+
+			getColorArrays(colors,defaultColors,BLOCK_SIZE,indices,blockBegin,nb,sortedColors,colorArrays);
+			packPoints(&vertices[blockBegin].position.x,getBlockValues(positions,indices,blockBegin,nb,sortedPositions),colorArrays,pointSizes,nb);
+		}
+	}
+}
@@ -0,0 +1,298 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "Extensions/Renderers/SPK_InstanceExporter.h"
+#include "Core/SPK_Group.h"
+#include "Core/SPK_GroupSnapshot.h"
+#include "Core/SPK_Kernel.h"
+#include "Core/SPK_ThreadPool.h"
+
+namespace SPK
+{
+	const size_t InstanceExporter::NB_ATTRIBUTES;
+	const size_t InstanceExporter::BLOCK_SIZE;
+	const size_t InstanceExporter::CHUNK_SIZE;
+
+	// Number of components of each attribute
+	static const size_t INSTANCE_NB_COMPONENTS[5] = {3,4,1,1,1};
+
+	// Size in bytes of a component in each format
+	static const size_t INSTANCE_COMPONENT_SIZES[6] = {0,4,2,1,2,1};
+
+	// Formats available for each attribute
+	static const unsigned int INSTANCE_AVAILABLE_FORMATS[5] =
+	{
+		(1 << INSTANCE_FORMAT_NONE) | (1 << INSTANCE_FORMAT_FLOAT) | (1 << INSTANCE_FORMAT_HALF),
+		(1 << INSTANCE_FORMAT_NONE) | (1 << INSTANCE_FORMAT_FLOAT) | (1 << INSTANCE_FORMAT_UNORM8),
+		(1 << INSTANCE_FORMAT_NONE) | (1 << INSTANCE_FORMAT_FLOAT) | (1 << INSTANCE_FORMAT_HALF),
+		(1 << INSTANCE_FORMAT_NONE) | (1 << INSTANCE_FORMAT_FLOAT) | (1 << INSTANCE_FORMAT_HALF) | (1 << INSTANCE_FORMAT_UNORM16),
+		(1 << INSTANCE_FORMAT_NONE) | (1 << INSTANCE_FORMAT_FLOAT) | (1 << INSTANCE_FORMAT_UINT8),
+	};
+
+	// Parameters read by the exporter : the color components followed by the size, the angle and the texture index
+	static const size_t INSTANCE_NB_PARAMS = 7;
+	static const ModelParam INSTANCE_PARAMS[INSTANCE_NB_PARAMS] = {PARAM_RED,PARAM_GREEN,PARAM_BLUE,PARAM_ALPHA,PARAM_SIZE,PARAM_ANGLE,PARAM_TEXTURE_INDEX};
+
+	// Copies the packed values of a block of particles in their records
+	// The size being known at compile time, the copies are inlined
+	template<size_t size>
+	static void writeInstanceValues(unsigned char* records,size_t stride,const void* values,size_t nb)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(values);
+		for (size_t i = 0; i < nb; ++i)
+			std::memcpy(records + i * stride,bytes + i * size,size);
+	}
+
+	struct InstanceExporter::ExportJob
+	{
+		unsigned char* instances;
+		size_t nbParticles;
+
+		InstanceFormat formats[NB_ATTRIBUTES];
+		size_t offsets[NB_ATTRIBUTES];
+		size_t stride;
+		vec3 origin;
+
+		const vec3* positions;
+		ParamAccessor params[INSTANCE_NB_PARAMS];
+		const unsigned int* indices; // Order in which the particles are exported or NULL
+
+		void exportParticles(size_t begin,size_t end) const;
+		void exportValues(unsigned char* records,InstanceAttribute attribute,const float* values,size_t nb) const;
+	};
+
+	InstanceExporter::InstanceExporter() :
+		origin(0.0f,0.0f,0.0f),
+		parallelExportEnabled(false)
+	{
+		formats[INSTANCE_POSITION] = INSTANCE_FORMAT_FLOAT;
+		formats[INSTANCE_COLOR] = INSTANCE_FORMAT_UNORM8;
+		formats[INSTANCE_SIZE] = INSTANCE_FORMAT_HALF;
+		formats[INSTANCE_ANGLE] = INSTANCE_FORMAT_UNORM16;
+		formats[INSTANCE_TEXTURE_INDEX] = INSTANCE_FORMAT_UINT8;
+		computeLayout();
+	}
+
+	bool InstanceExporter::setFormat(InstanceAttribute attribute,InstanceFormat format)
+	{
+		if ((INSTANCE_AVAILABLE_FORMATS[attribute] & (1 << format)) == 0)
+			return false;
+
+		formats[attribute] = format;
+		computeLayout();
+		return true;
+	}
+
+	void InstanceExporter::computeLayout()
+	{
+		// The attributes are placed by decreasing alignment so that no padding is needed between them
+		stride = 0;
+		for (size_t alignment = 4; alignment > 0; alignment >>= 1)
+			for (size_t i = 0; i < NB_ATTRIBUTES; ++i)
+			{
+				size_t componentSize = INSTANCE_COMPONENT_SIZES[formats[i]];
+				size_t attributeSize = componentSize * INSTANCE_NB_COMPONENTS[i];
+				size_t attributeAlignment = formats[i] == INSTANCE_FORMAT_UNORM8 ? attributeSize : componentSize;
+
+				if (attributeAlignment == alignment)
+				{
+					offsets[i] = stride;
+					stride += attributeSize;
+				}
+			}
+
+		stride = (stride + 3) & ~static_cast<size_t>(3);
+	}
+
+	size_t InstanceExporter::exportInstances(const Group& group,void* instances,size_t nbMaxInstances) const
+	{
+		ExportJob job;
+		job.positions = group.getPositionArray();
+		for (size_t i = 0; i < INSTANCE_NB_PARAMS; ++i)
+			job.params[i] = group.getParamAccessor(INSTANCE_PARAMS[i]);
+		job.indices = group.getSortedIndices();
+
+		return exportJob(job,instances,std::min(group.getNbParticles(),nbMaxInstances));
+	}
+
+	size_t InstanceExporter::exportInstances(const GroupSnapshot& snapshot,void* instances,size_t nbMaxInstances) const
+	{
+		ExportJob job;
+		job.positions = snapshot.getPositionArray();
+		for (size_t i = 0; i < INSTANCE_NB_PARAMS; ++i)
+			job.params[i] = snapshot.getParamAccessor(INSTANCE_PARAMS[i]);
+		job.indices = snapshot.getSortedIndices();
+
+		return exportJob(job,instances,std::min(snapshot.getNbParticles(),nbMaxInstances));
+	}
+
+	size_t InstanceExporter::exportJob(ExportJob& job,void* instances,size_t nbParticles) const
+	{
+		job.instances = static_cast<unsigned char*>(instances);
+		job.nbParticles = nbParticles;
+
+		for (size_t i = 0; i < NB_ATTRIBUTES; ++i)
+		{
+			job.formats[i] = formats[i];
+			job.offsets[i] = offsets[i];
+		}
+		job.stride = stride;
+		job.origin = origin;
+
+		size_t nbChunks = (job.nbParticles + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		if ((parallelExportEnabled)&&(nbChunks > 1))
+			ThreadPool::getInstance().run(&InstanceExporter::exportChunk,&job,nbChunks);
+		else
+			job.exportParticles(0,job.nbParticles);
+
+		return job.nbParticles;
+	}
+
+	void InstanceExporter::exportChunk(void* data,size_t index)
+	{
+		const ExportJob* job = static_cast<const ExportJob*>(data);
+		size_t begin = index * CHUNK_SIZE;
+		job->exportParticles(begin,std::min(begin + CHUNK_SIZE,job->nbParticles));
+	}
+
+	void InstanceExporter::ExportJob::exportParticles(size_t begin,size_t end) const
+	{
+		// The parameters which are not enabled are read from blocks of default values
+		float defaultValues[INSTANCE_NB_PARAMS][BLOCK_SIZE];
+		for (size_t i = 0; i < INSTANCE_NB_PARAMS; ++i)
+			if (!params[i].isEnabled())
+				std::fill(defaultValues[i],defaultValues[i] + BLOCK_SIZE,params[i][0]);
+
+		// When the particles are sorted, their data is gathered in the order of the indices block per block
+		float sortedValues[INSTANCE_NB_PARAMS][BLOCK_SIZE];
+		vec3 sortedPositions[BLOCK_SIZE];
+
+		vec3 relativePositions[BLOCK_SIZE];
+		unsigned short halves[3 * BLOCK_SIZE];
+		unsigned char colors[4 * BLOCK_SIZE];
+
+		const size_t positionSize = INSTANCE_COMPONENT_SIZES[formats[INSTANCE_POSITION]] * INSTANCE_NB_COMPONENTS[INSTANCE_POSITION];
+
+		const float* values[INSTANCE_NB_PARAMS];
+		for (size_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+		{
+			size_t nb = std::min(end - blockBegin,BLOCK_SIZE);
+			unsigned char* records = instances + blockBegin * stride;
+			const vec3* blockPositions = positions != NULL ? positions + blockBegin : NULL;
+
+			for (size_t i = 0; i < INSTANCE_NB_PARAMS; ++i)
+				values[i] = params[i].isEnabled() ? params[i].values + blockBegin : defaultValues[i];
+
+			if (indices != NULL)
+			{
+				const unsigned int* blockIndices = indices + blockBegin;
+				for (size_t i = 0; i < INSTANCE_NB_PARAMS; ++i)
+					if (params[i].isEnabled())
+					{
+						for (size_t j = 0; j < nb; ++j)
+							sortedValues[i][j] = params[i].values[blockIndices[j]];
+						values[i] = sortedValues[i];
+					}
+
+				if (positions != NULL)
+				{
+					for (size_t j = 0; j < nb; ++j)
+						sortedPositions[j] = positions[blockIndices[j]];
+					blockPositions = sortedPositions;
+				}
+			}
+
+			// Without positions, their slot is zeroed so that the records keep the layout given by getOffset and getStride
+			if (blockPositions == NULL)
+			{
+				for (size_t i = 0; i < nb; ++i)
+					std::memset(records + i * stride + offsets[INSTANCE_POSITION],0,positionSize);
+			}
+			else switch(formats[INSTANCE_POSITION])
+			{
+			case INSTANCE_FORMAT_FLOAT :
+				writeInstanceValues<12>(records + offsets[INSTANCE_POSITION],stride,blockPositions,nb);
+				break;
+
+			case INSTANCE_FORMAT_HALF :
+				for (size_t i = 0; i < nb; ++i)
+					relativePositions[i] = blockPositions[i] - origin;
+				convertToHalfFloats(halves,&relativePositions[0].x,nb * 3);
+				writeInstanceValues<6>(records + offsets[INSTANCE_POSITION],stride,halves,nb);
+				break;
+
+			default : break;
+			}
+
+			switch(formats[INSTANCE_COLOR])
+			{
+			case INSTANCE_FORMAT_FLOAT :
+				for (size_t i = 0; i < 4; ++i)
+					writeInstanceValues<4>(records + offsets[INSTANCE_COLOR] + i * sizeof(float),stride,values[i],nb);
+				break;
+
+			case INSTANCE_FORMAT_UNORM8 :
+				quantizeColors(colors,values,nb);
+				writeInstanceValues<4>(records + offsets[INSTANCE_COLOR],stride,colors,nb);
+				break;
+
+			default : break;
+			}
+
+			exportValues(records,INSTANCE_SIZE,values[4],nb);
+			exportValues(records,INSTANCE_ANGLE,values[5],nb);
+			exportValues(records,INSTANCE_TEXTURE_INDEX,values[6],nb);
+		}
+	}
+
+	void InstanceExporter::ExportJob::exportValues(unsigned char* records,InstanceAttribute attribute,const float* values,size_t nb) const
+	{
+		unsigned short shorts[BLOCK_SIZE];
+		unsigned char bytes[BLOCK_SIZE];
+		records += offsets[attribute];
+
+		switch(formats[attribute])
+		{
+		case INSTANCE_FORMAT_FLOAT :
+			writeInstanceValues<4>(records,stride,values,nb);
+			break;
+
+		case INSTANCE_FORMAT_HALF :
+			convertToHalfFloats(shorts,values,nb);
+			writeInstanceValues<2>(records,stride,shorts,nb);
+			break;
+
+		case INSTANCE_FORMAT_UNORM16 :
+			quantizeAngles(shorts,values,nb);
+			writeInstanceValues<2>(records,stride,shorts,nb);
+			break;
+
+		case INSTANCE_FORMAT_UINT8 :
+			quantizeIndices(bytes,values,nb);
+			writeInstanceValues<1>(records,stride,bytes,nb);
+			break;
+
+		default : break;
+		}
+	}
+}
@@ -0,0 +1,35 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "Extensions/Renderers/SPK_InstanceOutputSink.h"
+
+namespace SPK
+{
+	size_t InstanceOutputSink::writeOutput(const Group& group,void* memory,size_t size,size_t& nbBytes)
+	{
+		size_t stride = exporter.getStride();
+		size_t nbParticles = stride > 0 ? exporter.exportInstances(group,memory,size / stride) : 0;
+		nbBytes = nbParticles * stride;
+		return nbParticles;
+	}
+}
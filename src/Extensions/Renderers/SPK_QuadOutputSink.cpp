@@ -0,0 +1,34 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2009 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "Extensions/Renderers/SPK_QuadOutputSink.h"
+
+namespace SPK
+{
+	size_t QuadOutputSink::writeOutput(const Group& group,void* memory,size_t size,size_t& nbBytes)
+	{
+		size_t nbParticles = builder.buildQuads(group,*quadInterface,*orientationInterface,static_cast<QuadVertex*>(memory),size / sizeof(QuadVertex));
+		nbBytes = nbParticles * 4 * sizeof(QuadVertex);
+		return nbParticles;
+	}
+}
@@ -22,6 +22,8 @@
 
 #include "Extensions/Zones/SPK_AABox.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
+#include "Core/SPK_Kernel.h"
 
 namespace SPK
 {
@@ -38,14 +40,15 @@ namespace SPK
 
 	void AABox::generatePosition(Particle& particle,bool full) const
 	{
-		particle.position().x = getTransformedPosition().x + random(-dimension.x * 0.5f,dimension.x * 0.5f);
-		particle.position().y = getTransformedPosition().y + random(-dimension.y * 0.5f,dimension.y * 0.5f);
-		particle.position().z = getTransformedPosition().z + random(-dimension.z * 0.5f,dimension.z * 0.5f);
+		RandomGenerator& randomGenerator = particle.getRandomGenerator();
+		particle.position().x = getTransformedPosition().x + randomGenerator.random(-dimension.x * 0.5f,dimension.x * 0.5f);
+		particle.position().y = getTransformedPosition().y + randomGenerator.random(-dimension.y * 0.5f,dimension.y * 0.5f);
+		particle.position().z = getTransformedPosition().z + randomGenerator.random(-dimension.z * 0.5f,dimension.z * 0.5f);
 
 		if (!full)
 		{
-			int axis = random(0,3);
-			int sens = (random(0,2) << 1) - 1;
+			int axis = randomGenerator.random(0,3);
+			int sens = (randomGenerator.random(0,2) << 1) - 1;
 
 			switch(axis)
 			{
@@ -62,6 +65,28 @@ namespace SPK
 		}
 	}
 
+	void AABox::generatePositions(Group& group,size_t begin,size_t end,bool full) const
+	{
+		// The particles at the borders need a random face each
+		if (!full)
+		{
+			Zone::generatePositions(group,begin,end,full);
+			return;
+		}
+
+		RandomGenerator& randomGenerator = group.getRandomGenerator();
+		vec3* positions = group.getPositionArray();
+		float coords[3][BATCH_SIZE];
+		for (size_t i = begin; i < end; i += BATCH_SIZE)
+		{
+			size_t nb = std::min(end - i,BATCH_SIZE);
+			for (int axis = 0; axis < 3; ++axis)
+				randomGenerator.generate(coords[axis],nb,-dimension[axis] * 0.5f,dimension[axis] * 0.5f);
+			for (size_t j = 0; j < nb; ++j)
+				positions[i + j] = getTransformedPosition() + vec3(coords[0][j],coords[1][j],coords[2][j]);
+		}
+	}
+
 	bool AABox::contains(const vec3& v) const
 	{
 		if ((v.x >= getTransformedPosition().x - dimension.x * 0.5f)&&(v.x <= getTransformedPosition().x + dimension.x * 0.5f)
@@ -159,4 +184,21 @@ namespace SPK
 		normalizeOrRandomize(normal);
 		return normal;
 	}
+
+	void AABox::containsBatch(const vec3* points,size_t nb,unsigned char* results) const
+	{
+		testBoxContainment(points,nb,getTransformedPosition() - dimension * 0.5f,getTransformedPosition() + dimension * 0.5f,results);
+	}
+
+	void AABox::intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const
+	{
+		testBoxIntersection(starts,ends,nb,getTransformedPosition() - dimension * 0.5f,getTransformedPosition() + dimension * 0.5f,results);
+	}
+
+	bool AABox::getAABB(vec3& AABBMin,vec3& AABBMax) const
+	{
+		AABBMin = getTransformedPosition() - dimension * 0.5f;
+		AABBMax = getTransformedPosition() + dimension * 0.5f;
+		return true;
+	}
 }
@@ -23,6 +23,10 @@
 
 #include "Extensions/Zones/SPK_Cylinder.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
+#include "Core/SPK_Kernel.h"
+
+#include <cstring>
 
 namespace SPK
 {
@@ -59,29 +63,38 @@ namespace SPK
 
 	void Cylinder::generatePosition(Particle& particle,bool full) const
 	{
-	    float cRadius = full ? random(0.0f,radius) : radius,
-            cLength = full ? random(0.0f,length)-length*0.5f : length,
-            cAngle = random(0.0f,3.15f); // 3.15 > PI, but it has no importance here...
-
-	    // We need at least two points to compute a base
-	    vec3 rPoint = getTransformedPosition() + vec3(10.0f,10.0f,10.0f);
-	    float dist = dotProduct(tDirection,rPoint);
-	    while(dist == 0.0f || tDirection*dist +getTransformedPosition() == rPoint)
-	    {
-	        // avoid dist == 0, which leads to a div by zero.
-	        rPoint += vec3(10.0f,10.0f,random(-10.0f,10.0f));
-	        dist = dotProduct(tDirection,rPoint);
-	    }
-
-	    vec3 p1 = tDirection*dist +getTransformedPosition();
-	    dist = getDist(p1,rPoint);
-
-	    vec3 a = (rPoint - p1) / dist;
-//		vec3 tmp1 = tDirection, tmp2 = a; tmp2.crossProduct(tmp1*(-1));
-		vec3 tmp1 = tDirection, tmp2 = a; glm::cross(tmp2, tmp1*(-1));
-        vec3 b = tmp2;
+		RandomGenerator& randomGenerator = particle.getRandomGenerator();
+		vec3 u,v;
+		computeBasis(tDirection,u,v);
+
+		float angle = randomGenerator.random(0.0f,2.0f * PI);
+		float dist = full ? radius * std::sqrt(randomGenerator.random(0.0f,1.0f)) : radius; // to have a uniform distribution on the disk
+		float offset = randomGenerator.random(-length * 0.5f,length * 0.5f);
+		particle.position() = getTransformedPosition() + tDirection * offset + (u * std::cos(angle) + v * std::sin(angle)) * dist;
+	}
 
-        particle.position() = getTransformedPosition() + cLength * tDirection + a * cRadius * std::cos(cAngle) + b * cRadius * std::sin(cAngle);
+	void Cylinder::generatePositions(Group& group,size_t begin,size_t end,bool full) const
+	{
+		RandomGenerator& randomGenerator = group.getRandomGenerator();
+		vec3* positions = group.getPositionArray();
+		vec3 u,v;
+		computeBasis(tDirection,u,v);
+
+		float angles[BATCH_SIZE];
+		float sqrDists[BATCH_SIZE];
+		float offsets[BATCH_SIZE];
+		for (size_t i = begin; i < end; i += BATCH_SIZE)
+		{
+			size_t nb = std::min(end - i,BATCH_SIZE);
+			randomGenerator.generate(angles,nb,0.0f,2.0f * PI);
+			if (full)
+				randomGenerator.generate(sqrDists,nb,0.0f,1.0f);
+			else
+				std::fill(sqrDists,sqrDists + nb,1.0f);
+			randomGenerator.generate(offsets,nb,-length * 0.5f,length * 0.5f);
+			for (size_t j = 0; j < nb; ++j)
+				positions[i + j] = getTransformedPosition() + tDirection * offsets[j] + (u * std::cos(angles[j]) + v * std::sin(angles[j])) * (radius * std::sqrt(sqrDists[j]));
+		}
 	}
 
 	bool Cylinder::intersects(const vec3& v0,const vec3& v1,vec3* intersection,vec3* normal) const
@@ -179,4 +192,15 @@ namespace SPK
 //		tDirection.normalize();
 		tDirection = glm::normalize(tDirection);
 	}
+
+	void Cylinder::containsBatch(const vec3* points,size_t nb,unsigned char* results) const
+	{
+		testCylinderContainment(points,nb,getTransformedPosition(),tDirection,length,radius,results);
+	}
+
+	void Cylinder::intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const
+	{
+		// Like intersects, the lines are only tested when the intersection is requested
+		std::memset(results,0,nb);
+	}
 }
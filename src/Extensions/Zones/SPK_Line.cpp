@@ -22,6 +22,9 @@
 
 #include "Extensions/Zones/SPK_Line.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
+
+#include <cstring>
 
 namespace SPK
 {
@@ -58,10 +61,25 @@ namespace SPK
 
 	void Line::generatePosition(Particle& particle,bool full) const
 	{
-		float ratio = random(0.0f,1.0f);
+		RandomGenerator& randomGenerator = particle.getRandomGenerator();
+		float ratio = randomGenerator.random(0.0f,1.0f);
 		particle.position() = tBounds[0] + tDist * ratio;
 	}
 
+	void Line::generatePositions(Group& group,size_t begin,size_t end,bool full) const
+	{
+		RandomGenerator& randomGenerator = group.getRandomGenerator();
+		vec3* positions = group.getPositionArray();
+		float ratios[BATCH_SIZE];
+		for (size_t i = begin; i < end; i += BATCH_SIZE)
+		{
+			size_t nb = std::min(end - i,BATCH_SIZE);
+			randomGenerator.generate(ratios,nb,0.0f,1.0f);
+			for (size_t j = 0; j < nb; ++j)
+				positions[i + j] = tBounds[0] + tDist * ratios[j];
+		}
+	}
+
 	vec3 Line::computeNormal(const vec3& point) const
 	{
 		float d = -dotProduct(tDist,point);
@@ -90,4 +108,24 @@ namespace SPK
 		transformPos(tBounds[1],bounds[1]);
 		computeDist();
 	}
+
+	void Line::containsBatch(const vec3* points,size_t nb,unsigned char* results) const
+	{
+		std::memset(results,0,nb);
+	}
+
+	void Line::intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const
+	{
+		std::memset(results,0,nb);
+	}
+
+	bool Line::getAABB(vec3& AABBMin,vec3& AABBMax) const
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			AABBMin[i] = std::min(tBounds[0][i],tBounds[1][i]);
+			AABBMax[i] = std::max(tBounds[0][i],tBounds[1][i]);
+		}
+		return true;
+	}
 }
@@ -21,6 +21,7 @@
 
 
 #include "Extensions/Zones/SPK_Plane.h"
+#include "Core/SPK_Kernel.h"
 
 namespace SPK
 {
@@ -83,4 +84,23 @@ namespace SPK
 //		tNormal.normalize();
 		tNormal = glm::normalize(tNormal);
 	}
+
+	void Plane::containsBatch(const vec3* points,size_t nb,unsigned char* results) const
+	{
+		testHalfSpaceContainment(points,nb,getTransformedPosition(),normal,results);
+	}
+
+	void Plane::intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const
+	{
+		// A line intersects the plane when its ends are on both sides
+		unsigned char endResults[BATCH_SIZE];
+		for (size_t i = 0; i < nb; i += BATCH_SIZE)
+		{
+			size_t nbLines = std::min(nb - i,BATCH_SIZE);
+			testHalfSpaceContainment(starts + i,nbLines,getTransformedPosition(),tNormal,results + i);
+			testHalfSpaceContainment(ends + i,nbLines,getTransformedPosition(),tNormal,endResults);
+			for (size_t j = 0; j < nbLines; ++j)
+				results[i + j] ^= endResults[j];
+		}
+	}
 }
@@ -21,6 +21,9 @@
 
 
 #include "Extensions/Zones/SPK_Point.h"
+#include "Core/SPK_Group.h"
+
+#include <cstring>
 
 namespace SPK
 {
@@ -35,4 +38,26 @@ namespace SPK
 
 		return normal;
 	}
+
+	void Point::generatePositions(Group& group,size_t begin,size_t end,bool full) const
+	{
+		vec3* positions = group.getPositionArray();
+		std::fill(positions + begin,positions + end,getTransformedPosition());
+	}
+
+	void Point::containsBatch(const vec3* points,size_t nb,unsigned char* results) const
+	{
+		std::memset(results,0,nb);
+	}
+
+	void Point::intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const
+	{
+		std::memset(results,0,nb);
+	}
+
+	bool Point::getAABB(vec3& AABBMin,vec3& AABBMax) const
+	{
+		AABBMin = AABBMax = getTransformedPosition();
+		return true;
+	}
 }
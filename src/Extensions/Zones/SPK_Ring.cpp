@@ -21,6 +21,10 @@
 
 #include "Extensions/Zones/SPK_Ring.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
+#include "Core/SPK_Kernel.h"
+
+#include <cstring>
 
 namespace SPK
 {
@@ -44,16 +48,32 @@ namespace SPK
 
 	void Ring::generatePosition(Particle& particle,bool full) const
 	{
-		vec3 tmp;
-		do tmp = vec3(random(-1.0f,1.0f),random(-1.0f,1.0f),random(-1.0f,1.0f));
-//		while (tmp.getSqrNorm() > 1.0f);
-		while (glm::length2(tmp) > 1.0f);
+		RandomGenerator& randomGenerator = particle.getRandomGenerator();
+		vec3 u,v;
+		computeBasis(tNormal,u,v);
 
-		crossProduct(tNormal,tmp,particle.position());
-		normalizeOrRandomize(particle.position());
+		float angle = randomGenerator.random(0.0f,2.0f * PI);
+		float dist = std::sqrt(randomGenerator.random(sqrMinRadius,sqrMaxRadius)); // to have a uniform distribution
+		particle.position() = getTransformedPosition() + (u * std::cos(angle) + v * std::sin(angle)) * dist;
+	}
 
-		particle.position() *= std::sqrt(random(sqrMinRadius,sqrMaxRadius)); // to have a uniform distribution
-		particle.position() += getTransformedPosition();
+	void Ring::generatePositions(Group& group,size_t begin,size_t end,bool full) const
+	{
+		RandomGenerator& randomGenerator = group.getRandomGenerator();
+		vec3* positions = group.getPositionArray();
+		vec3 u,v;
+		computeBasis(tNormal,u,v);
+
+		float angles[BATCH_SIZE];
+		float sqrDists[BATCH_SIZE];
+		for (size_t i = begin; i < end; i += BATCH_SIZE)
+		{
+			size_t nb = std::min(end - i,BATCH_SIZE);
+			randomGenerator.generate(angles,nb,0.0f,2.0f * PI);
+			randomGenerator.generate(sqrDists,nb,sqrMinRadius,sqrMaxRadius);
+			for (size_t j = 0; j < nb; ++j)
+				positions[i + j] = getTransformedPosition() + (u * std::cos(angles[j]) + v * std::sin(angles[j])) * std::sqrt(sqrDists[j]);
+		}
 	}
 
 	bool Ring::intersects(const vec3& v0,const vec3& v1,vec3* intersection,vec3* normal) const
@@ -125,4 +145,38 @@ namespace SPK
 //		tNormal.normalize();
 		tNormal = glm::normalize(tNormal);
 	}
+
+	void Ring::containsBatch(const vec3* points,size_t nb,unsigned char* results) const
+	{
+		std::memset(results,0,nb);
+	}
+
+	void Ring::intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const
+	{
+		// Only the lines whose ends are on both sides of the plane of the ring can intersect it
+		unsigned char endResults[BATCH_SIZE];
+		for (size_t i = 0; i < nb; i += BATCH_SIZE)
+		{
+			size_t nbLines = std::min(nb - i,BATCH_SIZE);
+			testHalfSpaceContainment(starts + i,nbLines,getTransformedPosition(),tNormal,results + i);
+			testHalfSpaceContainment(ends + i,nbLines,getTransformedPosition(),tNormal,endResults);
+			for (size_t j = 0; j < nbLines; ++j)
+				if (results[i + j] != endResults[j])
+					results[i + j] = Ring::intersects(starts[i + j],ends[i + j],NULL,NULL) ? 1 : 0;
+				else
+					results[i + j] = 0;
+		}
+	}
+
+	bool Ring::getAABB(vec3& AABBMin,vec3& AABBMax) const
+	{
+		// The intersection is tested slightly before the plane, hence the approximation value added to the radius
+		vec3 extent;
+		for (int i = 0; i < 3; ++i)
+			extent[i] = (maxRadius + APPROXIMATION_VALUE) * std::sqrt(std::max(0.0f,1.0f - tNormal[i] * tNormal[i]));
+
+		AABBMin = getTransformedPosition() - extent;
+		AABBMax = getTransformedPosition() + extent;
+		return true;
+	}
 }
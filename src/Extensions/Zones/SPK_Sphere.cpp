@@ -22,6 +22,8 @@
 
 #include "Extensions/Zones/SPK_Sphere.h"
 #include "Core/SPK_Particle.h"
+#include "Core/SPK_Group.h"
+#include "Core/SPK_Kernel.h"
 
 namespace SPK
 {
@@ -33,15 +35,34 @@ namespace SPK
 
 	void Sphere::generatePosition(Particle& particle,bool full) const
 	{
-		do particle.position() = vec3(random(-radius,radius),random(-radius,radius),random(-radius,radius));
-//		while (particle.position().getSqrNorm() > radius * radius);
-		while (glm::length2(particle.position()) > radius * radius);
+		// A random direction scaled by the cube root of a uniform distance gives a uniform distribution in the volume
+		RandomGenerator& randomGenerator = particle.getRandomGenerator();
+		generateDirections(&particle.position(),1,randomGenerator);
+		float dist = full ? radius * std::pow(randomGenerator.random(0.0f,1.0f),1.0f / 3.0f) : radius;
+		particle.position() = particle.position() * dist + getTransformedPosition();
+	}
+
+	void Sphere::generatePositions(Group& group,size_t begin,size_t end,bool full) const
+	{
+		RandomGenerator& randomGenerator = group.getRandomGenerator();
+		vec3* positions = group.getPositionArray();
+		generateDirections(positions + begin,end - begin,randomGenerator);
 
-		if ((!full)&&(radius > 0.0f))
-//			particle.position() *= radius / particle.position().getNorm();
-			particle.position() *= radius / glm::length(particle.position());
+		if (!full)
+		{
+			for (size_t i = begin; i < end; ++i)
+				positions[i] = positions[i] * radius + getTransformedPosition();
+			return;
+		}
 
-		particle.position() += getTransformedPosition();
+		float dists[BATCH_SIZE];
+		for (size_t i = begin; i < end; i += BATCH_SIZE)
+		{
+			size_t nb = std::min(end - i,BATCH_SIZE);
+			randomGenerator.generate(dists,nb,0.0f,1.0f);
+			for (size_t j = 0; j < nb; ++j)
+				positions[i + j] = positions[i + j] * (radius * std::pow(dists[j],1.0f / 3.0f)) + getTransformedPosition();
+		}
 	}
 
 	bool Sphere::contains(const vec3& v) const
@@ -118,4 +139,30 @@ namespace SPK
 		normalizeOrRandomize(normal);
 		return normal;
 	}
+
+	void Sphere::containsBatch(const vec3* points,size_t nb,unsigned char* results) const
+	{
+		testSphereContainment(points,nb,getTransformedPosition(),radius,results);
+	}
+
+	void Sphere::intersectsBatch(const vec3* starts,const vec3* ends,size_t nb,unsigned char* results) const
+	{
+		// A line intersects the sphere when its ends are on both sides of the border
+		unsigned char endResults[BATCH_SIZE];
+		for (size_t i = 0; i < nb; i += BATCH_SIZE)
+		{
+			size_t nbLines = std::min(nb - i,BATCH_SIZE);
+			testSphereContainment(starts + i,nbLines,getTransformedPosition(),radius,results + i);
+			testSphereContainment(ends + i,nbLines,getTransformedPosition(),radius,endResults);
+			for (size_t j = 0; j < nbLines; ++j)
+				results[i + j] ^= endResults[j];
+		}
+	}
+
+	bool Sphere::getAABB(vec3& AABBMin,vec3& AABBMax) const
+	{
+		AABBMin = getTransformedPosition() - vec3(radius,radius,radius);
+		AABBMax = getTransformedPosition() + vec3(radius,radius,radius);
+		return true;
+	}
 }
@@ -39,7 +39,9 @@
 #include "Core/SPK_Registerable.cpp" // 1.03
 #include "Core/SPK_Transformable.cpp" // 1.03
 #include "Core/SPK_BufferHandler.cpp" // 1.04
+#include "Core/SPK_Buffer.cpp" // 1.06
 #include "Core/SPK_Renderer.cpp"
+#include "Core/SPK_RenderOutputSink.cpp" // 1.06
 #include "Core/SPK_System.cpp"
 #include "Core/SPK_Particle.cpp"
 #include "Core/SPK_Zone.cpp"
@@ -48,7 +50,11 @@
 #include "Core/SPK_Emitter.cpp"
 #include "Core/SPK_Modifier.cpp"
 #include "Core/SPK_Group.cpp"
+#include "Core/SPK_GroupSnapshot.cpp" // 1.06
 #include "Core/SPK_Factory.cpp" // 1.03
+#include "Core/SPK_Kernel.cpp" // 1.06
+#include "Core/SPK_ThreadPool.cpp" // 1.06
+#include "Core/SPK_RandomGenerator.cpp" // 1.06
 
 // Zones
 #include "Extensions/Zones/SPK_AABox.cpp"
@@ -77,3 +83,7 @@
 // Renderer Interfaces
 #include "Extensions/Renderers/SPK_QuadRendererInterface.cpp" // 1.04
 #include "Extensions/Renderers/SPK_Oriented3DRendererInterface.cpp" // 1.04
+#include "Extensions/Renderers/SPK_GeometryBuilder.cpp" // 1.06
+#include "Extensions/Renderers/SPK_InstanceExporter.cpp" // 1.06
+#include "Extensions/Renderers/SPK_InstanceOutputSink.cpp" // 1.06
+#include "Extensions/Renderers/SPK_QuadOutputSink.cpp" // 1.06